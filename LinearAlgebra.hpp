@@ -7,6 +7,13 @@
 #include "src/InverseMatrix.hpp"
 #include "src/JacobiMethod.hpp"
 #include "src/LUDecomposition.hpp"
+#include "src/Matrix3Batch.hpp"
+#include "src/SymmetricEigen3x3.hpp"
+#include "src/SymmetricEigen.hpp"
+#include "src/Lanczos.hpp"
+#include "src/SingularValueDecomposition.hpp"
+#include "src/QRDecomposition.hpp"
+#include "src/Superposition.hpp"
 #include "src/io.hpp"
 
 // reuquire Boost.math
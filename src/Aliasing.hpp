@@ -0,0 +1,72 @@
+#ifndef AX_ALIASING_H
+#define AX_ALIASING_H
+#include "OperandStorage.hpp"
+#include <memory>
+
+namespace ax
+{
+
+namespace detail
+{
+
+/* aliasing between an expression and the object it is assigned to.
+ *   references(expr, p)   : evaluating expr reads the concrete object at p.
+ *   alias_hazard(expr, p) : evaluating expr into the object at p element by
+ *                           element may read an element that is already
+ *                           overwritten.
+ * an element-wise node reads the same element it writes, so it only has a
+ * hazard through a child that does not (A = A + transpose(A)). a product,
+ * a transpose or a cross product has one whenever it references p.
+ * operands that are evaluated into a temporary never reference p.
+ * expression nodes implement both as member functions.                     */
+
+template<class T_expr, typename std::enable_if<
+    is_concrete_operand<T_expr>::value>::type*& = enabler>
+inline bool references(const T_expr& expr, const void* p)
+{
+    return static_cast<const void*>(std::addressof(expr)) == p;
+}
+
+template<class T_expr, typename std::enable_if<
+    !is_concrete_operand<T_expr>::value>::type*& = enabler>
+inline bool references(const T_expr& expr, const void* p)
+{
+    return expr.references(p);
+}
+
+template<class T_expr, typename std::enable_if<
+    is_concrete_operand<T_expr>::value>::type*& = enabler>
+constexpr inline bool alias_hazard(const T_expr&, const void*)
+{
+    return false;
+}
+
+template<class T_expr, typename std::enable_if<
+    !is_concrete_operand<T_expr>::value>::type*& = enabler>
+inline bool alias_hazard(const T_expr& expr, const void* p)
+{
+    return expr.alias_hazard(p);
+}
+
+// one buffer per type and thread, reused by every evaluation that has to
+// go out of place. its capacity is kept between calls.
+template<class T_obj>
+inline T_obj& scratch_buffer()
+{
+    static thread_local T_obj buffer;
+    return buffer;
+}
+
+// dst = expr where expr has an alias hazard on dst.
+template<class T_dst, class T_expr>
+inline T_dst& assign_aliased(T_dst& dst, const T_expr& expr)
+{
+    T_dst& tmp = scratch_buffer<T_dst>();
+    tmp = expr;
+    dst = tmp;
+    return dst;
+}
+
+}// detail
+}// ax
+#endif /* AX_ALIASING_H */
@@ -0,0 +1,84 @@
+#ifndef AX_ALIGNED_ALLOCATOR_H
+#define AX_ALIGNED_ALLOCATOR_H
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <limits>
+
+namespace ax
+{
+
+// default alignment of the buffers owned by dynamic vectors and matrices.
+// 64 byte is a cache line and is enough for any SIMD register width.
+constexpr static std::size_t AX_ALIGNMENT = 64;
+
+// minimal C++11 allocator that returns I_align-byte aligned memory.
+// the pointer returned by ::operator new is stored just before the block.
+template<typename T, std::size_t I_align = AX_ALIGNMENT>
+class aligned_allocator
+{
+  public:
+
+    static_assert((I_align & (I_align - 1)) == 0 && I_align >= sizeof(void*),
+                  "alignment must be a power of 2 and larger than a pointer");
+
+    using value_type      = T;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+    using reference       = T&;
+    using const_reference = const T&;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    template<typename U>
+    struct rebind{using other = aligned_allocator<U, I_align>;};
+
+    aligned_allocator() noexcept {}
+    aligned_allocator(const aligned_allocator&) noexcept {}
+    template<typename U>
+    aligned_allocator(const aligned_allocator<U, I_align>&) noexcept {}
+    ~aligned_allocator() = default;
+
+    pointer allocate(const size_type n)
+    {
+        if(n > std::numeric_limits<size_type>::max() / sizeof(T) - I_align)
+            throw std::bad_alloc();
+
+        void* const raw = ::operator new(n * sizeof(T) + I_align + sizeof(void*));
+        const std::uintptr_t head =
+            reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+        const std::uintptr_t aligned = (head + I_align - 1) & ~(I_align - 1);
+
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<pointer>(aligned);
+    }
+
+    void deallocate(pointer p, const size_type) noexcept
+    {
+        if(p == nullptr) return;
+        ::operator delete(reinterpret_cast<void**>(p)[-1]);
+        return;
+    }
+
+    size_type max_size() const noexcept
+    {
+        return (std::numeric_limits<size_type>::max() - I_align) / sizeof(T);
+    }
+};
+
+template<typename T, typename U, std::size_t I_align>
+inline bool operator==(const aligned_allocator<T, I_align>&,
+                       const aligned_allocator<U, I_align>&) noexcept
+{
+    return true;
+}
+
+template<typename T, typename U, std::size_t I_align>
+inline bool operator!=(const aligned_allocator<T, I_align>&,
+                       const aligned_allocator<U, I_align>&) noexcept
+{
+    return false;
+}
+
+}// ax
+#endif /* AX_ALIGNED_ALLOCATOR_H */
@@ -1,7 +1,9 @@
 #ifndef AX_DYNAMIC_MATRIX
 #define AX_DYNAMIC_MATRIX
 #include "Matrix.hpp"
+#include "AlignedAllocator.hpp"
 #include <vector>
+#include <algorithm>
 #include <stdexcept>
 
 namespace ax
@@ -14,6 +16,8 @@ namespace ax
   W (  ...       .   .   )
   s ( M_R0 ...      M_RC ) */
    
+// elements are stored in one contiguous, aligned row-major buffer. the
+// distance between the heads of two adjacent rows is stride().
 template <typename T_elem>
 class Matrix<T_elem, DYNAMIC, DYNAMIC>
 {
@@ -28,44 +32,80 @@ class Matrix<T_elem, DYNAMIC, DYNAMIC>
     using self_type = Matrix<elem_t, dim_row, dim_col>;
 
   public:
-    Matrix(){}
+    Matrix(): row_(0), col_(0){}
     ~Matrix() = default;
-    Matrix(const container_type& val): values_(val){}
-    Matrix(const self_type& mat): values_(mat.values_){}
-    Matrix(self_type&& mat): values_(std::move(mat.values_)){}
+    Matrix(const self_type& mat)
+        : row_(mat.row_), col_(mat.col_), values_(mat.values_)
+    {}
+    Matrix(self_type&& mat)
+        : row_(mat.row_), col_(mat.col_), values_(std::move(mat.values_))
+    {
+        mat.row_ = 0; mat.col_ = 0;
+    }
 
     Matrix(const std::size_t Row, const std::size_t Col)
-        : values_(Row, nest_container_type(Col, 0e0))
+        : row_(Row), col_(Col), values_(Row * Col, 0e0)
     {}
 
+    // val must be a row-major buffer that has Row * Col elements
+    Matrix(const std::size_t Row, const std::size_t Col,
+           const std::vector<elem_t>& val)
+        : row_(Row), col_(Col), values_(val.begin(), val.end())
+    {
+        if(values_.size() != row_ * col_)
+            throw std::invalid_argument("matrix size different");
+    }
+
+    Matrix(const container_type& val)
+        : row_(val.size()), col_(val.empty() ? 0 : val.front().size()),
+          values_(row_ * col_)
+    {
+        for(std::size_t i=0; i<row_; ++i)
+        {
+            if(val[i].size() != col_)
+                throw std::invalid_argument("matrix size different");
+            std::copy(val[i].begin(), val[i].end(), values_.begin() + i * col_);
+        }
+    }
+
     template<class T_expr, typename std::enable_if<
         is_matrix_expression<typename T_expr::tag>::value&&
         std::is_same<elem_t, typename T_expr::elem_t>::value>::type*& = enabler>
     Matrix(const T_expr& expr)
-        : values_(dimension_row(expr),
-                  nest_container_type(dimension_col(expr), 0e0))
+        : row_(dimension_row(expr)), col_(dimension_col(expr)),
+          values_(row_ * col_)
     {
-        for(auto i=0; i<dimension_row(expr); ++i)
-            for(auto j=0; j<dimension_col(expr); ++j)
-                this->values_[i][j] = expr(i, j);
+        detail::assign_matrix(*this, expr);
     }
 
     // operator = 
     self_type& operator=(const self_type& mat)
     {
+        this->row_    = mat.row_;
+        this->col_    = mat.col_;
         this->values_ = mat.values_;
         return *this;
     }
 
+    self_type& operator=(self_type&& mat)
+    {
+        this->row_    = mat.row_;
+        this->col_    = mat.col_;
+        this->values_ = std::move(mat.values_);
+        mat.row_ = 0; mat.col_ = 0;
+        return *this;
+    }
+
     template<class T_expr, typename std::enable_if<
         is_matrix_expression<typename T_expr::tag>::value&&
         std::is_same<elem_t, typename T_expr::elem_t>::value
         >::type*& = enabler>
     self_type& operator=(const T_expr& expr)
     {
-        for(std::size_t i = 0; i<dimension_row(expr); ++i)
-            for(std::size_t j=0; j<dimension_col(expr); ++j)
-                this->values_.at(i).at(j) = expr(i, j);
+        if(detail::alias_hazard(expr, this))
+            return detail::assign_aliased(*this, expr);
+        this->resize(dimension_row(expr), dimension_col(expr));
+        detail::assign_matrix(*this, expr);
         return *this;
     }
 
@@ -75,7 +115,11 @@ class Matrix<T_elem, DYNAMIC, DYNAMIC>
         >::type*& = enabler>
     self_type& operator+=(const T_expr& expr)
     {
-        return *this = (*this + expr);
+        if(dimension_row(expr) != this->size_row() ||
+           dimension_col(expr) != this->size_col())
+            throw std::invalid_argument("matrix size different");
+        detail::update_matrix<detail::Add_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     template<class T_expr, typename std::enable_if<
@@ -84,55 +128,93 @@ class Matrix<T_elem, DYNAMIC, DYNAMIC>
         >::type*& = enabler>
     self_type& operator-=(const T_expr& expr)
     {
-        return *this = (*this - expr);
+        if(dimension_row(expr) != this->size_row() ||
+           dimension_col(expr) != this->size_col())
+            throw std::invalid_argument("matrix size different");
+        detail::update_matrix<detail::Subtract_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     self_type& operator*=(const elem_t& scl)
     {
-        return *this = (*this * scl);
+        detail::update_matrix_scalar<detail::Multiply_Operator<elem_t, elem_t>>(*this, scl);
+        return *this;
     }
 
     self_type& operator/=(const elem_t& scl)
     {
-        return *this = (*this / scl);
+        detail::update_matrix_scalar<detail::Divide_Operator<elem_t, elem_t>>(*this, scl);
+        return *this;
     }
 
     elem_t const& operator()(const std::size_t i, const std::size_t j) const
     {
 #ifdef AX_PARANOIAC
-        return values_.at(i).at(j);
+        return this->at(i, j);
 #else
-        return values_[i][j];
+        return values_[i * col_ + j];
 #endif
     }
 
     elem_t& operator()(const std::size_t i, const std::size_t j)
     {
 #ifdef AX_PARANOIAC
-        return values_.at(i).at(j);
+        return this->at(i, j);
 #else
-        return values_[i][j];
+        return values_[i * col_ + j];
 #endif
     }
 
     elem_t const& at(const std::size_t i, const std::size_t j) const
     {
-        return values_.at(i).at(j);
+        if(i >= row_ || j >= col_)
+            throw std::out_of_range("ax::Matrix::at: index out of range");
+        return values_[i * col_ + j];
     }
 
     elem_t& at(const std::size_t i, const std::size_t j)
     {
-        return values_.at(i).at(j);
+        if(i >= row_ || j >= col_)
+            throw std::out_of_range("ax::Matrix::at: index out of range");
+        return values_[i * col_ + j];
+    }
+
+    // contents are not preserved if the shape changes
+    void resize(const std::size_t Row, const std::size_t Col)
+    {
+        if(Row == row_ && Col == col_) return;
+        row_ = Row;
+        col_ = Col;
+        values_.assign(Row * Col, 0e0);
+        return;
     }
 
-    std::size_t size_row() const {return values_.size();}
-    std::size_t size_col() const {return values_.front().size();}
+    std::size_t size_row() const {return row_;}
+    std::size_t size_col() const {return col_;}
+
+    // leading dimension: (i, j) is at data()[i * stride() + j]
+    std::size_t stride() const {return col_;}
+
+    elem_t const* data() const {return values_.data();}
+    elem_t*       data()       {return values_.data();}
+
+    // row-major elements i, i+1, ... as one SIMD packet
+    constexpr static bool packet_access = true;
+    typename detail::packet_traits<elem_t>::type packet(const std::size_t i) const
+    {
+        return detail::packet_traits<elem_t>::load(this->data() + i);
+    }
 
   private:
 
-    container_type values_;
+    using storage_type = std::vector<elem_t, aligned_allocator<elem_t>>;
+
+    std::size_t row_;
+    std::size_t col_;
+    storage_type values_;
 };
 
+// row-major, the length of each row is I_col. stride() == I_col.
 template <typename T_elem, dimension_type I_col>
 class Matrix<T_elem, DYNAMIC, I_col>
 {
@@ -146,47 +228,74 @@ class Matrix<T_elem, DYNAMIC, I_col>
     using nest_container_type = std::array<elem_t, dim_col>;
     using container_type = std::vector<nest_container_type>;
     using self_type = Matrix<elem_t, dim_row, dim_col>;
-    // {{col_vec},
-    //  {col_vec},
-    //  ... }
 
   public:
-    Matrix(){}
+    Matrix(): row_(0){}
     ~Matrix() = default;
 
-    Matrix(const std::size_t row): values_(row, nest_container_type{{}}){}
-    Matrix(const container_type& val): values_(val){}
-    Matrix(const self_type& mat): values_(mat.values_){}
-    Matrix(self_type&& mat): values_(std::move(mat.values_)){}
+    Matrix(const std::size_t row): row_(row), values_(row * dim_col, 0e0){}
+    Matrix(const self_type& mat): row_(mat.row_), values_(mat.values_){}
+    Matrix(self_type&& mat): row_(mat.row_), values_(std::move(mat.values_))
+    {
+        mat.row_ = 0;
+    }
+
+    // val must be a row-major buffer that has row * I_col elements
+    Matrix(const std::size_t row, const std::vector<elem_t>& val)
+        : row_(row), values_(val.begin(), val.end())
+    {
+        if(values_.size() != row_ * dim_col)
+            throw std::invalid_argument("matrix size different");
+    }
+
+    Matrix(const container_type& val)
+        : row_(val.size()), values_(row_ * dim_col)
+    {
+        for(std::size_t i=0; i<row_; ++i)
+            std::copy(val[i].begin(), val[i].end(), values_.begin() + i * dim_col);
+    }
 
     template<class T_expr, typename std::enable_if<
         is_matrix_expression<typename T_expr::tag>::value&&
         std::is_same<elem_t, typename T_expr::elem_t>::value>::type*& = enabler>
     Matrix(const T_expr& expr)
-        : values_(dimension_row(expr),
-                  nest_container_type(dimension_col(expr), 0e0))
+        : row_(dimension_row(expr)), values_(row_ * dim_col)
     {
-        for(std::size_t i=0; i<dimension_row(expr); ++i)
-            for(std::size_t j=0; j<dimension_col(expr); ++j)
-                (*this)(i, j) = expr(i, j);
+        if(dimension_col(expr) != dim_col)
+            throw std::invalid_argument("matrix size different");
+
+        detail::assign_matrix(*this, expr);
     }
 
     // operator = 
     self_type& operator=(const self_type& mat)
     {
+        this->row_    = mat.row_;
         this->values_ = mat.values_;
         return *this;
     }
 
+    self_type& operator=(self_type&& mat)
+    {
+        this->row_    = mat.row_;
+        this->values_ = std::move(mat.values_);
+        mat.row_ = 0;
+        return *this;
+    }
+
     template<class T_expr, typename std::enable_if<
         is_matrix_expression<typename T_expr::tag>::value&&
         std::is_same<elem_t, typename T_expr::elem_t>::value
         >::type*& = enabler>
     self_type& operator=(const T_expr& expr)
     {
-        for(std::size_t i = 0; i<dimension_row(expr); ++i)
-            for(std::size_t j=0; j<dimension_col(expr); ++j)
-                this->values_[i][j] = expr(i, j);
+        if(detail::alias_hazard(expr, this))
+            return detail::assign_aliased(*this, expr);
+        if(dimension_col(expr) != dim_col)
+            throw std::invalid_argument("matrix size different");
+
+        this->resize(dimension_row(expr));
+        detail::assign_matrix(*this, expr);
         return *this;
     }
 
@@ -196,7 +305,11 @@ class Matrix<T_elem, DYNAMIC, I_col>
         >::type*& = enabler>
     self_type& operator+=(const T_expr& expr)
     {
-        return *this = (*this + expr);
+        if(dimension_row(expr) != this->size_row() ||
+           dimension_col(expr) != this->size_col())
+            throw std::invalid_argument("matrix size different");
+        detail::update_matrix<detail::Add_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     template<class T_expr, typename std::enable_if<
@@ -205,55 +318,92 @@ class Matrix<T_elem, DYNAMIC, I_col>
         >::type*& = enabler>
     self_type& operator-=(const T_expr& expr)
     {
-        return *this = (*this - expr);
+        if(dimension_row(expr) != this->size_row() ||
+           dimension_col(expr) != this->size_col())
+            throw std::invalid_argument("matrix size different");
+        detail::update_matrix<detail::Subtract_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     self_type& operator*=(const elem_t& scl)
     {
-        return *this = (*this * scl);
+        detail::update_matrix_scalar<detail::Multiply_Operator<elem_t, elem_t>>(*this, scl);
+        return *this;
     }
 
     self_type& operator/=(const elem_t& scl)
     {
-        return *this = (*this / scl);
+        detail::update_matrix_scalar<detail::Divide_Operator<elem_t, elem_t>>(*this, scl);
+        return *this;
     }
 
     elem_t const& operator()(const std::size_t i, const std::size_t j) const
     {
 #ifdef AX_PARANOIAC
-        return values_.at(i).at(j);
+        return this->at(i, j);
 #else
-        return values_[i][j];
+        return values_[i * dim_col + j];
 #endif
     }
 
     elem_t& operator()(const std::size_t i, const std::size_t j)
     {
 #ifdef AX_PARANOIAC
-        return values_.at(i).at(j);
+        return this->at(i, j);
 #else
-        return values_[i][j];
+        return values_[i * dim_col + j];
 #endif
     }
 
     elem_t const& at(const std::size_t i, const std::size_t j) const
     {
-        return values_.at(i).at(j);
+        if(i >= row_ || j >= dim_col)
+            throw std::out_of_range("ax::Matrix::at: index out of range");
+        return values_[i * dim_col + j];
     }
 
     elem_t& at(const std::size_t i, const std::size_t j)
     {
-        return values_.at(i).at(j);
+        if(i >= row_ || j >= dim_col)
+            throw std::out_of_range("ax::Matrix::at: index out of range");
+        return values_[i * dim_col + j];
+    }
+
+    // contents are not preserved if the shape changes
+    void resize(const std::size_t row)
+    {
+        if(row == row_) return;
+        row_ = row;
+        values_.assign(row * dim_col, 0e0);
+        return;
     }
 
-    std::size_t size_row() const {return values_.size();}
-    std::size_t size_col() const {return values_.front().size();}
+    std::size_t size_row() const {return row_;}
+    std::size_t size_col() const {return dim_col;}
+
+    // leading dimension: (i, j) is at data()[i * stride() + j]
+    std::size_t stride() const {return dim_col;}
+
+    elem_t const* data() const {return values_.data();}
+    elem_t*       data()       {return values_.data();}
+
+    // row-major elements i, i+1, ... as one SIMD packet
+    constexpr static bool packet_access = true;
+    typename detail::packet_traits<elem_t>::type packet(const std::size_t i) const
+    {
+        return detail::packet_traits<elem_t>::load(this->data() + i);
+    }
 
   private:
 
-    container_type values_;
+    using storage_type = std::vector<elem_t, aligned_allocator<elem_t>>;
+
+    std::size_t row_;
+    storage_type values_;
 };
 
+// row-major, each of the I_row rows is a contiguous block of size_col()
+// elements and the rows follow each other. stride() == size_col().
 template <typename T_elem, dimension_type I_row>
 class Matrix<T_elem, I_row, DYNAMIC>
 {
@@ -268,47 +418,77 @@ class Matrix<T_elem, I_row, DYNAMIC>
     using self_type = Matrix<elem_t, dim_row, dim_col>;
 
   public:
-    Matrix(){}
+    Matrix(): col_(0){}
     ~Matrix() = default;
 
-    Matrix(const std::size_t col)
+    Matrix(const std::size_t col): col_(col), values_(dim_row * col, 0e0){}
+    Matrix(const self_type& mat): col_(mat.col_), values_(mat.values_){}
+    Matrix(self_type&& mat): col_(mat.col_), values_(std::move(mat.values_))
     {
-        for(std::size_t i=0; i<dim_row; ++i)
-            values_[i] = nest_container_type(col, 0);
+        mat.col_ = 0;
+    }
+
+    // val must be a row-major buffer that has I_row * col elements
+    Matrix(const std::size_t col, const std::vector<elem_t>& val)
+        : col_(col), values_(val.begin(), val.end())
+    {
+        if(values_.size() != dim_row * col_)
+            throw std::invalid_argument("matrix size different");
     }
 
-    Matrix(const container_type& val): values_(val){}
-    Matrix(const self_type& mat): values_(mat.values_){}
-    Matrix(self_type&& mat): values_(std::move(mat.values_)){}
+    Matrix(const container_type& val)
+        : col_(val.front().size()), values_(dim_row * col_)
+    {
+        for(std::size_t i=0; i<dim_row; ++i)
+        {
+            if(val[i].size() != col_)
+                throw std::invalid_argument("matrix size different");
+            std::copy(val[i].begin(), val[i].end(), values_.begin() + i * col_);
+        }
+    }
 
     template<class T_expr, typename std::enable_if<
         is_matrix_expression<typename T_expr::tag>::value&&
         std::is_same<elem_t, typename T_expr::elem_t>::value
         >::type*& = enabler>
     Matrix(const T_expr& expr)
-        : values_(dimension_row(expr), nest_container_type(dimension_col(expr), 0e0))
+        : col_(dimension_col(expr)), values_(dim_row * col_)
     {
-        for(std::size_t i=0; i<dimension_row(expr); ++i)
-            for(std::size_t j=0; j<dimension_col(expr); ++j)
-                this->values_[i][j] = expr(i, j);
+        if(dimension_row(expr) != dim_row)
+            throw std::invalid_argument("matrix size different");
+
+        detail::assign_matrix(*this, expr);
     }
 
     // operator = 
     self_type& operator=(const self_type& mat)
     {
+        this->col_    = mat.col_;
         this->values_ = mat.values_;
         return *this;
     }
 
+    self_type& operator=(self_type&& mat)
+    {
+        this->col_    = mat.col_;
+        this->values_ = std::move(mat.values_);
+        mat.col_ = 0;
+        return *this;
+    }
+
     template<class T_expr, typename std::enable_if<
         is_matrix_expression<typename T_expr::tag>::value&&
         std::is_same<elem_t, typename T_expr::elem_t>::value
         >::type*& = enabler>
     self_type& operator=(const T_expr& expr)
     {
-        for(std::size_t i = 0; i<dimension_row(expr); ++i)
-            for(std::size_t j=0; j<dimension_col(expr); ++j)
-                this->values_[i][j] = expr(i, j);
+        if(detail::alias_hazard(expr, this))
+            return detail::assign_aliased(*this, expr);
+        if(dimension_row(expr) != dim_row)
+            throw std::invalid_argument("matrix size different");
+
+        this->resize(dimension_col(expr));
+        detail::assign_matrix(*this, expr);
         return *this;
     }
 
@@ -318,7 +498,11 @@ class Matrix<T_elem, I_row, DYNAMIC>
         >::type*& = enabler>
     self_type& operator+=(const T_expr& expr)
     {
-        return *this = (*this + expr);
+        if(dimension_row(expr) != this->size_row() ||
+           dimension_col(expr) != this->size_col())
+            throw std::invalid_argument("matrix size different");
+        detail::update_matrix<detail::Add_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     template<class T_expr, typename std::enable_if<
@@ -327,53 +511,88 @@ class Matrix<T_elem, I_row, DYNAMIC>
         >::type*& = enabler>
     self_type& operator-=(const T_expr& expr)
     {
-        return *this = (*this - expr);
+        if(dimension_row(expr) != this->size_row() ||
+           dimension_col(expr) != this->size_col())
+            throw std::invalid_argument("matrix size different");
+        detail::update_matrix<detail::Subtract_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     self_type& operator*=(const elem_t& scl)
     {
-        return *this = (*this * scl);
+        detail::update_matrix_scalar<detail::Multiply_Operator<elem_t, elem_t>>(*this, scl);
+        return *this;
     }
 
     self_type& operator/=(const elem_t& scl)
     {
-        return *this = (*this / scl);
+        detail::update_matrix_scalar<detail::Divide_Operator<elem_t, elem_t>>(*this, scl);
+        return *this;
     }
 
     elem_t const& operator()(const std::size_t i, const std::size_t j) const
     {
 #ifdef AX_PARANOIAC
-        return values_.at(i).at(j);
+        return this->at(i, j);
 #else
-        return values_[i][j];
+        return values_[i * col_ + j];
 #endif
     }
 
     elem_t& operator()(const std::size_t i, const std::size_t j)
     {
 #ifdef AX_PARANOIAC
-        return values_.at(i).at(j);
+        return this->at(i, j);
 #else
-        return values_[i][j];
+        return values_[i * col_ + j];
 #endif
     }
 
     elem_t const& at(const std::size_t i, const std::size_t j) const
     {
-        return values_.at(i).at(j);
+        if(i >= dim_row || j >= col_)
+            throw std::out_of_range("ax::Matrix::at: index out of range");
+        return values_[i * col_ + j];
     }
 
     elem_t& at(const std::size_t i, const std::size_t j)
     {
-        return values_.at(i).at(j);
+        if(i >= dim_row || j >= col_)
+            throw std::out_of_range("ax::Matrix::at: index out of range");
+        return values_[i * col_ + j];
     }
 
-    std::size_t size_row() const {return values_.size();}
-    std::size_t size_col() const {return values_.front().size();}
+    // contents are not preserved if the shape changes
+    void resize(const std::size_t col)
+    {
+        if(col == col_) return;
+        col_ = col;
+        values_.assign(dim_row * col, 0e0);
+        return;
+    }
+
+    std::size_t size_row() const {return dim_row;}
+    std::size_t size_col() const {return col_;}
+
+    // leading dimension: (i, j) is at data()[i * stride() + j]
+    std::size_t stride() const {return col_;}
+
+    elem_t const* data() const {return values_.data();}
+    elem_t*       data()       {return values_.data();}
+
+    // row-major elements i, i+1, ... as one SIMD packet
+    constexpr static bool packet_access = true;
+    typename detail::packet_traits<elem_t>::type packet(const std::size_t i) const
+    {
+        return detail::packet_traits<elem_t>::load(this->data() + i);
+    }
 
   private:
 
-    container_type values_;
+    using storage_type = std::vector<elem_t, aligned_allocator<elem_t>>;
+
+    std::size_t col_;
+    storage_type values_;
 };
 
 
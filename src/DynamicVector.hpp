@@ -50,7 +50,7 @@ class Vector<T_elem, DYNAMIC>
                 is_dynamic_dimension<T_expr::dim>::value>::type*& = enabler>
     Vector(const T_expr& expr) : values_(dimension(expr))
     {
-        for(std::size_t i=0; i<dimension(expr); ++i) this->values_[i] = expr[i];
+        detail::assign_vector(*this, expr);
     }
 
     // from static Vector
@@ -59,7 +59,7 @@ class Vector<T_elem, DYNAMIC>
                 is_static_dimension<T_expr::dim>::value>::type*& = enabler>
     Vector(const T_expr& expr) : values_(T_expr::dim)
     {
-        for(std::size_t i=0; i<T_expr::dim; ++i) this->values_[i] = expr[i];
+        detail::assign_vector(*this, expr);
     }
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ operator = ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -89,8 +89,10 @@ class Vector<T_elem, DYNAMIC>
                 is_dynamic_dimension<T_expr::dim>::value>::type*& = enabler>
     Vector<elem_t, dim>& operator=(const T_expr& expr)
     {
+        if(detail::alias_hazard(expr, this))
+            return detail::assign_aliased(*this, expr);
         this->values_.resize(dimension(expr), 0e0);
-        for(std::size_t i=0; i<dimension(expr); ++i) this->values_[i] = expr[i];
+        detail::assign_vector(*this, expr);
         return *this;
     }
 
@@ -100,8 +102,10 @@ class Vector<T_elem, DYNAMIC>
                 is_static_dimension<T_expr::dim>::value>::type*& = enabler>
     Vector<elem_t, dim>& operator=(const T_expr& expr)
     {
+        if(detail::alias_hazard(expr, this))
+            return detail::assign_aliased(*this, expr);
         this->values_.resize(T_expr::dim, 0e0);
-        for(std::size_t i=0; i<T_expr::dim; ++i) this->values_[i] = expr[i];
+        detail::assign_vector(*this, expr);
         return *this;
     }
 
@@ -115,7 +119,8 @@ class Vector<T_elem, DYNAMIC>
     {
         if(this->size() != dimension(expr))
             throw std::invalid_argument("add different size vector");
-        return *this = (*this + expr);
+        detail::update_vector<detail::Add_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     } 
 
     // for dynamic += static
@@ -127,7 +132,8 @@ class Vector<T_elem, DYNAMIC>
     {
         if(this->size() != T_expr::dim)
             throw std::invalid_argument("add different size vector");
-        return *this = (*this + expr);
+        detail::update_vector<detail::Add_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ operator -= ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -140,7 +146,8 @@ class Vector<T_elem, DYNAMIC>
     {
         if(this->size() != dimension(expr))
             throw std::invalid_argument("add different size vector");
-        return *this = (*this - expr);
+        detail::update_vector<detail::Subtract_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     // for dynamic -= static
@@ -152,16 +159,21 @@ class Vector<T_elem, DYNAMIC>
     {
         if(this->size() != T_expr::dim)
             throw std::invalid_argument("add different size vector");
-        return *this = (*this - expr);
+        detail::update_vector<detail::Subtract_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     Vector<elem_t, dim>& operator*=(const elem_t& scl)
     {
-        return *this = (*this * scl);
+        detail::update_linear<detail::Multiply_Operator<elem_t, elem_t>>(
+                this->data(), this->size(), scl);
+        return *this;
     }
     Vector<elem_t, dim>& operator/=(const elem_t& scl)
     {
-        return *this = (*this / scl);
+        detail::update_linear<detail::Divide_Operator<elem_t, elem_t>>(
+                this->data(), this->size(), scl);
+        return *this;
     }
 
     void append(const elem_t& e)
@@ -180,6 +192,16 @@ class Vector<T_elem, DYNAMIC>
 
     std::size_t size() const {return values_.size();}
 
+    elem_t const* data() const {return values_.data();}
+    elem_t*       data()       {return values_.data();}
+
+    // elements i, i+1, ... as one SIMD packet
+    constexpr static bool packet_access = true;
+    typename detail::packet_traits<elem_t>::type packet(const std::size_t i) const
+    {
+        return detail::packet_traits<elem_t>::load(values_.data() + i);
+    }
+
   private:
 
     std::vector<elem_t> values_;
@@ -0,0 +1,372 @@
+#ifndef AX_GEMM_H
+#define AX_GEMM_H
+#include "AlignedAllocator.hpp"
+#include "ThreadPool.hpp"
+#include "Packet.hpp"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+// products whose m * n * k is smaller than this are evaluated element by
+// element; the packing overhead does not pay off for them.
+#ifndef AX_GEMM_THRESHOLD
+#define AX_GEMM_THRESHOLD 32768
+#endif
+
+namespace ax
+{
+
+namespace detail
+{
+
+/* blocking parameters of the GEMM engine.
+ *  MR x NR : size of the register tile computed by micro_kernel
+ *  MC x KC : block of lhs packed once and kept in L2
+ *  KC x NC : block of rhs packed once and kept in L3
+ *  KC x NR : panel of rhs streamed from L1 by the micro kernel        */
+template<typename T_elem>
+struct gemm_traits
+{
+    constexpr static std::size_t MR = 4;
+    constexpr static std::size_t NR = 4;
+    constexpr static std::size_t MC = 64;
+    constexpr static std::size_t KC = 256;
+    constexpr static std::size_t NC = 2048;
+
+    // ab[MR * NR] = a[kc * MR] * b[kc * NR], both packed
+    static void micro_kernel(const std::size_t kc,
+            const T_elem* a, const T_elem* b, T_elem* ab)
+    {
+        for(std::size_t i=0; i<MR * NR; ++i) ab[i] = T_elem(0);
+
+        for(std::size_t p=0; p<kc; ++p, a += MR, b += NR)
+            for(std::size_t i=0; i<MR; ++i)
+                for(std::size_t j=0; j<NR; ++j)
+                    ab[i * NR + j] += a[i] * b[j];
+        return;
+    }
+};
+
+#ifdef __AVX__
+template<>
+struct gemm_traits<double>
+{
+    constexpr static std::size_t MR = 4;
+    constexpr static std::size_t NR = 8;
+    constexpr static std::size_t MC = 96;
+    constexpr static std::size_t KC = 256;
+    constexpr static std::size_t NC = 2048;
+
+    // 4 x 8 tile held in 8 ymm registers. b must be 32 byte aligned.
+    static void micro_kernel(const std::size_t kc,
+            const double* a, const double* b, double* ab)
+    {
+        __m256d c00 = _mm256_setzero_pd(); __m256d c01 = _mm256_setzero_pd();
+        __m256d c10 = _mm256_setzero_pd(); __m256d c11 = _mm256_setzero_pd();
+        __m256d c20 = _mm256_setzero_pd(); __m256d c21 = _mm256_setzero_pd();
+        __m256d c30 = _mm256_setzero_pd(); __m256d c31 = _mm256_setzero_pd();
+
+        for(std::size_t p=0; p<kc; ++p, a += MR, b += NR)
+        {
+            const __m256d b0 = _mm256_load_pd(b);
+            const __m256d b1 = _mm256_load_pd(b + 4);
+
+            __m256d ai = _mm256_broadcast_sd(a);
+            c00 = _mm256_add_pd(c00, _mm256_mul_pd(ai, b0));
+            c01 = _mm256_add_pd(c01, _mm256_mul_pd(ai, b1));
+            ai = _mm256_broadcast_sd(a + 1);
+            c10 = _mm256_add_pd(c10, _mm256_mul_pd(ai, b0));
+            c11 = _mm256_add_pd(c11, _mm256_mul_pd(ai, b1));
+            ai = _mm256_broadcast_sd(a + 2);
+            c20 = _mm256_add_pd(c20, _mm256_mul_pd(ai, b0));
+            c21 = _mm256_add_pd(c21, _mm256_mul_pd(ai, b1));
+            ai = _mm256_broadcast_sd(a + 3);
+            c30 = _mm256_add_pd(c30, _mm256_mul_pd(ai, b0));
+            c31 = _mm256_add_pd(c31, _mm256_mul_pd(ai, b1));
+        }
+        _mm256_storeu_pd(ab,      c00); _mm256_storeu_pd(ab +  4, c01);
+        _mm256_storeu_pd(ab +  8, c10); _mm256_storeu_pd(ab + 12, c11);
+        _mm256_storeu_pd(ab + 16, c20); _mm256_storeu_pd(ab + 20, c21);
+        _mm256_storeu_pd(ab + 24, c30); _mm256_storeu_pd(ab + 28, c31);
+        return;
+    }
+};
+#endif // __AVX__
+
+template<typename T_elem>
+using gemm_buffer = std::vector<T_elem, aligned_allocator<T_elem>>;
+
+// packing buffers are kept per thread and reused between calls
+template<typename T_elem>
+inline std::pair<gemm_buffer<T_elem>, gemm_buffer<T_elem>>& gemm_workspace()
+{
+    static thread_local std::pair<gemm_buffer<T_elem>, gemm_buffer<T_elem>> ws;
+    return ws;
+}
+
+// pack mc x kc block of A (element (i, p) at a[i * rs + p * cs]) into
+// row panels of height MR. rows beyond mc are padded with zero.
+template<typename T_elem>
+void gemm_pack_lhs(const std::size_t mc, const std::size_t kc,
+        const T_elem* a, const std::size_t rs, const std::size_t cs,
+        T_elem* packed)
+{
+    constexpr std::size_t MR = gemm_traits<T_elem>::MR;
+    for(std::size_t ir=0; ir<mc; ir += MR)
+    {
+        const std::size_t mr = std::min(MR, mc - ir);
+        for(std::size_t p=0; p<kc; ++p)
+        {
+            for(std::size_t i=0; i<mr; ++i)
+                packed[i] = a[(ir + i) * rs + p * cs];
+            for(std::size_t i=mr; i<MR; ++i)
+                packed[i] = T_elem(0);
+            packed += MR;
+        }
+    }
+    return;
+}
+
+// pack kc x nc block of B (element (p, j) at b[p * rs + j * cs]) into
+// column panels of width NR. columns beyond nc are padded with zero.
+template<typename T_elem>
+void gemm_pack_rhs(const std::size_t kc, const std::size_t nc,
+        const T_elem* b, const std::size_t rs, const std::size_t cs,
+        T_elem* packed)
+{
+    constexpr std::size_t NR = gemm_traits<T_elem>::NR;
+    for(std::size_t jr=0; jr<nc; jr += NR)
+    {
+        const std::size_t nr = std::min(NR, nc - jr);
+        for(std::size_t p=0; p<kc; ++p)
+        {
+            for(std::size_t j=0; j<nr; ++j)
+                packed[j] = b[p * rs + (jr + j) * cs];
+            for(std::size_t j=nr; j<NR; ++j)
+                packed[j] = T_elem(0);
+            packed += NR;
+        }
+    }
+    return;
+}
+
+// C[mc x nc] += alpha * packed_A * packed_B
+template<typename T_elem>
+void gemm_macro_kernel(const std::size_t mc, const std::size_t nc,
+        const std::size_t kc, const T_elem alpha,
+        const T_elem* packed_a, const T_elem* packed_b,
+        T_elem* c, const std::size_t ldc)
+{
+    using traits = gemm_traits<T_elem>;
+    constexpr std::size_t MR = traits::MR;
+    constexpr std::size_t NR = traits::NR;
+
+    T_elem ab[MR * NR];
+    for(std::size_t jr=0; jr<nc; jr += NR)
+    {
+        const std::size_t nr = std::min(NR, nc - jr);
+        for(std::size_t ir=0; ir<mc; ir += MR)
+        {
+            const std::size_t mr = std::min(MR, mc - ir);
+            traits::micro_kernel(kc, packed_a + ir * kc, packed_b + jr * kc, ab);
+
+            T_elem* cij = c + ir * ldc + jr;
+            for(std::size_t i=0; i<mr; ++i)
+                for(std::size_t j=0; j<nr; ++j)
+                    cij[i * ldc + j] += alpha * ab[i * NR + j];
+        }
+    }
+    return;
+}
+
+// scale the m x n matrix C by beta. beta == 0 overwrites (even nan).
+template<typename T_elem>
+void gemm_scale(const std::size_t m, const std::size_t n, const T_elem beta,
+                T_elem* c, const std::size_t ldc)
+{
+    if(beta == T_elem(1)) return;
+    for(std::size_t i=0; i<m; ++i)
+        for(std::size_t j=0; j<n; ++j)
+            c[i * ldc + j] = (beta == T_elem(0)) ? T_elem(0) : beta * c[i * ldc + j];
+    return;
+}
+
+// C(ic:ic+mc, jc:jc+nc) += alpha * A(ic:ic+mc, :) * B(:, jc:jc+nc).
+// the summation over k always runs in the same order, so the result of
+// each element does not depend on how the output is tiled.
+template<typename T_elem>
+void gemm_tile(const std::size_t ic, const std::size_t mc,
+        const std::size_t jc, const std::size_t nc, const std::size_t k,
+        const T_elem alpha,
+        const T_elem* a, const std::size_t rsa, const std::size_t csa,
+        const T_elem* b, const std::size_t rsb, const std::size_t csb,
+        T_elem* c, const std::size_t ldc,
+        gemm_buffer<T_elem>& packed_a, gemm_buffer<T_elem>& packed_b)
+{
+    using traits = gemm_traits<T_elem>;
+    constexpr std::size_t MR = traits::MR;
+    constexpr std::size_t NR = traits::NR;
+    constexpr std::size_t MC = traits::MC;
+    constexpr std::size_t KC = traits::KC;
+    constexpr std::size_t NC = traits::NC;
+
+    packed_a.resize(MC * KC);
+    packed_b.resize(KC * ((std::min(NC, nc) + NR - 1) / NR) * NR);
+
+    for(std::size_t jj=jc; jj<jc + nc; jj += NC)
+    {
+        const std::size_t ncc = std::min(NC, jc + nc - jj);
+        for(std::size_t pc=0; pc<k; pc += KC)
+        {
+            const std::size_t kc = std::min(KC, k - pc);
+            gemm_pack_rhs(kc, ncc, b + pc * rsb + jj * csb, rsb, csb,
+                          packed_b.data());
+
+            for(std::size_t ii=ic; ii<ic + mc; ii += MC)
+            {
+                const std::size_t mcc = std::min(MC, ic + mc - ii);
+                gemm_pack_lhs(mcc, kc, a + ii * rsa + pc * csa, rsa, csa,
+                              packed_a.data());
+                gemm_macro_kernel(mcc, ncc, kc, alpha,
+                        packed_a.data(), packed_b.data(), c + ii * ldc + jj, ldc);
+            }
+        }
+    }
+    static_assert(MC % MR == 0, "MC must be a multiple of MR");
+    return;
+}
+
+// split C into a fixed grid of MC x (32 * NR) tiles and hand them to the
+// thread pool. the grid depends only on the shape, and each element is
+// accumulated in the same order as in the serial path, so the result is
+// bitwise identical for any number of threads.
+template<typename T_elem>
+void gemm_parallel(const std::size_t m, const std::size_t n, const std::size_t k,
+        const T_elem alpha,
+        const T_elem* a, const std::size_t rsa, const std::size_t csa,
+        const T_elem* b, const std::size_t rsb, const std::size_t csb,
+        T_elem* c, const std::size_t ldc)
+{
+    constexpr std::size_t tile_row = gemm_traits<T_elem>::MC;
+    constexpr std::size_t tile_col = gemm_traits<T_elem>::NR * 32;
+    const std::size_t row_tiles = (m + tile_row - 1) / tile_row;
+    const std::size_t col_tiles = (n + tile_col - 1) / tile_col;
+
+    default_thread_pool().parallel_for(row_tiles * col_tiles,
+        [=](const std::size_t tile)
+        {
+            const std::size_t ic = (tile / col_tiles) * tile_row;
+            const std::size_t jc = (tile % col_tiles) * tile_col;
+            auto& ws = gemm_workspace<T_elem>();
+            gemm_tile(ic, std::min(tile_row, m - ic), jc, std::min(tile_col, n - jc),
+                      k, alpha, a, rsa, csa, b, rsb, csb, c, ldc, ws.first, ws.second);
+        });
+    return;
+}
+
+/* C = alpha * A * B + beta * C.
+ * C is a row-major m x n buffer with leading dimension ldc.
+ * A is m x k, element (i, p) at a[i * rsa + p * csa].
+ * B is k x n, element (p, j) at b[p * rsb + j * csb].
+ * A transposed operand is passed by swapping its strides.
+ * C must not overlap with A or B.                                    */
+template<typename T_elem>
+void gemm(const std::size_t m, const std::size_t n, const std::size_t k,
+          const T_elem alpha,
+          const T_elem* a, const std::size_t rsa, const std::size_t csa,
+          const T_elem* b, const std::size_t rsb, const std::size_t csb,
+          const T_elem beta, T_elem* c, const std::size_t ldc)
+{
+    if(m == 0 || n == 0) return;
+    gemm_scale(m, n, beta, c, ldc);
+    if(k == 0 || alpha == T_elem(0)) return;
+
+    if(get_num_threads() > 1 && m * n * k >= get_parallel_threshold())
+        return gemm_parallel(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc);
+
+    auto& ws = gemm_workspace<T_elem>();
+    gemm_tile(0, m, 0, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc,
+              ws.first, ws.second);
+    return;
+}
+
+/* y = alpha * A * x + beta * y and y = alpha * A^T * x + beta * y for a
+ * row-major m x k matrix A with leading dimension lda. a product with one
+ * column gains nothing from packing, so these stream A once instead.
+ * rows (columns for the transposed product) are split into fixed chunks,
+ * so the result does not depend on the number of threads.              */
+template<typename T_elem>
+void gemv(const std::size_t m, const std::size_t k, const T_elem alpha,
+          const T_elem* a, const std::size_t lda, const T_elem* x,
+          const T_elem beta, T_elem* y)
+{
+    using traits = packet_traits<T_elem>;
+    constexpr std::size_t lanes = traits::size;
+    constexpr std::size_t chunk = 64;
+    const std::size_t kp = k - k % lanes;
+
+    const auto rows = [=](const std::size_t c)
+    {
+        const std::size_t i1 = std::min(m, (c + 1) * chunk);
+        for(std::size_t i=c*chunk; i<i1; ++i)
+        {
+            const T_elem* const ai = a + i * lda;
+            auto acc = traits::broadcast(T_elem(0));
+            for(std::size_t p=0; p<kp; p+=lanes)
+                acc = packet_add(acc, packet_mul(traits::load(ai + p),
+                                                 traits::load(x + p)));
+            T_elem sum = traits::reduce(acc);
+            for(std::size_t p=kp; p<k; ++p) sum += ai[p] * x[p];
+            y[i] = alpha * sum + (beta == T_elem(0) ? T_elem(0) : beta * y[i]);
+        }
+    };
+    const std::size_t nchunk = (m + chunk - 1) / chunk;
+    if(get_num_threads() > 1 && m * k >= get_parallel_threshold())
+        default_thread_pool().parallel_for(nchunk, rows);
+    else
+        for(std::size_t c=0; c<nchunk; ++c) rows(c);
+    return;
+}
+
+template<typename T_elem>
+void gemv_trans(const std::size_t m, const std::size_t k, const T_elem alpha,
+                const T_elem* a, const std::size_t lda, const T_elem* x,
+                const T_elem beta, T_elem* y)
+{
+    using traits = packet_traits<T_elem>;
+    constexpr std::size_t lanes = traits::size;
+    constexpr std::size_t chunk = 512;
+
+    const auto cols = [=](const std::size_t c)
+    {
+        const std::size_t p0 = c * chunk;
+        const std::size_t p1 = std::min(k, p0 + chunk);
+        const std::size_t pp = p0 + (p1 - p0) - (p1 - p0) % lanes;
+        for(std::size_t p=p0; p<p1; ++p)
+            y[p] = (beta == T_elem(0) ? T_elem(0) : beta * y[p]);
+        for(std::size_t i=0; i<m; ++i)
+        {
+            const T_elem* const ai = a + i * lda;
+            const T_elem xi = alpha * x[i];
+            const auto xp = traits::broadcast(xi);
+            for(std::size_t p=p0; p<pp; p+=lanes)
+                traits::store(y + p, packet_add(traits::load(y + p),
+                              packet_mul(xp, traits::load(ai + p))));
+            for(std::size_t p=pp; p<p1; ++p) y[p] += xi * ai[p];
+        }
+    };
+    const std::size_t nchunk = (k + chunk - 1) / chunk;
+    if(get_num_threads() > 1 && m * k >= get_parallel_threshold())
+        default_thread_pool().parallel_for(nchunk, cols);
+    else
+        for(std::size_t c=0; c<nchunk; ++c) cols(c);
+    return;
+}
+
+}// detail
+}// ax
+#endif /* AX_GEMM_H */
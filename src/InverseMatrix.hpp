@@ -1,10 +1,30 @@
 #ifndef AX_INVERSE_MATRIX_H
 #define AX_INVERSE_MATRIX_H
 #include "Matrix.hpp"
+#include "LUDecomposition.hpp"
+#include <stdexcept>
 
 namespace ax
 {
 
+namespace detail
+{
+// 2x2, 3x3 and 4x4 static matrices have a closed form determinant and inverse
+template<dimension_type I_row, dimension_type I_col>
+struct has_closed_form_inverse
+{
+    constexpr static bool value = I_row == I_col && 2 <= I_row && I_row <= 4;
+};
+
+// the matrix is square or may be square at runtime
+template<dimension_type I_row, dimension_type I_col>
+struct may_be_square
+{
+    constexpr static bool value = I_row == I_col ||
+        is_dynamic_dimension<I_row>::value || is_dynamic_dimension<I_col>::value;
+};
+}// detail
+
 // for 2x2 dimentional
 template<class T_mat, typename std::enable_if<
     is_matrix_expression<typename T_mat::tag>::value&&
@@ -72,5 +92,126 @@ inverse(const T_mat& mat)
     return inv;
 }
 
+// for 4x4 dimentional. the 2x2 minors of the upper and lower two rows are
+// shared by the determinant and all 16 cofactors.
+template<class T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value&&
+    is_same_dimension<T_mat::dim_col, T_mat::dim_row>::value&&
+    is_same_dimension<T_mat::dim_col, 4>::value>::type*& = enabler>
+inline typename T_mat::elem_t
+determinant(const T_mat& mat)
+{
+    const auto s0 = mat(0,0) * mat(1,1) - mat(1,0) * mat(0,1);
+    const auto s1 = mat(0,0) * mat(1,2) - mat(1,0) * mat(0,2);
+    const auto s2 = mat(0,0) * mat(1,3) - mat(1,0) * mat(0,3);
+    const auto s3 = mat(0,1) * mat(1,2) - mat(1,1) * mat(0,2);
+    const auto s4 = mat(0,1) * mat(1,3) - mat(1,1) * mat(0,3);
+    const auto s5 = mat(0,2) * mat(1,3) - mat(1,2) * mat(0,3);
+
+    const auto c5 = mat(2,2) * mat(3,3) - mat(3,2) * mat(2,3);
+    const auto c4 = mat(2,1) * mat(3,3) - mat(3,1) * mat(2,3);
+    const auto c3 = mat(2,1) * mat(3,2) - mat(3,1) * mat(2,2);
+    const auto c2 = mat(2,0) * mat(3,3) - mat(3,0) * mat(2,3);
+    const auto c1 = mat(2,0) * mat(3,2) - mat(3,0) * mat(2,2);
+    const auto c0 = mat(2,0) * mat(3,1) - mat(3,0) * mat(2,1);
+
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+// throws std::runtime_error if det(mat) is exactly 0, as the LU path does.
+// the 2x2 and 3x3 closed forms above do not check it.
+template<class T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value&&
+    is_same_dimension<T_mat::dim_col, T_mat::dim_row>::value&&
+    is_same_dimension<T_mat::dim_col, 4>::value>::type*& = enabler>
+Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>
+inverse(const T_mat& mat)
+{
+    using elem_t = typename T_mat::elem_t;
+    const elem_t a00 = mat(0,0), a01 = mat(0,1), a02 = mat(0,2), a03 = mat(0,3);
+    const elem_t a10 = mat(1,0), a11 = mat(1,1), a12 = mat(1,2), a13 = mat(1,3);
+    const elem_t a20 = mat(2,0), a21 = mat(2,1), a22 = mat(2,2), a23 = mat(2,3);
+    const elem_t a30 = mat(3,0), a31 = mat(3,1), a32 = mat(3,2), a33 = mat(3,3);
+
+    const elem_t s0 = a00 * a11 - a10 * a01;
+    const elem_t s1 = a00 * a12 - a10 * a02;
+    const elem_t s2 = a00 * a13 - a10 * a03;
+    const elem_t s3 = a01 * a12 - a11 * a02;
+    const elem_t s4 = a01 * a13 - a11 * a03;
+    const elem_t s5 = a02 * a13 - a12 * a03;
+
+    const elem_t c5 = a22 * a33 - a32 * a23;
+    const elem_t c4 = a21 * a33 - a31 * a23;
+    const elem_t c3 = a21 * a32 - a31 * a22;
+    const elem_t c2 = a20 * a33 - a30 * a23;
+    const elem_t c1 = a20 * a32 - a30 * a22;
+    const elem_t c0 = a20 * a31 - a30 * a21;
+
+    const elem_t det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if(det == elem_t(0))
+        throw std::runtime_error("inverse: singular matrix");
+    const elem_t det_inv = 1e0 / det;
+
+    Matrix<elem_t, T_mat::dim_row, T_mat::dim_col> inv;
+    inv(0,0) = det_inv * ( a11 * c5 - a12 * c4 + a13 * c3);
+    inv(0,1) = det_inv * (-a01 * c5 + a02 * c4 - a03 * c3);
+    inv(0,2) = det_inv * ( a31 * s5 - a32 * s4 + a33 * s3);
+    inv(0,3) = det_inv * (-a21 * s5 + a22 * s4 - a23 * s3);
+
+    inv(1,0) = det_inv * (-a10 * c5 + a12 * c2 - a13 * c1);
+    inv(1,1) = det_inv * ( a00 * c5 - a02 * c2 + a03 * c1);
+    inv(1,2) = det_inv * (-a30 * s5 + a32 * s2 - a33 * s1);
+    inv(1,3) = det_inv * ( a20 * s5 - a22 * s2 + a23 * s1);
+
+    inv(2,0) = det_inv * ( a10 * c4 - a11 * c2 + a13 * c0);
+    inv(2,1) = det_inv * (-a00 * c4 + a01 * c2 - a03 * c0);
+    inv(2,2) = det_inv * ( a30 * s4 - a31 * s2 + a33 * s0);
+    inv(2,3) = det_inv * (-a20 * s4 + a21 * s2 - a23 * s0);
+
+    inv(3,0) = det_inv * (-a10 * c3 + a11 * c1 - a12 * c0);
+    inv(3,1) = det_inv * ( a00 * c3 - a01 * c1 + a02 * c0);
+    inv(3,2) = det_inv * (-a30 * s3 + a31 * s1 - a32 * s0);
+    inv(3,3) = det_inv * ( a20 * s3 - a21 * s1 + a22 * s0);
+    return inv;
+}
+
+// for the other sizes, static or dynamic, through LU with partial pivoting.
+// throws std::invalid_argument if mat is not square.
+template<class T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value&&
+    detail::may_be_square<T_mat::dim_row, T_mat::dim_col>::value&&
+    !detail::has_closed_form_inverse<T_mat::dim_row, T_mat::dim_col>::value
+    >::type*& = enabler>
+inline typename T_mat::elem_t
+determinant(const T_mat& mat)
+{
+    return PLUdecompose(mat).determinant();
+}
+
+// throws std::runtime_error if mat is singular
+template<class T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value&&
+    detail::may_be_square<T_mat::dim_row, T_mat::dim_col>::value&&
+    !detail::has_closed_form_inverse<T_mat::dim_row, T_mat::dim_col>::value
+    >::type*& = enabler>
+Matrix<typename T_mat::elem_t,
+       detail::square_dimension<T_mat::dim_row, T_mat::dim_col>::value,
+       detail::square_dimension<T_mat::dim_row, T_mat::dim_col>::value>
+inverse(const T_mat& mat)
+{
+    return PLUdecompose(mat).inverse();
+}
+
+// log|det(mat)| for any size, -inf if mat is singular
+template<class T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value&&
+    detail::may_be_square<T_mat::dim_row, T_mat::dim_col>::value
+    >::type*& = enabler>
+inline typename T_mat::elem_t
+log_abs_determinant(const T_mat& mat)
+{
+    return PLUdecompose(mat).log_abs_determinant();
+}
+
 }
 #endif /* AX_INVERSE_MATRIX_H */
@@ -3,8 +3,25 @@
 #include <utility>
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
+#include <array>
+#include <vector>
+#include <functional>
+#include <limits>
+#include <memory>
 #include "Matrix.hpp"
 #include "Vector.hpp"
+#include "DynamicMatrix.hpp"
+#include "DynamicVector.hpp"
+#include "ThreadPool.hpp"
+#include "GEMM.hpp"
+#include "Aliasing.hpp"
+#include "Packet.hpp"
+
+// number of matrices a thread of Jacobimethod_batch takes at a time
+#ifndef AX_JACOBI_BATCH_CHUNK
+#define AX_JACOBI_BATCH_CHUNK 64
+#endif
 
 namespace ax
 {
@@ -12,6 +29,330 @@ namespace ax
 template <typename T_mat>
 class JacobiMethod;
 
+namespace detail
+{
+
+// the rotation that zeroes a(p, q) of a symmetric matrix, as in
+// A' = R^T * A * R with R(p, p) = R(q, q) = c and R(p, q) = -R(q, p) = s.
+// t = s / c is the smaller root of t^2 + 2 * theta * t - 1 = 0.
+template<typename T_elem>
+struct jacobi_rotation
+{
+    jacobi_rotation(const T_elem app, const T_elem aqq, const T_elem apq)
+    {
+        const T_elem theta = (aqq - app) / (2 * apq);
+        t = T_elem(1) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+        if(theta < T_elem(0)) t = -t;
+        c = T_elem(1) / std::sqrt(t * t + 1);
+        s = t * c;
+        tau = s / (c + 1);
+    }
+
+    T_elem c, s, t, tau;
+};
+
+// A = R^T * A * R for the n x n symmetric matrix at a, p < q. only the
+// upper triangle is read and written, and in it only the rows and columns
+// p and q change. the update x' = x - s * (y + tau * x) keeps the rounding
+// error small.
+template<typename T_elem>
+void jacobi_rotate(T_elem* const a, const std::size_t ld, const std::size_t n,
+                   const std::size_t p, const std::size_t q,
+                   const jacobi_rotation<T_elem>& rot)
+{
+    T_elem* const rowp = a + p * ld;
+    T_elem* const rowq = a + q * ld;
+    const T_elem apq = rowp[q];
+    rowp[p] -= rot.t * apq;
+    rowq[q] += rot.t * apq;
+    rowp[q] = T_elem(0);
+
+    for(std::size_t k=0; k<p; ++k) // a(k, p), a(k, q)
+    {
+        T_elem* const rowk = a + k * ld;
+        const T_elem g = rowk[p];
+        const T_elem h = rowk[q];
+        rowk[p] = g - rot.s * (h + rot.tau * g);
+        rowk[q] = h + rot.s * (g - rot.tau * h);
+    }
+    for(std::size_t k=p+1; k<q; ++k) // a(p, k), a(k, q)
+    {
+        const T_elem g = rowp[k];
+        const T_elem h = a[k * ld + q];
+        rowp[k]        = g - rot.s * (h + rot.tau * g);
+        a[k * ld + q]  = h + rot.s * (g - rot.tau * h);
+    }
+    for(std::size_t k=q+1; k<n; ++k) // a(p, k), a(q, k)
+    {
+        const T_elem g = rowp[k];
+        const T_elem h = rowq[k];
+        rowp[k] = g - rot.s * (h + rot.tau * g);
+        rowq[k] = h + rot.s * (g - rot.tau * h);
+    }
+    return;
+}
+
+// W = R^T * W for the n x n matrix at w, rows p and q. W accumulates the
+// transpose of the eigenvectors so that this touches contiguous memory.
+template<typename T_elem>
+void jacobi_rotate_rows(T_elem* const w, const std::size_t ld,
+                        const std::size_t n, const std::size_t p,
+                        const std::size_t q, const jacobi_rotation<T_elem>& rot)
+{
+    T_elem* const rowp = w + p * ld;
+    T_elem* const rowq = w + q * ld;
+    for(std::size_t k=0; k<n; ++k)
+    {
+        const T_elem g = rowp[k];
+        const T_elem h = rowq[k];
+        rowp[k] = g - rot.s * (h + rot.tau * g);
+        rowq[k] = h + rot.s * (g - rot.tau * h);
+    }
+    return;
+}
+
+// a(p, q) does not change the eigenvalues within the tolerances
+template<typename T_elem>
+inline bool jacobi_negligible(const T_elem app, const T_elem aqq, const T_elem apq,
+                              const T_elem abs_tol, const T_elem rel_tol)
+{
+    return std::abs(apq) < abs_tol ||
+           std::abs(apq) <= rel_tol * std::sqrt(std::abs(app) * std::abs(aqq));
+}
+
+// cyclic Jacobi sweeps over the upper triangle of the symmetric n x n
+// matrix at a, accumulating the transposed rotations into w. on return the
+// diagonal of a holds the eigenvalues and row i of w the i-th eigenvector;
+// the strict lower triangle of a is not used. in the first sweeps an
+// element smaller than a fifth of the mean off-diagonal magnitude is left
+// for later (Rutishauser's threshold); a nearly diagonal matrix does not
+// need that and passes threshold_sweep = 0. returns the number of sweeps,
+// or max_sweep + 1 if the matrix did not converge.
+template<typename T_elem>
+std::size_t jacobi_sweeps(T_elem* const a, const std::size_t lda,
+                          T_elem* const w, const std::size_t ldw,
+                          const std::size_t n, const T_elem abs_tol,
+                          const T_elem rel_tol, const std::size_t max_sweep,
+                          const std::size_t threshold_sweep = 3)
+{
+    for(std::size_t sweep=1; sweep<=max_sweep; ++sweep)
+    {
+        T_elem threshold(0);
+        if(sweep <= threshold_sweep)
+        {
+            T_elem off(0);
+            for(std::size_t p=0; p<n; ++p)
+                for(std::size_t q=p+1; q<n; ++q)
+                    off += std::abs(a[p * lda + q]);
+            threshold = T_elem(0.2) * off / (n * n);
+        }
+
+        bool rotated = false;
+        for(std::size_t p=0; p<n; ++p)
+        {
+            for(std::size_t q=p+1; q<n; ++q)
+            {
+                const T_elem app = a[p * lda + p];
+                const T_elem aqq = a[q * lda + q];
+                const T_elem apq = a[p * lda + q];
+                if(jacobi_negligible(app, aqq, apq, abs_tol, rel_tol))
+                {
+                    a[p * lda + q] = T_elem(0);
+                    continue;
+                }
+                if(std::abs(apq) <= threshold)
+                {
+                    rotated = true; // not converged yet
+                    continue;
+                }
+
+                const jacobi_rotation<T_elem> rot(app, aqq, apq);
+                jacobi_rotate(a, lda, n, p, q, rot);
+                jacobi_rotate_rows(w, ldw, n, p, q, rot);
+                rotated = true;
+            }
+        }
+        if(!rotated) return sweep;
+    }
+    return max_sweep + 1;
+}
+
+// the same sweeps in the round-robin ordering of Brent and Luk. a sweep is
+// n - 1 rounds (n rounded up to even) of n / 2 disjoint pairs, and all the
+// rotations of a round are applied at once: A = J^T * A row pair by row
+// pair, then A = A * J row by row, both split over the thread pool. a is
+// the full symmetric matrix here. the result does not depend on the number
+// of threads.
+template<typename T_elem>
+std::size_t jacobi_sweeps_parallel(T_elem* const a, const std::size_t lda,
+                                   T_elem* const w, const std::size_t ldw,
+                                   const std::size_t n, const T_elem abs_tol,
+                                   const T_elem rel_tol, const std::size_t max_sweep,
+                                   const std::size_t threshold_sweep = 3)
+{
+    const std::size_t m = n + n % 2; // index n is a dummy if n is odd
+    std::vector<std::size_t> order(m);
+    for(std::size_t i=0; i<m; ++i) order[i] = i;
+
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    std::vector<jacobi_rotation<T_elem>> rots;
+    pairs.reserve(m / 2);
+    rots.reserve(m / 2);
+
+    // a round costs about 3 * n^2 multiply-adds
+    const std::size_t nthreads = get_num_threads();
+    const bool parallel = nthreads > 1 && 3 * n * n >= get_parallel_threshold();
+
+    const std::function<void(std::size_t)> rotate_row_pair =
+        [&](const std::size_t j)
+        {
+            jacobi_rotate_rows(a, lda, n, pairs[j].first, pairs[j].second, rots[j]);
+            jacobi_rotate_rows(w, ldw, n, pairs[j].first, pairs[j].second, rots[j]);
+        };
+    const std::function<void(std::size_t)> rotate_columns =
+        [&](const std::size_t task)
+        {
+            const std::size_t first = n * task / nthreads;
+            const std::size_t last  = n * (task + 1) / nthreads;
+            for(std::size_t k=first; k<last; ++k)
+            {
+                T_elem* const rowk = a + k * lda;
+                for(std::size_t j=0; j<pairs.size(); ++j)
+                {
+                    const jacobi_rotation<T_elem>& rot = rots[j];
+                    const T_elem g = rowk[pairs[j].first];
+                    const T_elem h = rowk[pairs[j].second];
+                    rowk[pairs[j].first]  = g - rot.s * (h + rot.tau * g);
+                    rowk[pairs[j].second] = h + rot.s * (g - rot.tau * h);
+                }
+            }
+        };
+
+    for(std::size_t sweep=1; sweep<=max_sweep; ++sweep)
+    {
+        T_elem threshold(0);
+        if(sweep <= threshold_sweep)
+        {
+            T_elem off(0);
+            for(std::size_t p=0; p<n; ++p)
+                for(std::size_t q=p+1; q<n; ++q)
+                    off += std::abs(a[p * lda + q]);
+            threshold = T_elem(0.2) * off / (n * n);
+        }
+
+        bool rotated = false;
+        for(std::size_t round=0; round+1<m; ++round)
+        {
+            pairs.clear();
+            rots.clear();
+            for(std::size_t i=0; i<m/2; ++i)
+            {
+                const std::size_t p = std::min(order[i], order[m-1-i]);
+                const std::size_t q = std::max(order[i], order[m-1-i]);
+                if(q >= n) continue;
+
+                const T_elem app = a[p * lda + p];
+                const T_elem aqq = a[q * lda + q];
+                const T_elem apq = a[p * lda + q];
+                if(jacobi_negligible(app, aqq, apq, abs_tol, rel_tol))
+                {
+                    a[p * lda + q] = a[q * lda + p] = T_elem(0);
+                    continue;
+                }
+                rotated = true;
+                if(std::abs(apq) <= threshold) continue;
+
+                pairs.push_back(std::make_pair(p, q));
+                rots.push_back(jacobi_rotation<T_elem>(app, aqq, apq));
+            }
+            // everything but order[0] moves by one place
+            std::rotate(order.begin() + 1, order.end() - 1, order.end());
+            if(pairs.empty()) continue;
+
+            if(parallel)
+            {
+                default_thread_pool().parallel_for(pairs.size(), rotate_row_pair);
+                default_thread_pool().parallel_for(nthreads, rotate_columns);
+            }
+            else
+            {
+                for(std::size_t j=0; j<pairs.size(); ++j) rotate_row_pair(j);
+                for(std::size_t t=0; t<nthreads; ++t) rotate_columns(t);
+            }
+            for(std::size_t j=0; j<pairs.size(); ++j)
+                a[pairs[j].first * lda + pairs[j].second] =
+                a[pairs[j].second * lda + pairs[j].first] = T_elem(0);
+        }
+        if(!rotated) return sweep;
+    }
+    return max_sweep + 1;
+}
+
+// the rows of the n x n matrix at w made orthonormal by modified
+// Gram-Schmidt. returns false if they are (nearly) linearly dependent.
+template<typename T_elem>
+bool jacobi_orthonormalize_rows(T_elem* const w, const std::size_t ld,
+                                const std::size_t n)
+{
+    const T_elem tiny = std::sqrt(std::numeric_limits<T_elem>::epsilon());
+    for(std::size_t i=0; i<n; ++i)
+    {
+        T_elem* const wi = w + i * ld;
+        for(std::size_t j=0; j<i; ++j)
+        {
+            const T_elem* const wj = w + j * ld;
+            T_elem d(0);
+            for(std::size_t k=0; k<n; ++k) d += wi[k] * wj[k];
+            for(std::size_t k=0; k<n; ++k) wi[k] -= d * wj[k];
+        }
+        T_elem norm(0);
+        for(std::size_t k=0; k<n; ++k) norm += wi[k] * wi[k];
+        norm = std::sqrt(norm);
+        if(norm < tiny) return false;
+        for(std::size_t k=0; k<n; ++k) wi[k] /= norm;
+    }
+    return true;
+}
+
+// B = W * A * W^T for the full symmetric n x n matrix at a, made exactly
+// symmetric. with the eigenvectors of a nearby matrix as the rows of W, B
+// is nearly diagonal.
+template<typename T_elem>
+void jacobi_project(const T_elem* const a, const std::size_t lda,
+                    const T_elem* const w, const std::size_t ldw,
+                    const std::size_t n, T_elem* const b, const std::size_t ldb)
+{
+    std::vector<T_elem>& wa = scratch_buffer<std::vector<T_elem>>();
+    wa.resize(n * n);
+    if(n * n * n < AX_GEMM_THRESHOLD)
+    {
+        for(std::size_t i=0; i<n; ++i)
+            for(std::size_t j=0; j<n; ++j)
+            {
+                T_elem sum(0);
+                for(std::size_t k=0; k<n; ++k) sum += w[i * ldw + k] * a[k * lda + j];
+                wa[i * n + j] = sum;
+            }
+        for(std::size_t i=0; i<n; ++i)
+            for(std::size_t j=0; j<n; ++j)
+            {
+                T_elem sum(0);
+                for(std::size_t k=0; k<n; ++k) sum += wa[i * n + k] * w[j * ldw + k];
+                b[i * ldb + j] = sum;
+            }
+    }
+    else
+    {
+        gemm<T_elem>(n, n, n, T_elem(1), w, ldw, 1, a, lda, 1, T_elem(0), wa.data(), n);
+        gemm<T_elem>(n, n, n, T_elem(1), wa.data(), n, 1, w, 1, ldw, T_elem(0), b, ldb);
+    }
+    for(std::size_t i=0; i<n; ++i)
+        for(std::size_t j=i+1; j<n; ++j)
+            b[i * ldb + j] = b[j * ldb + i] = (b[i * ldb + j] + b[j * ldb + i]) / 2;
+    return;
+}
+
+}// detail
 
 template <typename T_elem, dimension_type I_dim>
 class JacobiMethod<Matrix<T_elem, I_dim, I_dim>>
@@ -29,7 +370,11 @@ class JacobiMethod<Matrix<T_elem, I_dim, I_dim>>
 
     constexpr static elem_t ABS_TOLERANCE = 1e-10;
     constexpr static elem_t REL_TOLERANCE = 1e-12;
-    constexpr static std::size_t MAX_LOOP = 10000;
+    constexpr static std::size_t MAX_SWEEP = 100;
+    // deprecated, use MAX_SWEEP. its meaning has changed: it used to be 10000
+    // and to bound the number of single rotations. it now counts sweeps, each
+    // of which rotates all the n(n-1)/2 off-diagonal pairs once.
+    constexpr static std::size_t MAX_LOOP = MAX_SWEEP;
 
   public:
     JacobiMethod(){}
@@ -44,18 +389,30 @@ class JacobiMethod<Matrix<T_elem, I_dim, I_dim>>
 
     std::array<eigenpair_type, dim> solve() const;
 
+    // eigenpairs started from the eigenvectors of a nearby matrix, such as
+    // the previous frame of a trajectory, so that the sweeps only have to
+    // remove the difference. eigenpair i continues guess[i].
+    std::array<eigenpair_type, dim>
+    solve(const std::array<eigenpair_type, dim>& guess) const;
+
+    // number of sweeps of the last solve
+    std::size_t num_sweep() const {return this->num_sweep_;}
+
     matrix_type const& matrix() const {return this->matrix_;}
     matrix_type&       matrix()       {return this->matrix_;}
 
   private:
 
     bool is_symmetric(const matrix_type& m) const;
-    std::pair<std::size_t, std::size_t> get_maxindex(const matrix_type& m) const;
-    elem_t max_relative_tolerance(const matrix_type& ta, const matrix_type& tm) const;
+
+    std::array<eigenpair_type, dim>
+    diagonalize(matrix_type& target, matrix_type& Ps,
+                const std::size_t threshold_sweep) const;
 
   private:
 
     matrix_type matrix_;
+    mutable std::size_t num_sweep_ = 0;
 };
 
 
@@ -67,53 +424,51 @@ JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::solve() const
     if(!is_symmetric(matrix_))
         throw std::invalid_argument("JacobiMethod: asymmetric matrix");
 
+    // target is diagonalized in place, Ps collects the eigenvectors as rows
     matrix_type target(matrix_);
     matrix_type Ps(1e0);
+    return this->diagonalize(target, Ps, 3);
+}
 
-    unsigned int num_Jacobi_loop(0);
-    for(; num_Jacobi_loop < MAX_LOOP; ++num_Jacobi_loop)
-    {
-        if(!is_symmetric(target))
-            throw std::invalid_argument("JacobiMethod: asymmetric matrix");
-
-        std::pair<std::size_t, std::size_t> index(get_maxindex(target));
-
-        if(std::abs(target(index.first, index.second)) < ABS_TOLERANCE) break;
-
-        const elem_t alpha = (target(index.first,  index.first) -
-                              target(index.second, index.second)) * 0.5;
-        const elem_t beta  = -1e0 * target(index.first, index.second);
-        const elem_t gamma = std::abs(alpha) / sqrt(alpha * alpha + beta * beta);
-
-        const elem_t cos_ = sqrt((1e0 + gamma) * 0.5);
-        const elem_t sin_ = (alpha * beta < 0e0) ?
-                             -1.0 * sqrt(0.5 * (1e0 - gamma)) :
-                             sqrt(0.5 * (1e0 - gamma));
-        matrix_type Ppri(1e0);
-        Ppri(index.first, index.first)   =  cos_;
-        Ppri(index.first, index.second)  =  sin_;
-        Ppri(index.second, index.first)  = -sin_;
-        Ppri(index.second, index.second) =  cos_;
-
-        matrix_type temp(transpose(Ppri) * target * Ppri);
-        temp(index.first, index.second) = 0e0; // should be zero
-        temp(index.second, index.first) = 0e0;
+template <typename T_elem, dimension_type I_dim>
+std::array<typename JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::eigenpair_type,
+           JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::dim>
+JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::solve(
+        const std::array<eigenpair_type, dim>& guess) const
+{
+    if(!is_symmetric(matrix_))
+        throw std::invalid_argument("JacobiMethod: asymmetric matrix");
 
-        if(max_relative_tolerance(target, temp) < REL_TOLERANCE) break;
+    matrix_type Ps;
+    for(std::size_t i(0); i<dim; ++i)
+        for(std::size_t j(0); j<dim; ++j) Ps(i,j) = guess[i].second[j];
+    if(!detail::jacobi_orthonormalize_rows(Ps.data(), Ps.stride(), dim))
+        throw std::invalid_argument("JacobiMethod: singular initial basis");
+
+    matrix_type target;
+    detail::jacobi_project(matrix_.data(), matrix_.stride(), Ps.data(),
+                           Ps.stride(), dim, target.data(), target.stride());
+    return this->diagonalize(target, Ps, 0);
+}
 
-        target = temp;
-        temp = Ps * Ppri;
-        Ps = temp;
-    }
+template <typename T_elem, dimension_type I_dim>
+std::array<typename JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::eigenpair_type,
+           JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::dim>
+JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::diagonalize(
+        matrix_type& target, matrix_type& Ps, const std::size_t threshold_sweep) const
+{
+    num_sweep_ = detail::jacobi_sweeps(
+            target.data(), target.stride(), Ps.data(), Ps.stride(), dim,
+            ABS_TOLERANCE, REL_TOLERANCE, MAX_SWEEP, threshold_sweep);
 
-    if(num_Jacobi_loop == MAX_LOOP)
+    if(num_sweep_ > MAX_SWEEP)
         std::cerr << "Warning: Cannot solve with the tolerance" << std::endl;
 
     std::array<eigenpair_type, dim> retval;
     for(std::size_t i(0); i<dim; ++i)
     {
         vector_type evec;
-        for(std::size_t j(0); j<dim; ++j) evec[j] = Ps(j,i);
+        for(std::size_t j(0); j<dim; ++j) evec[j] = Ps(i,j);
         retval[i] = std::make_pair(target(i,i), evec);
     }
 
@@ -121,43 +476,153 @@ JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::solve() const
 }
 
 template <typename T_elem, dimension_type I_dim>
-inline std::pair<std::size_t, std::size_t>
-JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::get_maxindex(const matrix_type& m) const
+inline bool
+JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::is_symmetric(const matrix_type& m) const
 {
-    elem_t max = std::abs(m(0,1));
-    auto index = std::make_pair(0,1);
-
-    for(std::size_t i(0); i<dim-1; ++i)
+    for(std::size_t i(0); i+1<dim; ++i)
         for(std::size_t j(i+1); j<dim; ++j)
-            if(max < std::abs(m(i,j)))
-            {
-                max = std::abs(m(i,j));
-                index = std::make_pair(i,j);
-            }
-    return index;
+            if(std::abs(m(i,j) - m(j,i)) > ABS_TOLERANCE) return false;
+    return true;
 }
 
-template <typename T_elem, dimension_type I_dim>
-inline typename JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::elem_t
-JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::max_relative_tolerance
-    (const matrix_type& ta,  const matrix_type& tm) const
+template <typename T_elem>
+class JacobiMethod<Matrix<T_elem, DYNAMIC, DYNAMIC>>
+{
+  public:
+    // traits
+    using elem_t = T_elem;
+    constexpr static dimension_type dim = DYNAMIC;
+
+    using matrix_type = Matrix<elem_t, DYNAMIC, DYNAMIC>;
+    using vector_type = Vector<elem_t, DYNAMIC>;
+    using eigenvalue_type = elem_t;
+    using eigenvector_type = vector_type;
+    using eigenpair_type = std::pair<elem_t, vector_type>;
+
+    constexpr static elem_t ABS_TOLERANCE = 1e-10;
+    constexpr static elem_t REL_TOLERANCE = 1e-12;
+    constexpr static std::size_t MAX_SWEEP = 100;
+    // deprecated, use MAX_SWEEP. its meaning has changed: it used to be 10000
+    // and to bound the number of single rotations. it now counts sweeps, each
+    // of which rotates all the n(n-1)/2 off-diagonal pairs once.
+    constexpr static std::size_t MAX_LOOP = MAX_SWEEP;
+
+  public:
+    JacobiMethod(){}
+    ~JacobiMethod() = default;
+
+    template<class T_mat, typename std::enable_if<
+        is_matrix_expression<typename T_mat::tag>::value
+        >::type*& = enabler>
+    JacobiMethod(const T_mat& mat) : matrix_(mat){}
+
+    // eigenpairs in the order of the diagonal. the rotations of a sweep are
+    // applied in parallel (Brent-Luk ordering) on large matrices.
+    std::vector<eigenpair_type> solve() const;
+
+    // eigenpairs started from the eigenvectors of a nearby matrix, such as
+    // the previous frame of a trajectory, so that the sweeps only have to
+    // remove the difference. eigenpair i continues guess[i].
+    std::vector<eigenpair_type>
+    solve(const std::vector<eigenpair_type>& guess) const;
+
+    // number of sweeps of the last solve
+    std::size_t num_sweep() const {return this->num_sweep_;}
+
+    matrix_type const& matrix() const {return this->matrix_;}
+    matrix_type&       matrix()       {return this->matrix_;}
+
+  private:
+
+    bool is_symmetric(const matrix_type& m) const;
+
+    std::vector<eigenpair_type>
+    diagonalize(matrix_type& target, matrix_type& Ps,
+                const std::size_t threshold_sweep) const;
+
+  private:
+
+    matrix_type matrix_;
+    mutable std::size_t num_sweep_ = 0;
+};
+
+template <typename T_elem>
+std::vector<typename JacobiMethod<Matrix<T_elem, DYNAMIC, DYNAMIC>>::eigenpair_type>
+JacobiMethod<Matrix<T_elem, DYNAMIC, DYNAMIC>>::solve() const
 {
-    elem_t max_reltol(0e0);
-    for(auto i(0); i<dim; ++i)
+    if(dimension_row(matrix_) != dimension_col(matrix_))
+        throw std::invalid_argument("JacobiMethod: not square matrix");
+    if(!is_symmetric(matrix_))
+        throw std::invalid_argument("JacobiMethod: asymmetric matrix");
+
+    const std::size_t n = dimension_row(matrix_);
+    matrix_type target(matrix_);
+    matrix_type Ps(n, n);
+    for(std::size_t i(0); i<n; ++i) Ps(i,i) = 1e0;
+    return this->diagonalize(target, Ps, 3);
+}
+
+template <typename T_elem>
+std::vector<typename JacobiMethod<Matrix<T_elem, DYNAMIC, DYNAMIC>>::eigenpair_type>
+JacobiMethod<Matrix<T_elem, DYNAMIC, DYNAMIC>>::solve(
+        const std::vector<eigenpair_type>& guess) const
+{
+    if(dimension_row(matrix_) != dimension_col(matrix_))
+        throw std::invalid_argument("JacobiMethod: not square matrix");
+    if(!is_symmetric(matrix_))
+        throw std::invalid_argument("JacobiMethod: asymmetric matrix");
+
+    const std::size_t n = dimension_row(matrix_);
+    if(guess.size() != n)
+        throw std::invalid_argument("JacobiMethod: initial basis size different");
+    matrix_type Ps(n, n);
+    for(std::size_t i(0); i<n; ++i)
     {
-        const elem_t temp = std::abs(ta(i,i) - tm(i,i));
-        if(temp > max_reltol) max_reltol = temp;
+        if(dimension(guess[i].second) != n)
+            throw std::invalid_argument("JacobiMethod: initial basis size different");
+        for(std::size_t j(0); j<n; ++j) Ps(i,j) = guess[i].second[j];
     }
-    return max_reltol;
+    if(!detail::jacobi_orthonormalize_rows(Ps.data(), Ps.stride(), n))
+        throw std::invalid_argument("JacobiMethod: singular initial basis");
+
+    matrix_type target(n, n);
+    detail::jacobi_project(matrix_.data(), matrix_.stride(), Ps.data(),
+                           Ps.stride(), n, target.data(), target.stride());
+    return this->diagonalize(target, Ps, 0);
 }
 
-template <typename T_elem, dimension_type I_dim>
+template <typename T_elem>
+std::vector<typename JacobiMethod<Matrix<T_elem, DYNAMIC, DYNAMIC>>::eigenpair_type>
+JacobiMethod<Matrix<T_elem, DYNAMIC, DYNAMIC>>::diagonalize(
+        matrix_type& target, matrix_type& Ps, const std::size_t threshold_sweep) const
+{
+    const std::size_t n = dimension_row(target);
+    num_sweep_ = detail::jacobi_sweeps_parallel(
+            target.data(), target.stride(), Ps.data(), Ps.stride(), n,
+            ABS_TOLERANCE, REL_TOLERANCE, MAX_SWEEP, threshold_sweep);
+
+    if(num_sweep_ > MAX_SWEEP)
+        std::cerr << "Warning: Cannot solve with the tolerance" << std::endl;
+
+    std::vector<eigenpair_type> retval;
+    retval.reserve(n);
+    for(std::size_t i(0); i<n; ++i)
+    {
+        vector_type evec(n);
+        for(std::size_t j(0); j<n; ++j) evec[j] = Ps(i,j);
+        retval.push_back(std::make_pair(target(i,i), std::move(evec)));
+    }
+    return retval;
+}
+
+template <typename T_elem>
 inline bool
-JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::is_symmetric(const matrix_type& m) const
+JacobiMethod<Matrix<T_elem, DYNAMIC, DYNAMIC>>::is_symmetric(const matrix_type& m) const
 {
-    for(auto i(0); i<dim-1; ++i)
-        for(auto j(i+1); j<dim; ++j)
-            if(fabs(m(i,j) - m(j,i)) > ABS_TOLERANCE) return false;
+    const std::size_t n = dimension_row(m);
+    for(std::size_t i(0); i+1<n; ++i)
+        for(std::size_t j(i+1); j<n; ++j)
+            if(std::abs(m(i,j) - m(j,i)) > ABS_TOLERANCE) return false;
     return true;
 }
 
@@ -176,6 +641,272 @@ Jacobimethod(const T_mat& mat)
             >(mat)).solve();
 }
 
+template<typename T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value&&(
+    is_dynamic_dimension<T_mat::dim_row>::value||
+    is_dynamic_dimension<T_mat::dim_col>::value)>::type*& = enabler>
+std::vector<typename JacobiMethod<
+    Matrix<typename T_mat::elem_t, DYNAMIC, DYNAMIC>>::eigenpair_type>
+Jacobimethod(const T_mat& mat)
+{
+    return (JacobiMethod<Matrix<typename T_mat::elem_t, DYNAMIC, DYNAMIC>>(
+                Matrix<typename T_mat::elem_t, DYNAMIC, DYNAMIC>(mat))).solve();
+}
+
+// eigenpairs of a sequence of slowly changing symmetric matrices, such as
+// one gyration or covariance tensor per trajectory frame. every frame after
+// the first is started from the eigenvectors of the previous one, and its
+// eigenpair i continues eigenpair i of the previous frame. a dynamic frame
+// whose size differs from the previous one is solved from scratch.
+template <typename T_mat>
+class JacobiTrajectory
+{
+  public:
+    using solver_type = JacobiMethod<T_mat>;
+    using matrix_type = typename solver_type::matrix_type;
+    using eigenpair_type = typename solver_type::eigenpair_type;
+    using result_type = decltype(std::declval<const solver_type&>().solve());
+
+  public:
+    JacobiTrajectory() : started_(false), num_sweep_(0){}
+    ~JacobiTrajectory() = default;
+
+    // eigenpairs of the next frame
+    result_type const& solve(const matrix_type& mat)
+    {
+        const solver_type solver(mat);
+        const bool warm = this->started_ &&
+                          dimension_row(mat) == this->result_.size();
+        this->result_ = warm ? solver.solve(this->result_) : solver.solve();
+        this->started_ = true;
+        this->num_sweep_ = solver.num_sweep();
+        return this->result_;
+    }
+
+    // the next frame is solved from scratch
+    void reset() {this->started_ = false;}
+
+    result_type const& eigenpairs() const {return this->result_;}
+    // number of sweeps of the last frame
+    std::size_t num_sweep() const {return this->num_sweep_;}
+
+  private:
+
+    bool        started_;
+    std::size_t num_sweep_;
+    result_type result_;
+};
+
+// eigenpairs of every frame of a trajectory, carried from frame to frame
+template<typename T_mat>
+std::vector<typename JacobiTrajectory<T_mat>::result_type>
+Jacobimethod_trajectory(const std::vector<T_mat>& frames)
+{
+    JacobiTrajectory<T_mat> trajectory;
+    std::vector<typename JacobiTrajectory<T_mat>::result_type> retval;
+    retval.reserve(frames.size());
+    for(const auto& frame : frames)
+        retval.push_back(trajectory.solve(frame));
+    return retval;
+}
+
+namespace detail
+{
+
+/* cyclic Jacobi sweeps on packet_traits<T>::size symmetric N x N matrices at
+ * once. the matrices are interleaved element by element, a[(i * N + j) *
+ * lanes + l] being the (i, j) element of the l-th one, and w holds their
+ * transposed rotations in the same layout. all the lanes go through the
+ * same (p, q) in lockstep; a lane whose a(p, q) is negligible is rotated by
+ * the identity. only the upper triangles are used, and Rutishauser's
+ * threshold is not applied since it does not pay for small N. the sweeps
+ * end when every lane has passed a sweep without rotation or after
+ * max_sweep. returns the mask of the lanes that converged.               */
+template<typename T_elem, std::size_t N>
+int jacobi_sweeps_lanes(T_elem* const a, T_elem* const w, const T_elem abs_tol,
+                        const T_elem rel_tol, const std::size_t max_sweep)
+{
+    using traits = packet_traits<T_elem>;
+    using packet = typename traits::type;
+    constexpr std::size_t lanes = traits::size;
+    constexpr int all_lanes = (1 << lanes) - 1;
+
+    const packet zero = traits::broadcast(T_elem(0));
+    const packet one  = traits::broadcast(T_elem(1));
+    const packet two  = traits::broadcast(T_elem(2));
+    const packet atol = traits::broadcast(abs_tol);
+    const packet rtol = traits::broadcast(rel_tol);
+
+    // x' = x - s * (y + tau * x), y' = y + s * (x - tau * y)
+    const auto rotate = [](T_elem* const x, T_elem* const y, const packet& s,
+                           const packet& tau)
+    {
+        const packet g = traits::load(x);
+        const packet h = traits::load(y);
+        traits::store(x, packet_sub(g, packet_mul(s, packet_add(h, packet_mul(tau, g)))));
+        traits::store(y, packet_add(h, packet_mul(s, packet_sub(g, packet_mul(tau, h)))));
+    };
+    const auto at = [](T_elem* const m, const std::size_t i, const std::size_t j)
+    {
+        return m + (i * N + j) * lanes;
+    };
+
+    int converged = 0;
+    for(std::size_t sweep=1; sweep<=max_sweep && converged != all_lanes; ++sweep)
+    {
+        int rotated = 0;
+        for(std::size_t p=0; p<N; ++p)
+        {
+            for(std::size_t q=p+1; q<N; ++q)
+            {
+                const packet app = traits::load(at(a, p, p));
+                const packet aqq = traits::load(at(a, q, q));
+                const packet apq = traits::load(at(a, p, q));
+                traits::store(at(a, p, q), zero);
+
+                // the test of jacobi_negligible, negated
+                const packet mag = packet_abs(apq);
+                const packet rel = packet_mul(rtol, packet_sqrt(
+                        packet_mul(packet_abs(app), packet_abs(aqq))));
+                const packet bound = packet_select_greater(rel, atol, rel, atol);
+                const int active = packet_greater_mask(mag, bound);
+                if(active == 0) continue;
+                rotated |= active;
+
+                const packet theta = packet_div(packet_sub(aqq, app), packet_mul(two, apq));
+                packet t = packet_div(one, packet_add(packet_abs(theta),
+                        packet_sqrt(packet_add(packet_mul(theta, theta), one))));
+                t = packet_select_greater(zero, theta, packet_sub(zero, t), t);
+                t = packet_select_greater(mag, bound, t, zero);
+                const packet c   = packet_div(one, packet_sqrt(packet_add(packet_mul(t, t), one)));
+                const packet s   = packet_mul(t, c);
+                const packet tau = packet_div(s, packet_add(c, one));
+
+                const packet tapq = packet_mul(t, apq);
+                traits::store(at(a, p, p), packet_sub(app, tapq));
+                traits::store(at(a, q, q), packet_add(aqq, tapq));
+                for(std::size_t k=0; k<p; ++k)   rotate(at(a, k, p), at(a, k, q), s, tau);
+                for(std::size_t k=p+1; k<q; ++k) rotate(at(a, p, k), at(a, k, q), s, tau);
+                for(std::size_t k=q+1; k<N; ++k) rotate(at(a, p, k), at(a, q, k), s, tau);
+                for(std::size_t k=0; k<N; ++k)   rotate(at(w, p, k), at(w, q, k), s, tau);
+            }
+        }
+        converged |= all_lanes & ~rotated;
+    }
+    return converged;
+}
+
+// Jacobimethod_batch on the matrices first .. first + count - 1
+template<typename T_elem, std::size_t N, typename T_eigenpair>
+std::size_t jacobi_batch_range(const Matrix<T_elem, N, N>* const mats,
+                               const std::size_t first, const std::size_t count,
+                               std::array<T_eigenpair, N>* const eigenpairs,
+                               bool* const converged, const T_elem abs_tol,
+                               const T_elem rel_tol, const std::size_t max_sweep)
+{
+    constexpr std::size_t lanes = packet_traits<T_elem>::size;
+    std::vector<T_elem>& buffer = scratch_buffer<std::vector<T_elem>>();
+    buffer.resize(2 * N * N * lanes);
+    T_elem* const a = buffer.data();
+    T_elem* const w = buffer.data() + N * N * lanes;
+
+    std::size_t failed = 0;
+    for(std::size_t k0=first; k0<first+count; k0+=lanes)
+    {
+        const std::size_t width = std::min(lanes, first + count - k0);
+        // unused lanes get the identity, which converges at once
+        for(std::size_t i=0; i<N; ++i)
+        {
+            for(std::size_t j=0; j<N; ++j)
+            {
+                for(std::size_t l=0; l<lanes; ++l)
+                {
+                    const T_elem id = (i == j) ? T_elem(1) : T_elem(0);
+                    a[(i * N + j) * lanes + l] = (l < width) ? mats[k0 + l](i, j) : id;
+                    w[(i * N + j) * lanes + l] = id;
+                }
+            }
+        }
+
+        const int mask = jacobi_sweeps_lanes<T_elem, N>(a, w, abs_tol, rel_tol, max_sweep);
+
+        for(std::size_t l=0; l<width; ++l)
+        {
+            // a NaN never compares greater, so it has to be caught here
+            bool finite = true;
+            std::array<T_eigenpair, N>& pairs = eigenpairs[k0 + l];
+            for(std::size_t i=0; i<N; ++i)
+            {
+                pairs[i].first = a[(i * N + i) * lanes + l];
+                finite = finite && std::isfinite(pairs[i].first);
+                for(std::size_t j=0; j<N; ++j)
+                    pairs[i].second[j] = w[(i * N + j) * lanes + l];
+            }
+            converged[k0 + l] = finite && ((mask >> l) & 1) != 0;
+            if(!converged[k0 + l]) ++failed;
+        }
+    }
+    return failed;
+}
+
+}// detail
+
+// eigenpairs of count symmetric N x N matrices at mats, unsorted as from
+// Jacobimethod, with the tolerances of JacobiMethod.
+// the matrices go through the sweeps packet_traits<T>::size at a time, and
+// chunks of AX_JACOBI_BATCH_CHUNK matrices are spread over the thread pool.
+// only the upper triangles are read and the symmetry is not checked.
+// converged[k] tells whether the k-th matrix met the tolerances within
+// MAX_SWEEP sweeps; nothing is printed. returns the number of matrices that
+// did not converge.
+template<typename T_elem, dimension_type I_dim, typename std::enable_if<
+    is_static_dimension<I_dim>::value>::type*& = enabler>
+std::size_t Jacobimethod_batch(const Matrix<T_elem, I_dim, I_dim>* const mats,
+    const std::size_t count,
+    std::array<typename JacobiMethod<Matrix<T_elem, I_dim, I_dim>>::eigenpair_type,
+               I_dim>* const eigenpairs,
+    bool* const converged)
+{
+    using solver_type = JacobiMethod<Matrix<T_elem, I_dim, I_dim>>;
+    constexpr std::size_t chunk = AX_JACOBI_BATCH_CHUNK;
+    const std::size_t nchunk = (count + chunk - 1) / chunk;
+
+    std::vector<std::size_t> failed(nchunk, 0);
+    const std::function<void(std::size_t)> solve_chunk = [&](const std::size_t c)
+    {
+        const std::size_t first = c * chunk;
+        failed[c] = detail::jacobi_batch_range<T_elem, I_dim>(
+                mats, first, std::min(chunk, count - first), eigenpairs,
+                converged, solver_type::ABS_TOLERANCE,
+                solver_type::REL_TOLERANCE, solver_type::MAX_SWEEP);
+    };
+
+    // a sweep costs about 2 * N^3 multiply-adds per matrix
+    if(nchunk > 1 && get_num_threads() > 1 &&
+       2 * count * I_dim * I_dim * I_dim >= get_parallel_threshold())
+        default_thread_pool().parallel_for(nchunk, solve_chunk);
+    else
+        for(std::size_t c=0; c<nchunk; ++c) solve_chunk(c);
+
+    std::size_t retval = 0;
+    for(std::size_t c=0; c<nchunk; ++c) retval += failed[c];
+    return retval;
+}
+
+template<typename T_elem, dimension_type I_dim, typename std::enable_if<
+    is_static_dimension<I_dim>::value>::type*& = enabler>
+std::size_t Jacobimethod_batch(const std::vector<Matrix<T_elem, I_dim, I_dim>>& mats,
+    std::vector<std::array<typename JacobiMethod<
+        Matrix<T_elem, I_dim, I_dim>>::eigenpair_type, I_dim>>& eigenpairs,
+    std::vector<bool>& converged)
+{
+    eigenpairs.resize(mats.size());
+    std::unique_ptr<bool[]> flags(new bool[mats.size()]);
+    const std::size_t retval = Jacobimethod_batch(
+            mats.data(), mats.size(), eigenpairs.data(), flags.get());
+    converged.assign(flags.get(), flags.get() + mats.size());
+    return retval;
+}
 
 }//ax
 
@@ -2,7 +2,20 @@
 #define AX_LU_DECOMPOSE_H
 #include "Matrix.hpp"
 #include "DynamicMatrix.hpp"
+#include "DynamicVector.hpp"
+#include "GEMM.hpp"
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+// column width of the panels of the blocked LU decomposition
+#ifndef AX_LU_BLOCK_SIZE
+#define AX_LU_BLOCK_SIZE 64
+#endif
 
 namespace ax
 {
@@ -14,8 +27,11 @@ class Doolittle;
 // template<class M>
 // class Crout;
 
-// template<class M>
-// class Cholesky;
+template<class T_mat>
+class Cholesky;
+
+template<class T_mat>
+class LDLT;
 
 template<class T_mat, class T_solver>
 class LUDecomposer;
@@ -68,6 +84,96 @@ class LUDecomposer<Matrix<T_elem, DYNAMIC, DYNAMIC>, T_solver>
     solve(const matrix_type& mat){return solver_type::solve(mat);}
 };
 
+namespace detail
+{
+
+// B = L^-1 * B where L is the m x m unit lower triangle at l and B is an
+// m x n matrix at b. both are row-major with leading dimensions ldl, ldb.
+template<typename T_elem>
+void trsm_unit_lower(const std::size_t m, const std::size_t n,
+                     const T_elem* const l, const std::size_t ldl,
+                     T_elem* const b, const std::size_t ldb)
+{
+    for(std::size_t i=1; i<m; ++i)
+    {
+        T_elem* const rowi = b + i * ldb;
+        for(std::size_t p=0; p<i; ++p)
+        {
+            const T_elem  lip  = l[i * ldl + p];
+            const T_elem* rowp = b + p * ldb;
+            for(std::size_t j=0; j<n; ++j)
+                rowi[j] -= lip * rowp[j];
+        }
+    }
+    return;
+}
+
+// right-looking blocked LU of the n x n row-major matrix at a. each step
+// factorizes a panel of AX_LU_BLOCK_SIZE columns with panel(k, kb), solves
+// for the block row of U right of it and updates the trailing matrix with
+// one GEMM, which runs on the thread pool when it is large enough. returns
+// false if a panel does.
+template<typename T_elem, class T_panel>
+bool lu_blocked(T_elem* const a, const std::size_t ld, const std::size_t n,
+                T_panel&& panel)
+{
+    constexpr std::size_t nb = AX_LU_BLOCK_SIZE;
+    if(n <= nb) return panel(0, n);
+
+    bool regular = true;
+    for(std::size_t k=0; k<n; k+=nb)
+    {
+        const std::size_t kb = std::min(nb, n - k);
+        if(!panel(k, kb)) regular = false;
+
+        const std::size_t rest = n - k - kb;
+        if(rest == 0) break;
+
+        T_elem* const a11 = a + k * ld + k;
+        T_elem* const a12 = a11 + kb;
+        T_elem* const a21 = a11 + kb * ld;
+        T_elem* const a22 = a21 + kb;
+        trsm_unit_lower(kb, rest, a11, ld, a12, ld);
+        gemm<T_elem>(rest, rest, kb, T_elem(-1), a21, ld, 1, a12, ld, 1,
+                     T_elem(1), a22, ld);
+    }
+    return regular;
+}
+
+// the columns [k0, k0 + nb) of the n x n matrix at a without pivoting, as
+// Doolittle's method does. rows k0 and below are updated only within the
+// panel.
+template<typename T_elem>
+bool lu_panel(T_elem* const a, const std::size_t ld, const std::size_t n,
+              const std::size_t k0, const std::size_t nb)
+{
+    const std::size_t kend = k0 + nb;
+    for(std::size_t k=k0; k<kend; ++k)
+    {
+        const T_elem  inv  = T_elem(1) / a[k * ld + k];
+        const T_elem* rowk = a + k * ld;
+        for(std::size_t i=k+1; i<n; ++i)
+        {
+            T_elem* const rowi = a + i * ld;
+            const T_elem l = (rowi[k] *= inv);
+            for(std::size_t j=k+1; j<kend; ++j)
+                rowi[j] -= l * rowk[j];
+        }
+    }
+    return true;
+}
+
+// A = L * U in place, no pivoting
+template<typename T_elem>
+void lu_factorize(T_elem* const a, const std::size_t ld, const std::size_t n)
+{
+    lu_blocked(a, ld, n, [=](const std::size_t k, const std::size_t kb)
+               {return lu_panel(a, ld, n, k, kb);});
+    return;
+}
+
+}// detail
+
 template<typename T_elem, dimension_type I_dim>
 class Doolittle<Matrix<T_elem, I_dim, I_dim>>
 {
@@ -85,7 +191,7 @@ class Doolittle<Matrix<T_elem, I_dim, I_dim>>
         matrix_type LU = mat;
         // TODO: exchange if 0 devide occurs
 
-        self_type::rec_solve(0, LU);
+        self_type::eliminate(LU);
 
         // ~~~~~~~ store values in L and U ~~~~~~~
         for(std::size_t i=0; i < dim; ++i)
@@ -109,11 +215,9 @@ class Doolittle<Matrix<T_elem, I_dim, I_dim>>
     }
 
   private:
-    static void rec_solve(const std::size_t step, matrix_type& LU)
+    static void eliminate(matrix_type& LU)
     {
-        if(step >= dim - 1)
-            return;
-        else
+        for(std::size_t step = 0; step + 1 < dim; ++step)
         {
             const elem_t inv_nn = 1e0 / LU(step,step);
             for(std::size_t i = step+1; i<dim; ++i)
@@ -124,8 +228,8 @@ class Doolittle<Matrix<T_elem, I_dim, I_dim>>
                 {
                     LU(i,j) = LU(i,j) - (LU(step,j) * LU(i,step));
                 }
-            return rec_solve(step + 1, LU);
         }
+        return;
     }
 };
 
@@ -150,7 +254,7 @@ class Doolittle<Matrix<T_elem, I_dim, DYNAMIC>>
         matrix_type LU = mat;
         // TODO: exchange if 0 devide occurs
 
-        self_type::rec_solve(0, LU);
+        self_type::eliminate(LU);
 
         // ~~~~~~~ store values in L and U ~~~~~~~
         for(std::size_t i=0; i < dim; ++i)
@@ -174,11 +278,9 @@ class Doolittle<Matrix<T_elem, I_dim, DYNAMIC>>
     }
 
   private:
-    static void rec_solve(const std::size_t step, matrix_type& LU)
+    static void eliminate(matrix_type& LU)
     {
-        if(step >= dim - 1)
-            return;
-        else
+        for(std::size_t step = 0; step + 1 < dim; ++step)
         {
             const elem_t inv_nn = 1e0 / LU(step,step);
             for(std::size_t i = step+1; i<dim; ++i)
@@ -189,8 +291,8 @@ class Doolittle<Matrix<T_elem, I_dim, DYNAMIC>>
                 {
                     LU(i,j) = LU(i,j) - (LU(step,j) * LU(i,step));
                 }
-            return rec_solve(step + 1, LU);
         }
+        return;
     }
 };
 
@@ -214,7 +316,7 @@ class Doolittle<Matrix<T_elem, DYNAMIC, I_dim>>
         matrix_type LU = mat;
         // TODO: exchange if 0 devide occurs
 
-        self_type::rec_solve(0, LU);
+        self_type::eliminate(LU);
 
         // ~~~~~~~ store values in L and U ~~~~~~~
         for(std::size_t i=0; i < dim; ++i)
@@ -238,11 +340,9 @@ class Doolittle<Matrix<T_elem, DYNAMIC, I_dim>>
     }
 
   private:
-    static void rec_solve(const std::size_t step, matrix_type& LU)
+    static void eliminate(matrix_type& LU)
     {
-        if(step >= dim - 1)
-            return;
-        else
+        for(std::size_t step = 0; step + 1 < dim; ++step)
         {
             const elem_t inv_nn = 1e0 / LU(step,step);
             for(std::size_t i = step+1; i<dim; ++i)
@@ -253,8 +353,8 @@ class Doolittle<Matrix<T_elem, DYNAMIC, I_dim>>
                 {
                     LU(i,j) = LU(i,j) - (LU(step,j) * LU(i,step));
                 }
-            return rec_solve(step + 1, LU);
         }
+        return;
     }
 };
 
@@ -274,12 +374,12 @@ class Doolittle<Matrix<T_elem, DYNAMIC, DYNAMIC>>
             throw std::invalid_argument("Doolittle method: not square matrix");
 
         const dimension_type dim_ = dimension_col(mat);
-        matrix_type L;
-        matrix_type U;
+        matrix_type L(dim_, dim_);
+        matrix_type U(dim_, dim_);
         matrix_type LU = mat;
         // TODO: exchange if 0 devide occurs
 
-        self_type::rec_solve(0, LU);
+        self_type::eliminate(LU);
 
         // ~~~~~~~ store values in L and U ~~~~~~~
         for(std::size_t i=0; i < dim_; ++i)
@@ -303,24 +403,11 @@ class Doolittle<Matrix<T_elem, DYNAMIC, DYNAMIC>>
     }
 
   private:
-    static void rec_solve(const std::size_t step, matrix_type& LU)
+    // blocked: unpivoted panels, a triangular solve and a GEMM update
+    static void eliminate(matrix_type& LU)
     {
-        const dimension_type dim_ = dimension_col(LU);
-        if(step >= dim_ - 1)
-            return;
-        else
-        {
-            const elem_t inv_nn = 1e0 / LU(step,step);
-            for(std::size_t i = step+1; i<dim_; ++i)
-                LU(i,step) = LU(i,step) * inv_nn;
-
-            for(std::size_t i = step+1; i<dim_; ++i)
-                for(std::size_t j = step+1; j<dim_; ++j)
-                {
-                    LU(i,j) = LU(i,j) - (LU(step,j) * LU(i,step));
-                }
-            return rec_solve(step + 1, LU);
-        }
+        detail::lu_factorize(LU.data(), LU.stride(), dimension_col(LU));
+        return;
     }
 };
 
@@ -376,5 +463,582 @@ LUdecompose(const T_mat& mat)
             >::solve(mat);
 }
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~ LU with partial pivoting ~~~~~~~~~~~~~~~~~~~~~~~~~
+// P * A = L * U. L has a unit diagonal and is stored below the diagonal of
+// the factor matrix, U on and above it. the row permutation is kept as a
+// vector: row i of P * A is row perm[i] of A.
+
+namespace detail
+{
+
+// the static one of the two dimensions of a square matrix, if any
+template<dimension_type I_row, dimension_type I_col>
+struct square_dimension
+{
+    constexpr static dimension_type value =
+        is_static_dimension<I_row>::value ? I_row : I_col;
+};
+
+template<dimension_type I_dim>
+struct permutation_type
+{
+    using type = std::array<std::size_t, I_dim>;
+};
+
+template<>
+struct permutation_type<DYNAMIC>
+{
+    using type = std::vector<std::size_t>;
+};
+
+template<std::size_t N>
+inline void init_permutation(std::array<std::size_t, N>& perm, const std::size_t n)
+{
+    if(n != N) throw std::invalid_argument("permutation size different");
+    for(std::size_t i=0; i<N; ++i) perm[i] = i;
+    return;
+}
+
+inline void init_permutation(std::vector<std::size_t>& perm, const std::size_t n)
+{
+    perm.resize(n);
+    for(std::size_t i=0; i<n; ++i) perm[i] = i;
+    return;
+}
+
+// factorizes the columns [k0, k0 + nb) of the n x n row-major matrix at a
+// whose rows are ld apart. rows k0 and below are updated only within the
+// panel; pivot rows are swapped over the full width. returns false if an
+// exactly zero pivot is met. that column is then left unscaled.
+template<typename T_elem, class T_perm>
+bool plu_panel(T_elem* const a, const std::size_t ld, const std::size_t n,
+               const std::size_t k0, const std::size_t nb, T_perm& perm, int& sign)
+{
+    bool regular = true;
+    const std::size_t kend = k0 + nb;
+    for(std::size_t k=k0; k<kend; ++k)
+    {
+        std::size_t piv  = k;
+        T_elem      vmax = std::abs(a[k * ld + k]);
+        for(std::size_t i=k+1; i<n; ++i)
+        {
+            const T_elem v = std::abs(a[i * ld + k]);
+            if(v > vmax){vmax = v; piv = i;}
+        }
+        if(piv != k)
+        {
+            std::swap_ranges(a + k * ld, a + k * ld + n, a + piv * ld);
+            std::swap(perm[k], perm[piv]);
+            sign = -sign;
+        }
+
+        const T_elem pivot = a[k * ld + k];
+        if(pivot == T_elem(0)){regular = false; continue;}
+
+        const T_elem  inv  = T_elem(1) / pivot;
+        const T_elem* rowk = a + k * ld;
+        for(std::size_t i=k+1; i<n; ++i)
+        {
+            T_elem* const rowi = a + i * ld;
+            const T_elem l = (rowi[k] *= inv);
+            for(std::size_t j=k+1; j<kend; ++j)
+                rowi[j] -= l * rowk[j];
+        }
+    }
+    return regular;
+}
+
+// blocked LU with partial pivoting within each panel
+template<typename T_elem, class T_perm>
+bool plu_factorize(T_elem* const a, const std::size_t ld,
+                   const std::size_t n, T_perm& perm, int& sign)
+{
+    return lu_blocked(a, ld, n, [=, &perm, &sign](const std::size_t k,
+                                                  const std::size_t kb)
+                      {return plu_panel(a, ld, n, k, kb, perm, sign);});
+}
+
+// B = U^-1 * B where U is the m x m upper triangle at u (non-unit diagonal)
+template<typename T_elem>
+void trsm_upper(const std::size_t m, const std::size_t n,
+                const T_elem* const u, const std::size_t ldu,
+                T_elem* const b, const std::size_t ldb)
+{
+    for(std::size_t i=m; i-- > 0;)
+    {
+        T_elem* const rowi = b + i * ldb;
+        for(std::size_t p=i+1; p<m; ++p)
+        {
+            const T_elem  uip  = u[i * ldu + p];
+            const T_elem* rowp = b + p * ldb;
+            for(std::size_t j=0; j<n; ++j)
+                rowi[j] -= uip * rowp[j];
+        }
+        const T_elem inv = T_elem(1) / u[i * ldu + i];
+        for(std::size_t j=0; j<n; ++j)
+            rowi[j] *= inv;
+    }
+    return;
+}
+
+// row i of the n x nrhs matrix at x becomes its row perm[i]
+template<typename T_elem, class T_perm>
+void permute_rows(T_elem* const x, const std::size_t ldx, const std::size_t n,
+                  const std::size_t nrhs, const T_perm& perm)
+{
+    std::vector<T_elem>& buf = scratch_buffer<std::vector<T_elem>>();
+    buf.resize(n * nrhs);
+    for(std::size_t i=0; i<n; ++i)
+        std::copy(x + perm[i] * ldx, x + perm[i] * ldx + nrhs, buf.data() + i * nrhs);
+    for(std::size_t i=0; i<n; ++i)
+        std::copy(buf.data() + i * nrhs, buf.data() + (i+1) * nrhs, x + i * ldx);
+    return;
+}
+
+// X = U^-1 * L^-1 * X for the packed factors at lu and the already
+// permuted n x nrhs right hand side at x. both triangular solves go block
+// by block; everything off the diagonal blocks is one GEMM per block.
+template<typename T_elem>
+void plu_solve_inplace(const T_elem* const lu, const std::size_t ld,
+                       const std::size_t n, T_elem* const x,
+                       const std::size_t ldx, const std::size_t nrhs)
+{
+    constexpr std::size_t nb = AX_LU_BLOCK_SIZE;
+    if(n == 0 || nrhs == 0) return;
+
+    for(std::size_t k=0; k<n; k+=nb)
+    {
+        const std::size_t kb    = std::min(nb, n - k);
+        const std::size_t below = n - k - kb;
+        trsm_unit_lower(kb, nrhs, lu + k * ld + k, ld, x + k * ldx, ldx);
+        if(below != 0)
+            gemm<T_elem>(below, nrhs, kb, T_elem(-1),
+                         lu + (k + kb) * ld + k, ld, 1, x + k * ldx, ldx, 1,
+                         T_elem(1), x + (k + kb) * ldx, ldx);
+    }
+    for(std::size_t k=((n - 1) / nb) * nb; ; k-=nb)
+    {
+        const std::size_t kb = std::min(nb, n - k);
+        trsm_upper(kb, nrhs, lu + k * ld + k, ld, x + k * ldx, ldx);
+        if(k == 0) break;
+        gemm<T_elem>(k, nrhs, kb, T_elem(-1), lu + k, ld, 1, x + k * ldx, ldx, 1,
+                     T_elem(1), x, ldx);
+    }
+    return;
+}
+
+// x = U^-1 * L^-1 * x for one right hand side
+template<typename T_elem>
+void plu_solve_vector(const T_elem* const lu, const std::size_t ld,
+                      const std::size_t n, T_elem* const x)
+{
+    for(std::size_t i=1; i<n; ++i)
+    {
+        const T_elem* const row = lu + i * ld;
+        T_elem sum(0);
+        for(std::size_t j=0; j<i; ++j) sum += row[j] * x[j];
+        x[i] -= sum;
+    }
+    for(std::size_t i=n; i-- > 0;)
+    {
+        const T_elem* const row = lu + i * ld;
+        T_elem sum(0);
+        for(std::size_t j=i+1; j<n; ++j) sum += row[j] * x[j];
+        x[i] = (x[i] - sum) / row[i];
+    }
+    return;
+}
+
+}// detail
+
+// overwrites the square matrix mat with its packed L and U factors and perm
+// with the row permutation. returns the sign of the permutation, or 0 if
+// mat is singular, so that det(mat) is the return value times the product
+// of the diagonal of the result.
+template<class T_mat, class T_perm, typename std::enable_if<
+    is_matrix_type<typename T_mat::tag>::value>::type*& = enabler>
+int PLUdecompose_inplace(T_mat& mat, T_perm& perm)
+{
+    if(dimension_col(mat) != dimension_row(mat))
+        throw std::invalid_argument("PLU decomposition: not square matrix");
+
+    const std::size_t n = dimension_row(mat);
+    detail::init_permutation(perm, n);
+    int sign = 1;
+    const bool regular =
+        detail::plu_factorize(mat.data(), mat.stride(), n, perm, sign);
+    return regular ? sign : 0;
+}
+
+template<class T_mat>
+class PLUDecomposition;
+
+template<typename T_elem, dimension_type I_row, dimension_type I_col>
+class PLUDecomposition<Matrix<T_elem, I_row, I_col>>
+{
+  public:
+
+    using elem_t = T_elem;
+    using matrix_type = Matrix<T_elem, I_row, I_col>;
+    constexpr static dimension_type dim =
+        detail::square_dimension<I_row, I_col>::value;
+    using permutation_type = typename detail::permutation_type<dim>::type;
+    using vector_type = Vector<T_elem, dim>;
+
+    explicit PLUDecomposition(const matrix_type& mat)
+        : lu_(mat)
+    {
+        sign_ = PLUdecompose_inplace(lu_, perm_);
+    }
+    explicit PLUDecomposition(matrix_type&& mat)
+        : lu_(std::move(mat))
+    {
+        sign_ = PLUdecompose_inplace(lu_, perm_);
+    }
+
+    std::size_t size() const {return dimension_row(lu_);}
+
+    // packed factors and permutation
+    matrix_type      const& LU()          const {return lu_;}
+    permutation_type const& permutation() const {return perm_;}
+
+    // sign of the permutation, 0 if the matrix is singular
+    int  sign()        const {return sign_;}
+    bool is_singular() const {return sign_ == 0;}
+
+    // unit lower triangular factor
+    matrix_type L() const
+    {
+        matrix_type retval(lu_);
+        for(std::size_t i=0; i<this->size(); ++i)
+            for(std::size_t j=0; j<this->size(); ++j)
+                retval(i, j) = (j < i) ? lu_(i, j) : elem_t(i == j ? 1 : 0);
+        return retval;
+    }
+
+    // upper triangular factor
+    matrix_type U() const
+    {
+        matrix_type retval(lu_);
+        for(std::size_t i=0; i<this->size(); ++i)
+            for(std::size_t j=0; j<i; ++j)
+                retval(i, j) = elem_t(0);
+        return retval;
+    }
+
+    // det(A), 0 if A is singular
+    elem_t determinant() const
+    {
+        elem_t det = static_cast<elem_t>(sign_);
+        for(std::size_t i=0; i<this->size(); ++i) det *= lu_(i, i);
+        return det;
+    }
+
+    // log|det(A)|, -inf if A is singular. does not overflow where the
+    // product of the pivots would.
+    elem_t log_abs_determinant() const
+    {
+        if(this->is_singular()) return -std::numeric_limits<elem_t>::infinity();
+        elem_t retval(0);
+        for(std::size_t i=0; i<this->size(); ++i)
+            retval += std::log(std::abs(lu_(i, i)));
+        return retval;
+    }
+
+    // A^-1, solving for every column of the permuted identity at once
+    Matrix<elem_t, dim, dim> inverse() const
+    {
+        this->check_solvable(this->size());
+        const std::size_t n = this->size();
+        Matrix<elem_t, dim, dim> X(lu_);
+        for(std::size_t i=0; i<n; ++i)
+            for(std::size_t j=0; j<n; ++j)
+                X(i, j) = (j == perm_[i]) ? elem_t(1) : elem_t(0);
+        detail::plu_solve_inplace(lu_.data(), lu_.stride(), n,
+                                  X.data(), X.stride(), n);
+        return X;
+    }
+
+    // x such that A * x = b
+    template<class T_vec, typename std::enable_if<
+        is_vector_expression<typename T_vec::tag>::value&&
+        std::is_same<typename T_vec::elem_t, elem_t>::value>::type*& = enabler>
+    vector_type solve(const T_vec& b) const
+    {
+        this->check_solvable(dimension(b));
+        const std::size_t n = this->size();
+        vector_type x(b);
+        detail::permute_rows(x.data(), 1, n, 1, perm_);
+        detail::plu_solve_vector(lu_.data(), lu_.stride(), n, x.data());
+        return x;
+    }
+
+    // X such that A * X = B, for every column of B at once
+    template<class T_rhs, typename std::enable_if<
+        is_matrix_expression<typename T_rhs::tag>::value&&
+        std::is_same<typename T_rhs::elem_t, elem_t>::value>::type*& = enabler>
+    Matrix<elem_t, dim, T_rhs::dim_col> solve(const T_rhs& B) const
+    {
+        this->check_solvable(dimension_row(B));
+        const std::size_t n = this->size();
+        Matrix<elem_t, dim, T_rhs::dim_col> X(B);
+        detail::permute_rows(X.data(), X.stride(), n, dimension_col(X), perm_);
+        detail::plu_solve_inplace(lu_.data(), lu_.stride(), n,
+                                  X.data(), X.stride(), dimension_col(X));
+        return X;
+    }
+
+  private:
+
+    void check_solvable(const std::size_t rhs_size) const
+    {
+        if(rhs_size != this->size())
+            throw std::invalid_argument("PLU decomposition: rhs size different");
+        if(this->is_singular())
+            throw std::runtime_error("PLU decomposition: singular matrix");
+        return;
+    }
+
+  private:
+
+    matrix_type      lu_;
+    permutation_type perm_;
+    int              sign_;
+};
+
+template<typename T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value>::type*& = enabler>
+inline PLUDecomposition<Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>>
+PLUdecompose(const T_mat& mat)
+{
+    return PLUDecomposition<
+        Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>>(
+            Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>(mat));
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~ symmetric matrices ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Cholesky: A = L * L^T for a symmetric positive definite A.
+// LDLT    : A = L * D * L^T with a unit lower L and a diagonal D, no pivoting.
+// both read only the lower triangle of A and overwrite it with the factor
+// (LDLT keeps D on the diagonal). the strict upper triangle is untouched.
+
+namespace detail
+{
+
+// unblocked Cholesky of the n x n block at a. the block is already updated
+// by everything left of it. returns false if it is not positive definite.
+template<typename T_elem>
+bool cholesky_block(T_elem* const a, const std::size_t ld, const std::size_t n)
+{
+    for(std::size_t j=0; j<n; ++j)
+    {
+        T_elem* const rowj = a + j * ld;
+        T_elem d = rowj[j];
+        for(std::size_t p=0; p<j; ++p) d -= rowj[p] * rowj[p];
+        if(!(d > T_elem(0))) return false;
+
+        const T_elem ljj = std::sqrt(d);
+        const T_elem inv = T_elem(1) / ljj;
+        rowj[j] = ljj;
+        for(std::size_t i=j+1; i<n; ++i)
+        {
+            T_elem* const rowi = a + i * ld;
+            T_elem sum = rowi[j];
+            for(std::size_t p=0; p<j; ++p) sum -= rowi[p] * rowj[p];
+            rowi[j] = sum * inv;
+        }
+    }
+    return true;
+}
+
+// B = B * L^-T for the n x n lower triangle at l and the m x n B at b
+template<typename T_elem>
+void trsm_right_lower_trans(const std::size_t m, const std::size_t n,
+                            const T_elem* const l, const std::size_t ldl,
+                            T_elem* const b, const std::size_t ldb)
+{
+    for(std::size_t i=0; i<m; ++i)
+    {
+        T_elem* const rowi = b + i * ldb;
+        for(std::size_t j=0; j<n; ++j)
+        {
+            const T_elem* const lj = l + j * ldl;
+            T_elem sum = rowi[j];
+            for(std::size_t p=0; p<j; ++p) sum -= rowi[p] * lj[p];
+            rowi[j] = sum / lj[j];
+        }
+    }
+    return;
+}
+
+// lower triangle of the n x n matrix at c -= A * A^T, A is n x k at a.
+// c is updated one block row at a time: a GEMM left of the diagonal block
+// and a scalar loop inside it, so that the upper triangle is not written.
+template<typename T_elem>
+void syrk_lower(const std::size_t n, const std::size_t k,
+                const T_elem* const a, const std::size_t lda,
+                T_elem* const c, const std::size_t ldc)
+{
+    constexpr std::size_t nb = AX_LU_BLOCK_SIZE;
+    const std::size_t nblocks = (n + nb - 1) / nb;
+
+    const std::function<void(std::size_t)> block_row =
+        [=](const std::size_t blk)
+        {
+            const std::size_t i0 = blk * nb;
+            const std::size_t ib = std::min(nb, n - i0);
+            if(i0 != 0)
+                gemm<T_elem>(ib, i0, k, T_elem(-1), a + i0 * lda, lda, 1,
+                             a, 1, lda, T_elem(1), c + i0 * ldc, ldc);
+            for(std::size_t i=i0; i<i0+ib; ++i)
+            {
+                const T_elem* const ai = a + i * lda;
+                for(std::size_t j=i0; j<=i; ++j)
+                {
+                    const T_elem* const aj = a + j * lda;
+                    T_elem sum(0);
+                    for(std::size_t p=0; p<k; ++p) sum += ai[p] * aj[p];
+                    c[i * ldc + j] -= sum;
+                }
+            }
+        };
+
+    if(get_num_threads() > 1 && n * n * k >= 2 * get_parallel_threshold())
+        default_thread_pool().parallel_for(nblocks, block_row);
+    else
+        for(std::size_t blk=0; blk<nblocks; ++blk) block_row(blk);
+    return;
+}
+
+// right-looking blocked Cholesky: factor the diagonal block, solve for the
+// panel below it, then update the lower half of the trailing matrix.
+template<typename T_elem>
+bool cholesky_factorize(T_elem* const a, const std::size_t ld, const std::size_t n)
+{
+    constexpr std::size_t nb = AX_LU_BLOCK_SIZE;
+    for(std::size_t k=0; k<n; k+=nb)
+    {
+        const std::size_t kb   = std::min(nb, n - k);
+        const std::size_t rest = n - k - kb;
+        T_elem* const a11 = a + k * ld + k;
+        if(!cholesky_block(a11, ld, kb)) return false;
+        if(rest == 0) break;
+
+        T_elem* const a21 = a11 + kb * ld;
+        trsm_right_lower_trans(rest, kb, a11, ld, a21, ld);
+        syrk_lower(rest, kb, a21, ld, a21 + kb, ld);
+    }
+    return true;
+}
+
+// left-looking LDLT. row i of L is dotted with w = D * (row j of L).
+template<typename T_elem>
+bool ldlt_factorize(T_elem* const a, const std::size_t ld, const std::size_t n)
+{
+    std::vector<T_elem>& w = scratch_buffer<std::vector<T_elem>>();
+    w.resize(n);
+    for(std::size_t j=0; j<n; ++j)
+    {
+        T_elem* const rowj = a + j * ld;
+        T_elem d = rowj[j];
+        for(std::size_t p=0; p<j; ++p)
+        {
+            w[p] = rowj[p] * a[p * ld + p];
+            d   -= rowj[p] * w[p];
+        }
+        if(d == T_elem(0)) return false;
+
+        rowj[j] = d;
+        const T_elem inv = T_elem(1) / d;
+        for(std::size_t i=j+1; i<n; ++i)
+        {
+            T_elem* const rowi = a + i * ld;
+            T_elem sum = rowi[j];
+            for(std::size_t p=0; p<j; ++p) sum -= rowi[p] * w[p];
+            rowi[j] = sum * inv;
+        }
+    }
+    return true;
+}
+
+}// detail
+
+// overwrites the lower triangle of mat with L. returns false if mat is not
+// positive definite; mat is then partially overwritten.
+template<class T_mat, typename std::enable_if<
+    is_matrix_type<typename T_mat::tag>::value>::type*& = enabler>
+bool Choleskydecompose_inplace(T_mat& mat)
+{
+    if(dimension_col(mat) != dimension_row(mat))
+        throw std::invalid_argument("Cholesky decomposition: not square matrix");
+    return detail::cholesky_factorize(mat.data(), mat.stride(), dimension_row(mat));
+}
+
+// overwrites the strict lower triangle of mat with L and the diagonal with D.
+// returns false if a zero pivot is met.
+template<class T_mat, typename std::enable_if<
+    is_matrix_type<typename T_mat::tag>::value>::type*& = enabler>
+bool LDLTdecompose_inplace(T_mat& mat)
+{
+    if(dimension_col(mat) != dimension_row(mat))
+        throw std::invalid_argument("LDLT decomposition: not square matrix");
+    return detail::ldlt_factorize(mat.data(), mat.stride(), dimension_row(mat));
+}
+
+// solvers for LUDecomposer. U is transpose(L) for Cholesky and D * transpose(L)
+// for LDLT, so that L * U == A in both cases.
+template<class T_mat>
+class Cholesky
+{
+  public:
+
+    using elem_t = typename T_mat::elem_t;
+    using matrix_type = T_mat;
+
+    static std::pair<matrix_type, matrix_type> solve(const matrix_type& mat)
+    {
+        matrix_type L(mat);
+        if(!Choleskydecompose_inplace(L))
+            throw std::invalid_argument("Cholesky decomposition: not positive definite");
+
+        const std::size_t n = dimension_row(L);
+        matrix_type U(L);
+        for(std::size_t i=0; i<n; ++i)
+            for(std::size_t j=0; j<n; ++j)
+            {
+                U(i, j) = (i <= j) ? L(j, i) : elem_t(0);
+                if(i < j) L(i, j) = elem_t(0);
+            }
+        return std::make_pair(L, U);
+    }
+};
+
+template<class T_mat>
+class LDLT
+{
+  public:
+
+    using elem_t = typename T_mat::elem_t;
+    using matrix_type = T_mat;
+
+    static std::pair<matrix_type, matrix_type> solve(const matrix_type& mat)
+    {
+        matrix_type L(mat);
+        if(!LDLTdecompose_inplace(L))
+            throw std::invalid_argument("LDLT decomposition: zero pivot");
+
+        const std::size_t n = dimension_row(L);
+        matrix_type U(L);
+        for(std::size_t i=0; i<n; ++i)
+            for(std::size_t j=0; j<n; ++j)
+                U(i, j) = (i == j) ? L(i, i) :
+                          (i <  j) ? L(i, i) * L(j, i) : elem_t(0);
+        for(std::size_t i=0; i<n; ++i)
+            for(std::size_t j=i; j<n; ++j)
+                L(i, j) = (i == j) ? elem_t(1) : elem_t(0);
+        return std::make_pair(L, U);
+    }
+};
+
 }
 #endif /* AX_LU_DECOMPOSE_H */
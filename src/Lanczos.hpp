@@ -0,0 +1,289 @@
+#ifndef AX_LANCZOS_H
+#define AX_LANCZOS_H
+#include "SymmetricEigen.hpp"
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cmath>
+
+namespace ax
+{
+
+/* a few eigenpairs at one end of the spectrum of a large symmetric matrix
+ * by the thick restart Lanczos method (K. Wu and H. Simon, SIAM J. Matrix
+ * Anal. Appl. 22, 602 (2000)).
+ * the matrix enters only through y = A * x, so it can be an operator that
+ * is never formed (a Hessian-vector product, a covariance applied as
+ * X^T * (X * x)). a Krylov basis of m vectors (max(2k+1, k+20) by default)
+ * is built with full reorthogonalization, the Ritz pairs of the projected
+ * m x m matrix are computed by HouseholderQL, and the basis is restarted
+ * from the (m + k) / 2 best Ritz vectors until the k wanted ones have
+ * |A * x - theta * x| <= tolerance * |theta|.
+ * memory is (m + 1) * n for the basis; the matrix itself is never copied
+ * by the helper functions.                                                 */
+
+template <typename T_mat>
+class Lanczos;
+
+template <typename T_elem>
+class Lanczos<Matrix<T_elem, DYNAMIC, DYNAMIC>>
+{
+  public:
+    // traits
+    using elem_t = T_elem;
+    constexpr static dimension_type dim = DYNAMIC;
+
+    using matrix_type = Matrix<elem_t, DYNAMIC, DYNAMIC>;
+    using vector_type = Vector<elem_t, DYNAMIC>;
+    using eigenvalue_type = elem_t;
+    using eigenvector_type = vector_type;
+    using eigenpair_type = std::pair<elem_t, vector_type>;
+    // y = A * x. y has the size of x on entry.
+    using operator_type = std::function<void(const vector_type&, vector_type&)>;
+
+    constexpr static elem_t TOLERANCE = 1e-10;
+    constexpr static elem_t ABS_TOLERANCE = 1e-10; // symmetry of a matrix
+    constexpr static std::size_t MAX_RESTART = 1000;
+
+  public:
+    ~Lanczos() = default;
+
+    // k eigenpairs of the n x n operator op. op is not checked: it must be
+    // symmetric, (A * x, y) = (x, A * y), or the Ritz pairs are meaningless.
+    Lanczos(operator_type op, const std::size_t n, const std::size_t k)
+        : n_(n), k_(k), subspace_(0), tolerance_(TOLERANCE),
+          num_restart_(0), num_product_(0), op_(std::move(op))
+    {
+        if(k > n) throw std::invalid_argument("Lanczos: k larger than matrix");
+    }
+
+    // k eigenpairs of mat. mat is referred to, not copied, and must outlive
+    // this object.
+    Lanczos(const matrix_type& mat, const std::size_t k)
+        : Lanczos(matrix_operator(mat), dimension_row(mat), k)
+    {
+        if(dimension_row(mat) != dimension_col(mat))
+            throw std::invalid_argument("Lanczos: not square matrix");
+        const std::size_t n = dimension_row(mat);
+        for(std::size_t i(0); i+1<n; ++i)
+            for(std::size_t j(i+1); j<n; ++j)
+                if(std::abs(mat(i,j) - mat(j,i)) > ABS_TOLERANCE)
+                    throw std::invalid_argument("Lanczos: asymmetric matrix");
+    }
+
+    // the k largest eigenpairs, largest first
+    std::vector<eigenpair_type> largest()  {return this->solve(true);}
+    // the k smallest eigenpairs, smallest first
+    std::vector<eigenpair_type> smallest() {return this->solve(false);}
+
+    // dimension of the Krylov basis, k < m <= n. 0 for the default.
+    void set_subspace(const std::size_t m) {subspace_ = m;}
+    // relative residual |A * x - theta * x| / |theta| of a converged pair
+    void set_tolerance(const elem_t tol)   {tolerance_ = tol;}
+    // the first Krylov vector. a random vector by default.
+    void set_start(const vector_type& v)   {start_ = v;}
+
+    // number of restarts and of operator applications of the last solve
+    std::size_t num_restart() const {return num_restart_;}
+    std::size_t num_product() const {return num_product_;}
+
+    static operator_type matrix_operator(const matrix_type& mat);
+
+  private:
+
+    std::vector<eigenpair_type> solve(const bool largest);
+
+  private:
+
+    std::size_t   n_;
+    std::size_t   k_;
+    std::size_t   subspace_;
+    elem_t        tolerance_;
+    std::size_t   num_restart_;
+    std::size_t   num_product_;
+    vector_type   start_;
+    operator_type op_;
+};
+
+template <typename T_elem>
+typename Lanczos<Matrix<T_elem, DYNAMIC, DYNAMIC>>::operator_type
+Lanczos<Matrix<T_elem, DYNAMIC, DYNAMIC>>::matrix_operator(const matrix_type& mat)
+{
+    const matrix_type* const ptr = &mat;
+    return [ptr](const vector_type& x, vector_type& y)
+    {
+        const std::size_t n = dimension_row(*ptr);
+        detail::gemv<elem_t>(n, n, elem_t(1), ptr->data(), ptr->stride(),
+                             x.data(), elem_t(0), y.data());
+    };
+}
+
+template <typename T_elem>
+std::vector<typename Lanczos<Matrix<T_elem, DYNAMIC, DYNAMIC>>::eigenpair_type>
+Lanczos<Matrix<T_elem, DYNAMIC, DYNAMIC>>::solve(const bool largest)
+{
+    const std::size_t n = n_;
+    const std::size_t k = k_;
+    num_restart_ = 0;
+    num_product_ = 0;
+    if(k == 0) return std::vector<eigenpair_type>();
+
+    std::size_t m = (subspace_ != 0) ? subspace_ : std::max(2 * k + 1, k + 20);
+    m = std::min(std::max(m, k + 1), n);
+    const elem_t eps = std::numeric_limits<elem_t>::epsilon();
+
+    // rows 0..m-1 are the basis, row m the next Krylov vector
+    matrix_type V(m + 1, n);
+    std::vector<elem_t> H(m * m), h(m + 1), h2(m + 1);
+    vector_type x(n), y(n);
+
+    std::mt19937 rng(5489u);
+    std::uniform_real_distribution<elem_t> uniform(-1e0, 1e0);
+    auto random_row = [&](const std::size_t i)
+    {
+        for(std::size_t c=0; c<n; ++c) V(i, c) = uniform(rng);
+    };
+    // w = row j of V, orthogonalized against rows 0..j-1 twice (CGS2);
+    // h = projections removed. returns |w|.
+    auto orthogonalize = [&](const std::size_t j) -> elem_t
+    {
+        elem_t* const w = V.data() + j * n;
+        std::fill(h.begin(), h.end(), elem_t(0));
+        for(std::size_t pass=0; pass<2 && j != 0; ++pass)
+        {
+            detail::gemv<elem_t>(j, n, elem_t(1), V.data(), n, w,
+                                 elem_t(0), h2.data());
+            detail::gemv_trans<elem_t>(j, n, elem_t(-1), V.data(), n,
+                                       h2.data(), elem_t(1), w);
+            for(std::size_t i=0; i<j; ++i) h[i] += h2[i];
+        }
+        elem_t norm(0);
+        for(std::size_t c=0; c<n; ++c) norm += w[c] * w[c];
+        return std::sqrt(norm);
+    };
+    auto normalize_row = [&](const std::size_t i, const elem_t norm)
+    {
+        const elem_t rcp = elem_t(1) / norm;
+        for(std::size_t c=0; c<n; ++c) V(i, c) *= rcp;
+    };
+
+    if(dimension(start_) == n)
+        for(std::size_t c=0; c<n; ++c) V(0, c) = start_[c];
+    else
+        random_row(0);
+    elem_t norm0 = orthogonalize(0);
+    while(norm0 == elem_t(0)){random_row(0); norm0 = orthogonalize(0);}
+    normalize_row(0, norm0);
+
+    std::size_t p = 0; // Ritz vectors kept from the last restart
+    elem_t beta(0);
+    std::vector<std::size_t> wanted(m);
+    while(true)
+    {
+        for(std::size_t j=p; j<m; ++j)
+        {
+            for(std::size_t c=0; c<n; ++c) x[c] = V(j, c);
+            op_(x, y);
+            ++num_product_;
+            const elem_t ynorm = std::sqrt(dot_prod(y, y));
+            for(std::size_t c=0; c<n; ++c) V(j+1, c) = y[c];
+
+            beta = orthogonalize(j + 1);
+            for(std::size_t i=0; i<=j; ++i) H[i * m + j] = H[j * m + i] = h[i];
+
+            // an invariant subspace: continue with any new direction
+            if(beta <= 64 * eps * ynorm)
+            {
+                beta = elem_t(0);
+                if(j + 1 == m) break;
+                elem_t norm(0);
+                while(norm == elem_t(0))
+                {
+                    random_row(j + 1);
+                    norm = orthogonalize(j + 1);
+                }
+                normalize_row(j + 1, norm);
+            }
+            else
+                normalize_row(j + 1, beta);
+        }
+
+        // Ritz pairs of the projected matrix, the wanted end first
+        matrix_type Hm(m, m);
+        for(std::size_t i=0; i<m; ++i)
+            for(std::size_t j=0; j<m; ++j) Hm(i, j) = H[i * m + j];
+        const auto ritz = HouseholderQL<matrix_type>(Hm).solve();
+        for(std::size_t i=0; i<m; ++i) wanted[i] = largest ? m - 1 - i : i;
+
+        elem_t theta_max(0);
+        for(std::size_t i=0; i<m; ++i)
+            theta_max = std::max(theta_max, std::abs(ritz[i].first));
+        const elem_t floor = std::pow(eps, elem_t(2) / 3) * theta_max;
+        bool converged = true;
+        for(std::size_t i=0; i<k && converged; ++i)
+        {
+            const eigenpair_type& r = ritz[wanted[i]];
+            converged = std::abs(beta * r.second[m-1]) <=
+                        tolerance_ * std::max(std::abs(r.first), floor);
+        }
+        const std::size_t keep = converged ? k : (m + k) / 2;
+
+        // rows 0..keep-1 of V become the Ritz vectors, row keep the residual
+        matrix_type Yt(keep, m), X(keep, n);
+        for(std::size_t i=0; i<keep; ++i)
+            for(std::size_t j=0; j<m; ++j) Yt(i, j) = ritz[wanted[i]].second[j];
+        detail::gemm<elem_t>(keep, n, m, elem_t(1), Yt.data(), Yt.stride(), 1,
+                             V.data(), n, 1, elem_t(0), X.data(), X.stride());
+
+        if(converged)
+        {
+            std::vector<eigenpair_type> retval;
+            retval.reserve(k);
+            for(std::size_t i=0; i<k; ++i)
+            {
+                vector_type evec(n);
+                for(std::size_t c=0; c<n; ++c) evec[c] = X(i, c);
+                retval.push_back(std::make_pair(ritz[wanted[i]].first, std::move(evec)));
+            }
+            return retval;
+        }
+        if(num_restart_ == MAX_RESTART)
+            throw std::runtime_error("Lanczos: no convergence");
+        ++num_restart_;
+
+        std::copy(X.data(), X.data() + keep * n, V.data());
+        std::copy(V.data() + m * n, V.data() + (m + 1) * n, V.data() + keep * n);
+        std::fill(H.begin(), H.end(), elem_t(0));
+        for(std::size_t i=0; i<keep; ++i) H[i * m + i] = ritz[wanted[i]].first;
+        p = keep;
+    }
+}
+
+// helper functions. mat is not copied.
+template<typename T_mat, typename std::enable_if<
+    is_matrix_type<typename T_mat::tag>::value&&
+    is_dynamic_dimension<T_mat::dim_row>::value&&
+    is_dynamic_dimension<T_mat::dim_col>::value>::type*& = enabler>
+std::vector<typename Lanczos<T_mat>::eigenpair_type>
+eigen_largest(const T_mat& mat, const std::size_t k)
+{
+    return Lanczos<T_mat>(mat, k).largest();
+}
+
+template<typename T_mat, typename std::enable_if<
+    is_matrix_type<typename T_mat::tag>::value&&
+    is_dynamic_dimension<T_mat::dim_row>::value&&
+    is_dynamic_dimension<T_mat::dim_col>::value>::type*& = enabler>
+std::vector<typename Lanczos<T_mat>::eigenpair_type>
+eigen_smallest(const T_mat& mat, const std::size_t k)
+{
+    return Lanczos<T_mat>(mat, k).smallest();
+}
+
+}//ax
+
+#endif //AX_LANCZOS_H
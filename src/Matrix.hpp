@@ -1,8 +1,11 @@
 #ifndef AX_MATRIX_H
 #define AX_MATRIX_H
+#include <algorithm>
+#include <stdexcept>
 #include <array>
 #include <iostream>
-#include "MatrixExpression.hpp"
+#include "MatrixAssignment.hpp"
+#include "NoAlias.hpp"
 
 namespace ax
 {
@@ -27,19 +30,28 @@ class Matrix
     using self_type = Matrix<elem_t, dim_row, dim_col>;
     // {{col_vec}, {col_vec}, ... }
 
+    // the elements are held row by row in one flat array, so that data()
+    // addresses all of them, like the contiguous dynamic storage
+    using storage_type = std::array<elem_t, dim_row * dim_col>;
+
   public:
 
-    Matrix() : values_{{{}}}{}
+    Matrix() : values_{{}}{}
     ~Matrix() = default;
 
     Matrix(const self_type& mat) : values_(mat.values_){};
     Matrix(self_type&& mat): values_(std::move(mat.values_)){}
-    Matrix(const container_type& val) : values_(val){}
+    Matrix(const container_type& val)
+    {
+        for(std::size_t i(0); i<dim_row; ++i)
+            std::copy(val[i].begin(), val[i].end(), values_.begin() + i * dim_col);
+    }
 
     // to make Identity matrix
-    Matrix(const elem_t d) : values_{{{}}}
+    Matrix(const elem_t d) : values_{{}}
     {
-        for(std::size_t i(0); i<dim_row; ++i) values_[i][i] = d;
+        const std::size_t dim = (dim_row < dim_col) ? dim_row : dim_col;
+        for(std::size_t i(0); i<dim; ++i) values_[i * dim_col + i] = d;
     }
 
     template<class T_expr, typename std::enable_if<
@@ -48,9 +60,7 @@ class Matrix
         is_same_dimension<T_expr::dim_row, dim_row>::value>::type*& = enabler>
     Matrix(const T_expr& mat)
     {
-         for(std::size_t i(0); i<dim_row; ++i)
-            for(std::size_t j(0); j<dim_col; ++j)
-                values_[i][j] = mat(i, j);
+        detail::assign_matrix(*this, mat);
     }
 
     template<class T_expr, typename std::enable_if<
@@ -62,9 +72,7 @@ class Matrix
         if(dimension_col(mat) != dim_col)
             throw std::invalid_argument("matrix size different");
 
-        for(std::size_t i(0); i<dim_row; ++i)
-            for(std::size_t j(0); j<dim_col; ++j)
-                values_[i][j] = mat(i, j);
+        detail::assign_matrix(*this, mat);
     }
 
     template<class T_expr, typename std::enable_if<
@@ -76,9 +84,7 @@ class Matrix
         if(dimension_row(mat) != dim_row)
             throw std::invalid_argument("matrix size different");
 
-        for(std::size_t i(0); i<dim_row; ++i)
-            for(std::size_t j(0); j<dim_col; ++j)
-                values_[i][j] = mat(i, j);
+        detail::assign_matrix(*this, mat);
     }
 
     template<class T_expr, typename std::enable_if<
@@ -90,9 +96,7 @@ class Matrix
         if(dimension_row(mat) != dim_row || dimension_col(mat) != dim_col)
             throw std::invalid_argument("matrix size different");
 
-        for(std::size_t i(0); i<dim_row; ++i)
-            for(std::size_t j(0); j<dim_col; ++j)
-                values_[i][j] = mat(i, j);
+        detail::assign_matrix(*this, mat);
     }
 
     // ~~~~~~~~~~~~~~~~~~~~~ operator ~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -108,9 +112,9 @@ class Matrix
         is_same_dimension<T_expr::dim_row, dim_row>::value>::type*& = enabler>
     self_type& operator=(const T_expr& expr)
     {
-        for(std::size_t i(0); i<dim_row; ++i)
-            for(std::size_t j(0); j<dim_col; ++j)
-               (*this)(i,j) = expr(i,j);
+        if(detail::alias_hazard(expr, this))
+            return detail::assign_aliased(*this, expr);
+        detail::assign_matrix(*this, expr);
         return *this;
     }
 
@@ -120,7 +124,8 @@ class Matrix
         is_same_dimension<T_expr::dim_row, dim_row>::value>::type*& = enabler>
     self_type& operator+=(const T_expr& mat)
     {
-        return *this = (*this + mat);
+        detail::update_matrix<detail::Add_Operator<elem_t, elem_t>>(*this, mat);
+        return *this;
     }
 
     template<class T_expr, typename std::enable_if<
@@ -129,7 +134,8 @@ class Matrix
         is_same_dimension<T_expr::dim_row, dim_row>::value>::type*& = enabler>
     self_type& operator-=(const T_expr& mat)
     {
-        return *this = (*this - mat);
+        detail::update_matrix<detail::Subtract_Operator<elem_t, elem_t>>(*this, mat);
+        return *this;
     }
 
     //operator*= can be used in the case of same size matrix
@@ -145,42 +151,64 @@ class Matrix
 
     self_type& operator*=(const elem_t rhs)
     {
-        return *this = (*this * rhs);
+        detail::update_matrix_scalar<detail::Multiply_Operator<elem_t, elem_t>>(*this, rhs);
+        return *this;
     }
 
     self_type& operator/=(const elem_t rhs)
     {
-        return *this = (*this / rhs);
+        detail::update_matrix_scalar<detail::Divide_Operator<elem_t, elem_t>>(*this, rhs);
+        return *this;
     }
 
     elem_t const& operator()(const std::size_t i, const std::size_t j) const
     {
 #ifdef AX_PARANOIAC
-        return this->values_.at(i).at(j);
+        return this->at(i, j);
 #else
-        return this->values_[i][j];
+        return this->values_[i * dim_col + j];
 #endif
     }
     elem_t&       operator()(const std::size_t i, const std::size_t j)
     {
 #ifdef AX_PARANOIAC
-        return this->values_.at(i).at(j);
+        return this->at(i, j);
 #else
-        return this->values_[i][j];
+        return this->values_[i * dim_col + j];
 #endif
     }
     elem_t const& at(const std::size_t i, const std::size_t j) const
     {
-        return this->values_.at(i).at(j);
+        if(i >= dim_row || j >= dim_col)
+            throw std::out_of_range("ax::Matrix::at: index out of range");
+        return this->values_[i * dim_col + j];
     }
     elem_t&       at(const std::size_t i, const std::size_t j)
     {
-        return this->values_.at(i).at(j);
+        if(i >= dim_row || j >= dim_col)
+            throw std::out_of_range("ax::Matrix::at: index out of range");
+        return this->values_[i * dim_col + j];
+    }
+
+    std::size_t size_row() const {return dim_row;}
+    std::size_t size_col() const {return dim_col;}
+
+    // same layout as the dynamic matrices: (i, j) is at data()[i * stride() + j]
+    constexpr static std::size_t stride() {return dim_col;}
+
+    elem_t const* data() const {return this->values_.data();}
+    elem_t*       data()       {return this->values_.data();}
+
+    // row-major elements i, i+1, ... as one SIMD packet
+    constexpr static bool packet_access = true;
+    typename detail::packet_traits<elem_t>::type packet(const std::size_t i) const
+    {
+        return detail::packet_traits<elem_t>::load(this->data() + i);
     }
 
   private:
 
-    container_type values_;
+    storage_type values_;
 };
 
 
@@ -0,0 +1,250 @@
+#ifndef AX_MATRIX3_BATCH_H
+#define AX_MATRIX3_BATCH_H
+#include "Matrix.hpp"
+#include "Packet.hpp"
+#include "AlignedAllocator.hpp"
+#include <vector>
+#include <limits>
+
+namespace ax
+{
+
+// N 3x3 matrices in structure of arrays layout: the (i, j) elements of all
+// the matrices are contiguous, so that one packet holds the same element of
+// packet_traits<T>::size matrices. the storage of every component is padded
+// with zero matrices up to a multiple of the packet size.
+template<typename T_elem>
+class Matrix3Batch
+{
+  public:
+
+    using elem_t = T_elem;
+    using matrix_type = Matrix<elem_t, 3, 3>;
+    using container_type = std::vector<elem_t, aligned_allocator<elem_t>>;
+    constexpr static std::size_t lanes = detail::packet_traits<elem_t>::size;
+
+    Matrix3Batch(): size_(0), stride_(0){}
+    explicit Matrix3Batch(const std::size_t n)
+        : size_(n), stride_((n + lanes - 1) / lanes * lanes),
+          values_(9 * stride_, elem_t(0))
+    {}
+    ~Matrix3Batch() = default;
+
+    Matrix3Batch(const Matrix3Batch&) = default;
+    Matrix3Batch(Matrix3Batch&&) = default;
+    Matrix3Batch& operator=(const Matrix3Batch&) = default;
+    Matrix3Batch& operator=(Matrix3Batch&&) = default;
+
+    // number of matrices, and of elements per component including padding
+    std::size_t size()   const noexcept {return size_;}
+    std::size_t stride() const noexcept {return stride_;}
+
+    // (i, j) element of the k-th matrix
+    elem_t& operator()(const std::size_t k, const std::size_t i, const std::size_t j)
+    {return values_[(i * 3 + j) * stride_ + k];}
+    elem_t const& operator()(const std::size_t k, const std::size_t i, const std::size_t j) const
+    {return values_[(i * 3 + j) * stride_ + k];}
+
+    // (i, j) elements of all the matrices
+    elem_t*       component(const std::size_t i, const std::size_t j)
+    {return values_.data() + (i * 3 + j) * stride_;}
+    elem_t const* component(const std::size_t i, const std::size_t j) const
+    {return values_.data() + (i * 3 + j) * stride_;}
+
+    matrix_type matrix(const std::size_t k) const
+    {
+        matrix_type retval;
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+                retval(i, j) = (*this)(k, i, j);
+        return retval;
+    }
+
+    template<class T_mat, typename std::enable_if<
+        is_matrix_expression<typename T_mat::tag>::value&&
+        is_same_dimension<T_mat::dim_row, 3>::value&&
+        is_same_dimension<T_mat::dim_col, 3>::value>::type*& = enabler>
+    void set(const std::size_t k, const T_mat& mat)
+    {
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+                (*this)(k, i, j) = mat(i, j);
+        return;
+    }
+
+  private:
+
+    std::size_t    size_;
+    std::size_t    stride_;
+    container_type values_;
+};
+
+namespace detail
+{
+
+// the nine elements of packet_traits<T>::size matrices starting at k
+template<typename T_elem>
+struct matrix3_packet
+{
+    using traits = packet_traits<T_elem>;
+    using packet = typename traits::type;
+
+    matrix3_packet(const Matrix3Batch<T_elem>& mats, const std::size_t k)
+        : a00(traits::load(mats.component(0, 0) + k)),
+          a01(traits::load(mats.component(0, 1) + k)),
+          a02(traits::load(mats.component(0, 2) + k)),
+          a10(traits::load(mats.component(1, 0) + k)),
+          a11(traits::load(mats.component(1, 1) + k)),
+          a12(traits::load(mats.component(1, 2) + k)),
+          a20(traits::load(mats.component(2, 0) + k)),
+          a21(traits::load(mats.component(2, 1) + k)),
+          a22(traits::load(mats.component(2, 2) + k))
+    {}
+
+    // l * r - s * t
+    static packet cross(const packet& l, const packet& r,
+                        const packet& s, const packet& t)
+    {
+        return packet_sub(packet_mul(l, r), packet_mul(s, t));
+    }
+
+    packet a00, a01, a02, a10, a11, a12, a20, a21, a22;
+};
+
+template<typename T_elem>
+void batch_determinant(const Matrix3Batch<T_elem>& mats, std::vector<T_elem>& det)
+{
+    using traits = detail::packet_traits<T_elem>;
+    using packet = typename traits::type;
+    using mat3   = detail::matrix3_packet<T_elem>;
+
+    det.resize(mats.stride());
+    for(std::size_t k=0; k<mats.stride(); k+=traits::size)
+    {
+        const mat3 a(mats, k);
+        const packet d = packet_add(packet_add(
+            packet_mul(a.a00, mat3::cross(a.a11, a.a22, a.a12, a.a21)),
+            packet_mul(a.a01, mat3::cross(a.a12, a.a20, a.a10, a.a22))),
+            packet_mul(a.a02, mat3::cross(a.a10, a.a21, a.a11, a.a20)));
+        traits::store(det.data() + k, d);
+    }
+    det.resize(mats.size());
+    return;
+}
+
+// a matrix is singular if |det| <= threshold. if relative, threshold is
+// scaled by ||row0|| ||row1|| ||row2||, the upper bound of |det|, in each lane.
+template<typename T_elem>
+std::size_t batch_inverse(const Matrix3Batch<T_elem>& mats, Matrix3Batch<T_elem>& inv,
+                          std::vector<bool>& singular, const T_elem threshold,
+                          const bool relative)
+{
+    using traits = detail::packet_traits<T_elem>;
+    using packet = typename traits::type;
+    using mat3   = detail::matrix3_packet<T_elem>;
+    constexpr std::size_t lanes = traits::size;
+
+    if(inv.size() != mats.size()) inv = Matrix3Batch<T_elem>(mats.size());
+    singular.assign(mats.size(), false);
+
+    const packet zero = traits::broadcast(T_elem(0));
+    const packet one  = traits::broadcast(T_elem(1));
+    const packet thr  = traits::broadcast(threshold);
+    constexpr int regular_lanes = (1 << lanes) - 1;
+
+    std::size_t num_singular = 0;
+    for(std::size_t k=0; k<mats.stride(); k+=lanes)
+    {
+        const mat3 a(mats, k);
+        const packet c00 = mat3::cross(a.a11, a.a22, a.a12, a.a21);
+        const packet c01 = mat3::cross(a.a12, a.a20, a.a10, a.a22);
+        const packet c02 = mat3::cross(a.a10, a.a21, a.a11, a.a20);
+        const packet det = packet_add(packet_add(packet_mul(a.a00, c00),
+                           packet_mul(a.a01, c01)), packet_mul(a.a02, c02));
+
+        packet bound = thr;
+        if(relative)
+        {
+            const packet r0 = packet_add(packet_add(packet_mul(a.a00, a.a00),
+                packet_mul(a.a01, a.a01)), packet_mul(a.a02, a.a02));
+            const packet r1 = packet_add(packet_add(packet_mul(a.a10, a.a10),
+                packet_mul(a.a11, a.a11)), packet_mul(a.a12, a.a12));
+            const packet r2 = packet_add(packet_add(packet_mul(a.a20, a.a20),
+                packet_mul(a.a21, a.a21)), packet_mul(a.a22, a.a22));
+            bound = packet_mul(thr, packet_mul(packet_mul(packet_sqrt(r0),
+                packet_sqrt(r1)), packet_sqrt(r2)));
+        }
+
+        // 1 / det for the regular lanes and 0 for the singular ones. the
+        // singular lanes divide 1 by 1, not by their determinant.
+        const packet absdet = packet_abs(det);
+        const packet r = packet_select_greater(absdet, bound,
+            packet_div(one, packet_select_greater(absdet, bound, det, one)), zero);
+
+        const int regular = packet_greater_mask(absdet, bound);
+        if(regular != regular_lanes)
+        {
+            for(std::size_t l=0; l<lanes && k + l < mats.size(); ++l)
+            {
+                if((regular >> l) & 1) continue;
+                singular[k + l] = true;
+                ++num_singular;
+            }
+        }
+
+        traits::store(inv.component(0, 0) + k, packet_mul(r, c00));
+        traits::store(inv.component(0, 1) + k,
+                packet_mul(r, mat3::cross(a.a02, a.a21, a.a01, a.a22)));
+        traits::store(inv.component(0, 2) + k,
+                packet_mul(r, mat3::cross(a.a01, a.a12, a.a02, a.a11)));
+        traits::store(inv.component(1, 0) + k, packet_mul(r, c01));
+        traits::store(inv.component(1, 1) + k,
+                packet_mul(r, mat3::cross(a.a00, a.a22, a.a02, a.a20)));
+        traits::store(inv.component(1, 2) + k,
+                packet_mul(r, mat3::cross(a.a02, a.a10, a.a00, a.a12)));
+        traits::store(inv.component(2, 0) + k, packet_mul(r, c02));
+        traits::store(inv.component(2, 1) + k,
+                packet_mul(r, mat3::cross(a.a01, a.a20, a.a00, a.a21)));
+        traits::store(inv.component(2, 2) + k,
+                packet_mul(r, mat3::cross(a.a00, a.a11, a.a01, a.a10)));
+    }
+    return num_singular;
+}
+
+}// detail
+
+// det[k] = det(mats.matrix(k)) for every matrix of the batch
+template<typename T_elem>
+inline void determinant(const Matrix3Batch<T_elem>& mats, std::vector<T_elem>& det)
+{
+    detail::batch_determinant(mats, det);
+    return;
+}
+
+// inv.matrix(k) = mats.matrix(k)^-1 for every matrix of the batch. a matrix
+// whose |det| is not larger than 64 eps ||row0|| ||row1|| ||row2|| is flagged
+// in singular and its inverse is set to zero instead of dividing by its
+// determinant. the bound is relative, so that the rounding error of the
+// determinant of a singular matrix (e.g. with FMA contraction) is flagged too.
+// returns the number of singular matrices.
+template<typename T_elem>
+inline std::size_t
+inverse(const Matrix3Batch<T_elem>& mats, Matrix3Batch<T_elem>& inv,
+        std::vector<bool>& singular)
+{
+    return detail::batch_inverse(mats, inv, singular,
+            64 * std::numeric_limits<T_elem>::epsilon(), true);
+}
+
+// same as above, but with an absolute bound: a matrix is flagged if
+// |det| <= threshold.
+template<typename T_elem>
+inline std::size_t
+inverse(const Matrix3Batch<T_elem>& mats, Matrix3Batch<T_elem>& inv,
+        std::vector<bool>& singular, const T_elem threshold)
+{
+    return detail::batch_inverse(mats, inv, singular, threshold, false);
+}
+
+}// ax
+#endif /* AX_MATRIX3_BATCH_H */
@@ -0,0 +1,260 @@
+#ifndef AX_MATRIX_ASSIGNMENT_H
+#define AX_MATRIX_ASSIGNMENT_H
+#include "MatrixExpression.hpp"
+#include "GEMM.hpp"
+#include "VectorAssignment.hpp"
+
+namespace ax
+{
+
+namespace detail
+{
+
+// a concrete matrix (or a transposed one) seen as a strided buffer.
+// element (i, j) is at ptr[i * row_stride + j * col_stride].
+template<typename T_elem>
+struct strided_matrix_view
+{
+    const T_elem* ptr;
+    std::size_t   row_stride;
+    std::size_t   col_stride;
+};
+
+template<class T_mat>
+struct has_strided_view
+{
+    constexpr static bool value = is_matrix_type<typename T_mat::tag>::value;
+};
+
+template<class T_mat>
+struct has_strided_view<MatrixTranspose<T_mat>>
+{
+    constexpr static bool value =
+        is_matrix_type<typename stored_operand_type<T_mat>::tag>::value;
+};
+
+template<class T_mat, typename std::enable_if<
+    is_matrix_type<typename T_mat::tag>::value>::type*& = enabler>
+inline strided_matrix_view<typename T_mat::elem_t>
+make_strided_view(const T_mat& mat)
+{
+    return strided_matrix_view<typename T_mat::elem_t>{
+        mat.data(), mat.stride(), 1};
+}
+
+template<class T_mat, typename std::enable_if<
+    is_matrix_type<typename stored_operand_type<T_mat>::tag>::value
+    >::type*& = enabler>
+inline strided_matrix_view<typename T_mat::elem_t>
+make_strided_view(const MatrixTranspose<T_mat>& mat)
+{
+    return strided_matrix_view<typename T_mat::elem_t>{
+        mat.l_.data(), 1, mat.l_.stride()};
+}
+
+// dst must already have the shape of expr.
+template<class T_dst, class T_expr, typename std::enable_if<
+    !is_packet_assignable<T_dst, T_expr>::value>::type*& = enabler>
+inline void assign_elementwise(T_dst& dst, const T_expr& expr)
+{
+    const std::size_t rows = dimension_row(dst);
+    const std::size_t cols = dimension_col(dst);
+    for(std::size_t i=0; i<rows; ++i)
+        for(std::size_t j=0; j<cols; ++j)
+            dst(i, j) = expr(i, j);
+    return;
+}
+
+// every operand shares the row-major layout of dst (stride == columns),
+// so the matrix is processed as one linear array of packets.
+template<class T_dst, class T_expr, typename std::enable_if<
+    is_packet_assignable<T_dst, T_expr>::value>::type*& = enabler>
+inline void assign_elementwise(T_dst& dst, const T_expr& expr)
+{
+    using packet = packet_traits<typename T_dst::elem_t>;
+    const std::size_t cols = dimension_col(dst);
+    const std::size_t size = dimension_row(dst) * cols;
+    typename T_dst::elem_t* const ptr = dst.data();
+
+    std::size_t i=0;
+    for(; i + packet::size <= size; i += packet::size)
+        packet::store(ptr + i, expr.packet(i));
+    for(std::size_t r=size-i; r!=0; --r, ++i)
+        ptr[i] = expr(i / cols, i % cols);
+    return;
+}
+
+// operands are arbitrary expressions. evaluate element by element.
+template<class T_dst, class T_prod>
+inline void assign_product(T_dst& dst, const T_prod& prod, std::false_type)
+{
+    return assign_elementwise(dst, prod);
+}
+
+// both operands are (transposed) concrete matrices. go to the GEMM kernel.
+template<class T_dst, class T_prod>
+inline void assign_product(T_dst& dst, const T_prod& prod, std::true_type)
+{
+    using elem_t = typename T_dst::elem_t;
+    const std::size_t m = dimension_row(dst);
+    const std::size_t n = dimension_col(dst);
+    const std::size_t k = dimension_col(prod.l_);
+    if(m * n * k < AX_GEMM_THRESHOLD)
+        return assign_elementwise(dst, prod);
+
+    const auto lhs = make_strided_view(prod.l_);
+    const auto rhs = make_strided_view(prod.r_);
+    gemm<elem_t>(m, n, k, elem_t(1),
+                 lhs.ptr, lhs.row_stride, lhs.col_stride,
+                 rhs.ptr, rhs.row_stride, rhs.col_stride,
+                 elem_t(0), dst.data(), dst.stride());
+    return;
+}
+
+// evaluate expr into the concrete matrix dst that already has its shape.
+template<class T_dst, class T_expr, typename std::enable_if<
+    !is_exactly_matrix_prod<typename T_expr::tag>::value>::type*& = enabler>
+inline void assign_matrix(T_dst& dst, const T_expr& expr)
+{
+    return assign_elementwise(dst, expr);
+}
+
+template<class T_dst, class T_expr, typename std::enable_if<
+    is_exactly_matrix_prod<typename T_expr::tag>::value>::type*& = enabler>
+inline void assign_matrix(T_dst& dst, const T_expr& expr)
+{
+    using lhs_type = typename std::remove_cv<typename std::remove_reference<
+        decltype(expr.l_)>::type>::type;
+    using rhs_type = typename std::remove_cv<typename std::remove_reference<
+        decltype(expr.r_)>::type>::type;
+
+    return assign_product(dst, expr, std::integral_constant<bool,
+        has_strided_view<lhs_type>::value && has_strided_view<rhs_type>::value &&
+        std::is_same<typename T_dst::elem_t, typename lhs_type::elem_t>::value &&
+        std::is_same<typename T_dst::elem_t, typename rhs_type::elem_t>::value>());
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ in-place update ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// dst(i, j) = T_oper::apply(dst(i, j), expr(i, j)).
+// dst must already have the shape of expr.
+template<class T_oper, class T_dst, class T_expr, typename std::enable_if<
+    !is_packet_assignable<T_dst, T_expr>::value>::type*& = enabler>
+inline void update_elementwise(T_dst& dst, const T_expr& expr)
+{
+    const std::size_t rows = dimension_row(dst);
+    const std::size_t cols = dimension_col(dst);
+    for(std::size_t i=0; i<rows; ++i)
+        for(std::size_t j=0; j<cols; ++j)
+            dst(i, j) = T_oper::apply(dst(i, j), expr(i, j));
+    return;
+}
+
+template<class T_oper, class T_dst, class T_expr, typename std::enable_if<
+    is_packet_assignable<T_dst, T_expr>::value>::type*& = enabler>
+inline void update_elementwise(T_dst& dst, const T_expr& expr)
+{
+    using packet = packet_traits<typename T_dst::elem_t>;
+    const std::size_t cols = dimension_col(dst);
+    const std::size_t size = dimension_row(dst) * cols;
+    typename T_dst::elem_t* const ptr = dst.data();
+
+    std::size_t i=0;
+    for(; i + packet::size <= size; i += packet::size)
+        packet::store(ptr + i, T_oper::apply(packet::load(ptr + i), expr.packet(i)));
+    for(std::size_t r=size-i; r!=0; --r, ++i)
+        ptr[i] = T_oper::apply(ptr[i], expr(i / cols, i % cols));
+    return;
+}
+
+// sign of the GEMM update that implements dst op= A * B
+template<class T_oper>
+struct accumulation_sign;
+
+template<typename T_elem>
+struct accumulation_sign<Add_Operator<T_elem, T_elem>>
+{
+    constexpr static int value = 1;
+};
+
+template<typename T_elem>
+struct accumulation_sign<Subtract_Operator<T_elem, T_elem>>
+{
+    constexpr static int value = -1;
+};
+
+template<class T_oper, class T_dst, class T_prod>
+inline void update_product(T_dst& dst, const T_prod& prod, std::false_type)
+{
+    return update_elementwise<T_oper>(dst, prod);
+}
+
+// dst += A * B or dst -= A * B as one GEMM with beta = 1
+template<class T_oper, class T_dst, class T_prod>
+inline void update_product(T_dst& dst, const T_prod& prod, std::true_type)
+{
+    using elem_t = typename T_dst::elem_t;
+    const std::size_t m = dimension_row(dst);
+    const std::size_t n = dimension_col(dst);
+    const std::size_t k = dimension_col(prod.l_);
+    const auto lhs = make_strided_view(prod.l_);
+    const auto rhs = make_strided_view(prod.r_);
+    if(m * n * k < AX_GEMM_THRESHOLD)
+        return update_elementwise<T_oper>(dst, prod);
+
+    gemm<elem_t>(m, n, k, elem_t(accumulation_sign<T_oper>::value),
+                 lhs.ptr, lhs.row_stride, lhs.col_stride,
+                 rhs.ptr, rhs.row_stride, rhs.col_stride,
+                 elem_t(1), dst.data(), dst.stride());
+    return;
+}
+
+// dst op= expr without building a temporary. T_oper is Add_Operator or
+// Subtract_Operator. expr must not have an alias hazard on dst.
+template<class T_oper, class T_dst, class T_expr, typename std::enable_if<
+    !is_exactly_matrix_prod<typename T_expr::tag>::value>::type*& = enabler>
+inline void update_matrix_noalias(T_dst& dst, const T_expr& expr)
+{
+    return update_elementwise<T_oper>(dst, expr);
+}
+
+template<class T_oper, class T_dst, class T_expr, typename std::enable_if<
+    is_exactly_matrix_prod<typename T_expr::tag>::value>::type*& = enabler>
+inline void update_matrix_noalias(T_dst& dst, const T_expr& expr)
+{
+    using lhs_type = typename std::remove_cv<typename std::remove_reference<
+        decltype(expr.l_)>::type>::type;
+    using rhs_type = typename std::remove_cv<typename std::remove_reference<
+        decltype(expr.r_)>::type>::type;
+
+    return update_product<T_oper>(dst, expr, std::integral_constant<bool,
+        has_strided_view<lhs_type>::value && has_strided_view<rhs_type>::value &&
+        std::is_same<typename T_dst::elem_t, typename lhs_type::elem_t>::value &&
+        std::is_same<typename T_dst::elem_t, typename rhs_type::elem_t>::value>());
+}
+
+// dst op= expr. if expr reads dst out of place (A += A * B), it is
+// evaluated into the scratch buffer before dst is touched.
+template<class T_oper, class T_dst, class T_expr>
+inline void update_matrix(T_dst& dst, const T_expr& expr)
+{
+    if(alias_hazard(expr, std::addressof(dst)))
+    {
+        typename evaluated_type<T_expr>::type& tmp =
+            scratch_buffer<typename evaluated_type<T_expr>::type>();
+        tmp = expr;
+        return update_matrix_noalias<T_oper>(dst, tmp);
+    }
+    return update_matrix_noalias<T_oper>(dst, expr);
+}
+
+// dst(i, j) = T_oper::apply(dst(i, j), scl)
+template<class T_oper, class T_dst>
+inline void update_matrix_scalar(T_dst& dst, const typename T_dst::elem_t scl)
+{
+    return update_linear<T_oper>(dst.data(),
+            dimension_row(dst) * dimension_col(dst), scl);
+}
+
+}// detail
+}// ax
+#endif /* AX_MATRIX_ASSIGNMENT_H */
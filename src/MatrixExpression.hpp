@@ -3,6 +3,8 @@
 #include "TypeTraits.hpp"
 #include "OperatorStructs.hpp"
 #include "Dimension.hpp"
+#include "OperandStorage.hpp"
+#include "Aliasing.hpp"
 #include <utility>
 
 namespace ax
@@ -26,6 +28,12 @@ class MatrixExpression
     constexpr static dimension_type dim_row = I_dim_row;
     constexpr static dimension_type dim_col = I_dim_col;
 
+    using packet_type = typename packet_traits<elem_t>::type;
+    constexpr static bool packet_access =
+        has_packet_access<stored_operand_type<T_lhs>>::value &&
+        has_packet_access<stored_operand_type<T_rhs>>::value &&
+        std::is_same<typename T_lhs::elem_t, typename T_rhs::elem_t>::value;
+
     MatrixExpression(const T_lhs& lhs, const T_rhs& rhs)
         : l_(lhs), r_(rhs)
     {}
@@ -35,8 +43,23 @@ class MatrixExpression
         return T_oper::apply(l_(i,j), r_(i,j));
     }
 
-    T_lhs const& l_;
-    T_rhs const& r_;
+    // i is the index in the row-major storage shared by both operands
+    packet_type packet(const std::size_t i) const
+    {
+        return T_oper::apply(l_.packet(i), r_.packet(i));
+    }
+
+    bool references(const void* p) const
+    {
+        return detail::references(l_, p) || detail::references(r_, p);
+    }
+    bool alias_hazard(const void* p) const
+    {
+        return detail::alias_hazard(l_, p) || detail::alias_hazard(r_, p);
+    }
+
+    typename operand_storage<T_lhs>::type l_;
+    typename operand_storage<T_rhs>::type r_;
 };
 
 template <typename T_lhs, typename T_rhs,
@@ -56,15 +79,25 @@ class MatrixProduct
 
     elem_t operator()(const std::size_t i, const std::size_t j) const
     {
+        const std::size_t inner = dimension_row(r_);
         elem_t retval(0);
-        for(std::size_t k(0); k<dimension_row(r_); ++k)
+        for(std::size_t k(0); k<inner; ++k)
             retval += l_(i,k) * r_(k,j);
 
         return retval;
     }
 
-    T_lhs const& l_;
-    T_rhs const& r_;
+    bool references(const void* p) const
+    {
+        return detail::references(l_, p) || detail::references(r_, p);
+    }
+    bool alias_hazard(const void* p) const
+    {
+        return this->references(p);
+    }
+
+    typename product_operand_storage<T_lhs>::type l_;
+    typename product_operand_storage<T_rhs>::type r_;
 };
 
 template<typename T_mat, typename T_vec, dimension_type I_dim>
@@ -92,8 +125,17 @@ class MatrixVectorProduct
         return retval;
     }
 
-    T_vec const& l_; //XXX: for dimension() function!;
-    T_mat const& r_;
+    bool references(const void* p) const
+    {
+        return detail::references(l_, p) || detail::references(r_, p);
+    }
+    bool alias_hazard(const void* p) const
+    {
+        return this->references(p);
+    }
+
+    typename product_operand_storage<T_vec>::type l_; //XXX: for dimension() function!;
+    typename operand_storage<T_mat>::type         r_;
 };
 
 template<typename T_mat, typename T_vec, dimension_type I_dim>
@@ -121,8 +163,17 @@ class VectorMatrixProduct
         return retval;
     }
 
-    T_vec const& l_;
-    T_mat const& r_;
+    bool references(const void* p) const
+    {
+        return detail::references(l_, p) || detail::references(r_, p);
+    }
+    bool alias_hazard(const void* p) const
+    {
+        return this->references(p);
+    }
+
+    typename product_operand_storage<T_vec>::type l_;
+    typename operand_storage<T_mat>::type         r_;
 };
 
 template<typename T_mat, typename T_oper, typename T_scl>
@@ -140,6 +191,10 @@ class MatrixScalarExpression
     static_assert(is_operator_struct<typename T_oper::tag>::value,
                   "invalid Expression Operator");
 
+    using packet_type = typename packet_traits<elem_t>::type;
+    constexpr static bool packet_access =
+        has_packet_access<stored_operand_type<T_mat>>::value;
+
     MatrixScalarExpression(const T_mat& lhs, const T_scl& rhs)
         : l_(lhs), r_(rhs)
     {}
@@ -149,7 +204,21 @@ class MatrixScalarExpression
         return T_oper::apply(l_(i,j), r_);
     }
 
-    const T_mat& l_;
+    packet_type packet(const std::size_t i) const
+    {
+        return T_oper::apply(l_.packet(i), packet_traits<elem_t>::broadcast(r_));
+    }
+
+    bool references(const void* p) const
+    {
+        return detail::references(l_, p);
+    }
+    bool alias_hazard(const void* p) const
+    {
+        return detail::alias_hazard(l_, p);
+    }
+
+    typename operand_storage<T_mat>::type l_;
     const elem_t r_;
 };
 
@@ -171,7 +240,16 @@ class MatrixTranspose
         return l_(j, i);
     }
 
-    T_mat const& l_;
+    bool references(const void* p) const
+    {
+        return detail::references(l_, p);
+    }
+    bool alias_hazard(const void* p) const
+    {
+        return this->references(p);
+    }
+
+    typename operand_storage<T_mat>::type l_;
 };
 
 template<template<typename T_l, typename T_r> class T_oper,
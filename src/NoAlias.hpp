@@ -0,0 +1,128 @@
+#ifndef AX_NO_ALIAS_H
+#define AX_NO_ALIAS_H
+#include "MatrixAssignment.hpp"
+
+namespace ax
+{
+
+namespace detail
+{
+
+// assignments to a matrix or vector that skip the alias check.
+// the caller guarantees that no operand of the right hand side is the
+// destination, e.g. noalias(C) = A * B.
+template<class T_dst>
+class NoAlias
+{
+  public:
+
+    using elem_t = typename T_dst::elem_t;
+
+    explicit NoAlias(T_dst& dst): dst_(dst){}
+
+    template<class T_expr, typename std::enable_if<
+        is_matrix_expression<typename T_expr::tag>::value&&
+        is_matrix_expression<typename T_dst::tag>::value
+        >::type*& = enabler>
+    T_dst& operator=(const T_expr& expr)
+    {
+        if(!same_shape(expr)) return dst_ = T_dst(expr);
+        assign_matrix(dst_, expr);
+        return dst_;
+    }
+
+    template<class T_expr, typename std::enable_if<
+        is_vector_expression<typename T_expr::tag>::value&&
+        is_vector_expression<typename T_dst::tag>::value
+        >::type*& = enabler>
+    T_dst& operator=(const T_expr& expr)
+    {
+        if(!same_shape(expr)) return dst_ = T_dst(expr);
+        assign_vector(dst_, expr);
+        return dst_;
+    }
+
+    template<class T_expr, typename std::enable_if<
+        is_matrix_expression<typename T_expr::tag>::value&&
+        is_matrix_expression<typename T_dst::tag>::value
+        >::type*& = enabler>
+    T_dst& operator+=(const T_expr& expr)
+    {
+        if(!same_shape(expr))
+            throw std::invalid_argument("matrix size different");
+        update_matrix_noalias<Add_Operator<elem_t, elem_t>>(dst_, expr);
+        return dst_;
+    }
+
+    template<class T_expr, typename std::enable_if<
+        is_matrix_expression<typename T_expr::tag>::value&&
+        is_matrix_expression<typename T_dst::tag>::value
+        >::type*& = enabler>
+    T_dst& operator-=(const T_expr& expr)
+    {
+        if(!same_shape(expr))
+            throw std::invalid_argument("matrix size different");
+        update_matrix_noalias<Subtract_Operator<elem_t, elem_t>>(dst_, expr);
+        return dst_;
+    }
+
+    template<class T_expr, typename std::enable_if<
+        is_vector_expression<typename T_expr::tag>::value&&
+        is_vector_expression<typename T_dst::tag>::value
+        >::type*& = enabler>
+    T_dst& operator+=(const T_expr& expr)
+    {
+        if(!same_shape(expr))
+            throw std::invalid_argument("vector size different");
+        update_vector_elementwise<Add_Operator<elem_t, elem_t>>(dst_, expr);
+        return dst_;
+    }
+
+    template<class T_expr, typename std::enable_if<
+        is_vector_expression<typename T_expr::tag>::value&&
+        is_vector_expression<typename T_dst::tag>::value
+        >::type*& = enabler>
+    T_dst& operator-=(const T_expr& expr)
+    {
+        if(!same_shape(expr))
+            throw std::invalid_argument("vector size different");
+        update_vector_elementwise<Subtract_Operator<elem_t, elem_t>>(dst_, expr);
+        return dst_;
+    }
+
+  private:
+
+    template<class T_expr, typename std::enable_if<
+        is_matrix_expression<typename T_expr::tag>::value>::type*& = enabler>
+    bool same_shape(const T_expr& expr) const
+    {
+        return dimension_row(dst_) == dimension_row(expr) &&
+               dimension_col(dst_) == dimension_col(expr);
+    }
+
+    template<class T_expr, typename std::enable_if<
+        is_vector_expression<typename T_expr::tag>::value>::type*& = enabler>
+    bool same_shape(const T_expr& expr) const
+    {
+        return dimension(dst_) == dimension(expr);
+    }
+
+  private:
+
+    T_dst& dst_;
+};
+
+}// detail
+
+// noalias(dst) = expr evaluates expr directly into dst without checking
+// whether expr reads dst. on a shape mismatch dst is rebuilt from expr.
+template<class T_dst, typename std::enable_if<
+    is_matrix_type<typename T_dst::tag>::value ||
+    is_vector_type<typename T_dst::tag>::value>::type*& = enabler>
+inline detail::NoAlias<T_dst> noalias(T_dst& dst)
+{
+    return detail::NoAlias<T_dst>(dst);
+}
+
+}// ax
+#endif /* AX_NO_ALIAS_H */
@@ -0,0 +1,109 @@
+#ifndef AX_OPERAND_STORAGE_H
+#define AX_OPERAND_STORAGE_H
+#include "TypeTraits.hpp"
+
+namespace ax
+{
+
+template<typename T_elem, dimension_type I_dim>
+class Vector;
+
+template<typename T_elem, dimension_type I_row, dimension_type I_col>
+class Matrix;
+
+namespace detail
+{
+
+template<typename T_mat, typename T_vec, dimension_type I_dim>
+class MatrixVectorProduct;
+
+template<typename T_mat, typename T_vec, dimension_type I_dim>
+class VectorMatrixProduct;
+
+template<typename T_mat>
+class MatrixTranspose;
+
+// nodes that compute each of their elements as an inner product
+template<typename T_expr>
+struct is_product_expression
+{
+    constexpr static bool value =
+        is_exactly_matrix_prod<typename T_expr::tag>::value;
+};
+
+template<typename T_mat, typename T_vec, dimension_type I_dim>
+struct is_product_expression<MatrixVectorProduct<T_mat, T_vec, I_dim>>
+{
+    constexpr static bool value = true;
+};
+
+template<typename T_mat, typename T_vec, dimension_type I_dim>
+struct is_product_expression<VectorMatrixProduct<T_mat, T_vec, I_dim>>
+{
+    constexpr static bool value = true;
+};
+
+// a concrete Matrix or Vector owned by the user
+template<typename T_expr>
+struct is_concrete_operand
+{
+    constexpr static bool value =
+        is_matrix_type<typename T_expr::tag>::value ||
+        is_vector_type<typename T_expr::tag>::value;
+};
+
+// concrete type that can hold the value of an expression
+template<typename T_expr,
+         bool is_matrix = is_matrix_expression<typename T_expr::tag>::value>
+struct evaluated_type
+{
+    using type = Matrix<typename T_expr::elem_t, T_expr::dim_row, T_expr::dim_col>;
+};
+
+template<typename T_expr>
+struct evaluated_type<T_expr, false>
+{
+    using type = Vector<typename T_expr::elem_t, T_expr::dim>;
+};
+
+// how an expression node holds its operand.
+//  - a concrete matrix or vector is referenced. the user owns it.
+//  - a product node is evaluated once into a temporary held by value.
+//  - any other node is held by value. nodes are only a few references
+//    large, and a copy stays valid after the full-expression ends.
+template<typename T_expr>
+struct operand_storage
+{
+    using type = typename std::conditional<is_concrete_operand<T_expr>::value,
+        const T_expr&, typename std::conditional<
+            is_product_expression<T_expr>::value,
+            const typename evaluated_type<T_expr>::type,
+            const T_expr>::type>::type;
+};
+
+// every element of a product operand is read many times. anything that
+// is not a (transposed) concrete matrix or vector is evaluated once, so
+// that reading it is cheap and the GEMM kernel can be used.
+template<typename T_expr>
+struct product_operand_storage
+{
+    using type = typename std::conditional<is_concrete_operand<T_expr>::value,
+        const T_expr&, const typename evaluated_type<T_expr>::type>::type;
+};
+
+template<typename T_mat>
+struct product_operand_storage<MatrixTranspose<T_mat>>
+{
+    using type = typename std::conditional<is_concrete_operand<T_mat>::value,
+        const MatrixTranspose<T_mat>,
+        const typename evaluated_type<MatrixTranspose<T_mat>>::type>::type;
+};
+
+// type actually held by a node for its operand of type T_expr
+template<typename T_expr>
+using stored_operand_type = typename std::remove_cv<typename std::remove_reference<
+    typename operand_storage<T_expr>::type>::type>::type;
+
+}// detail
+}// ax
+#endif /* AX_OPERAND_STORAGE_H */
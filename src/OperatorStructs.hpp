@@ -1,6 +1,7 @@
 #ifndef AX_OPERATOR_STRUCT_H
 #define AX_OPERATOR_STRUCT_H
 #include "TypeTraits.hpp"
+#include "Packet.hpp"
 
 namespace ax
 {
@@ -14,6 +15,11 @@ struct Add_Operator
     using tag = operator_tag;
     static auto apply(const T_lhs lhs, const T_rhs rhs) -> decltype(lhs + rhs)
     {return lhs + rhs;}
+
+    template<typename T_packet, typename std::enable_if<
+        is_packet<T_packet>::value>::type*& = enabler>
+    static T_packet apply(const T_packet& lhs, const T_packet& rhs)
+    {return packet_add(lhs, rhs);}
 };
 
 template<typename T_lhs, typename T_rhs>
@@ -22,6 +28,11 @@ struct Subtract_Operator
     using tag = operator_tag;
     static auto apply(const T_lhs lhs, const T_rhs rhs) -> decltype(lhs - rhs)
     {return lhs - rhs;}
+
+    template<typename T_packet, typename std::enable_if<
+        is_packet<T_packet>::value>::type*& = enabler>
+    static T_packet apply(const T_packet& lhs, const T_packet& rhs)
+    {return packet_sub(lhs, rhs);}
 };
 
 template<typename T_lhs, typename T_rhs>
@@ -30,6 +41,11 @@ struct Multiply_Operator
     using tag = operator_tag;
     static auto apply(const T_lhs lhs, const T_rhs rhs) -> decltype(lhs * rhs)
     {return lhs * rhs;}
+
+    template<typename T_packet, typename std::enable_if<
+        is_packet<T_packet>::value>::type*& = enabler>
+    static T_packet apply(const T_packet& lhs, const T_packet& rhs)
+    {return packet_mul(lhs, rhs);}
 };
 
 template<typename T_lhs, typename T_rhs>
@@ -38,6 +54,11 @@ struct Divide_Operator
     using tag = operator_tag;
     static auto apply(const T_lhs lhs, const T_rhs rhs) -> decltype(lhs / rhs)
     {return lhs / rhs;}
+
+    template<typename T_packet, typename std::enable_if<
+        is_packet<T_packet>::value>::type*& = enabler>
+    static T_packet apply(const T_packet& lhs, const T_packet& rhs)
+    {return packet_div(lhs, rhs);}
 };
 
 }// detail
@@ -0,0 +1,307 @@
+#ifndef AX_PACKET_H
+#define AX_PACKET_H
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+#include <cmath>
+#if defined(__AVX512F__) || defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ax
+{
+
+namespace detail
+{
+
+/* packet_traits<T>: the widest SIMD register that holds elements of T.
+ *   type      : register type
+ *   size      : number of lanes (1 if there is no SIMD type for T)
+ *   is_simd   : true if type is a SIMD register
+ *   load      : unaligned load of size elements
+ *   store     : unaligned store of size elements
+ *   broadcast : all lanes set to one value
+ *   reduce    : sum of all lanes
+ * arithmetics on packets are the packet_* overloads below. in addition
+ *   packet_sqrt(v), packet_abs(v)      : sqrt(v), |v| in each lane
+ *   packet_greater_mask(l, r)          : bit i is set if l > r in lane i
+ *   packet_select_greater(l, r, a, b)  : l > r ? a : b in each lane
+ * a comparison with NaN is false.                                      */
+template<typename T_elem>
+struct packet_traits
+{
+    using type = T_elem;
+    constexpr static std::size_t size = 1;
+    constexpr static bool is_simd = false;
+
+    static type load(const T_elem* p)           {return *p;}
+    static void store(T_elem* p, const type& v) {*p = v;}
+    static type broadcast(const T_elem v)       {return v;}
+    static T_elem reduce(const type& v)         {return v;}
+};
+
+#if defined(__AVX512F__)
+
+template<>
+struct packet_traits<double>
+{
+    using type = __m512d;
+    constexpr static std::size_t size = 8;
+    constexpr static bool is_simd = true;
+
+    static type load(const double* p)           {return _mm512_loadu_pd(p);}
+    static void store(double* p, const type& v) {_mm512_storeu_pd(p, v);}
+    static type broadcast(const double v)       {return _mm512_set1_pd(v);}
+    static double reduce(const type& v)
+    {
+        // fold the upper half onto the lower one, then as in the AVX case.
+        // the masked extract with an explicit source keeps GCC's
+        // _mm512_undefined_pd() (-Wuninitialized) out of the inlined code
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d h = _mm256_add_pd(
+            _mm512_mask_extractf64x4_pd(zero, 0xF, v, 0),
+            _mm512_mask_extractf64x4_pd(zero, 0xF, v, 1));
+        const __m128d s = _mm_add_pd(_mm256_castpd256_pd128(h),
+                                     _mm256_extractf128_pd(h, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+};
+
+template<>
+struct packet_traits<float>
+{
+    using type = __m512;
+    constexpr static std::size_t size = 16;
+    constexpr static bool is_simd = true;
+
+    static type load(const float* p)           {return _mm512_loadu_ps(p);}
+    static void store(float* p, const type& v) {_mm512_storeu_ps(p, v);}
+    static type broadcast(const float v)       {return _mm512_set1_ps(v);}
+    static float reduce(const type& v)
+    {
+        // extractf32x8 needs AVX512DQ; move the halves as doubles instead
+        const __m512d d = _mm512_castps_pd(v);
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256 h = _mm256_add_ps(
+            _mm256_castpd_ps(_mm512_mask_extractf64x4_pd(zero, 0xF, d, 0)),
+            _mm256_castpd_ps(_mm512_mask_extractf64x4_pd(zero, 0xF, d, 1)));
+        const __m128 s4 = _mm_add_ps(_mm256_castps256_ps128(h),
+                                     _mm256_extractf128_ps(h, 1));
+        const __m128 s2 = _mm_add_ps(s4, _mm_movehl_ps(s4, s4));
+        return _mm_cvtss_f32(_mm_add_ss(s2, _mm_shuffle_ps(s2, s2, 1)));
+    }
+};
+
+inline __m512d packet_add(const __m512d& l, const __m512d& r) {return _mm512_add_pd(l, r);}
+inline __m512d packet_sub(const __m512d& l, const __m512d& r) {return _mm512_sub_pd(l, r);}
+inline __m512d packet_mul(const __m512d& l, const __m512d& r) {return _mm512_mul_pd(l, r);}
+inline __m512d packet_div(const __m512d& l, const __m512d& r) {return _mm512_div_pd(l, r);}
+inline __m512  packet_add(const __m512&  l, const __m512&  r) {return _mm512_add_ps(l, r);}
+inline __m512  packet_sub(const __m512&  l, const __m512&  r) {return _mm512_sub_ps(l, r);}
+inline __m512  packet_mul(const __m512&  l, const __m512&  r) {return _mm512_mul_ps(l, r);}
+inline __m512  packet_div(const __m512&  l, const __m512&  r) {return _mm512_div_ps(l, r);}
+
+// all-lanes masked forms: the plain ones merge into _mm512_undefined_*()
+inline __m512d packet_sqrt(const __m512d& v) {return _mm512_mask_sqrt_pd(v, 0xFF, v);}
+inline __m512  packet_sqrt(const __m512&  v) {return _mm512_mask_sqrt_ps(v, 0xFFFF, v);}
+inline __m512d packet_abs(const __m512d& v) {return _mm512_abs_pd(v);}
+inline __m512  packet_abs(const __m512&  v) {return _mm512_abs_ps(v);}
+inline int packet_greater_mask(const __m512d& l, const __m512d& r)
+{return _mm512_cmp_pd_mask(l, r, _CMP_GT_OQ);}
+inline int packet_greater_mask(const __m512&  l, const __m512&  r)
+{return _mm512_cmp_ps_mask(l, r, _CMP_GT_OQ);}
+inline __m512d packet_select_greater(const __m512d& l, const __m512d& r,
+                                     const __m512d& a, const __m512d& b)
+{return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(l, r, _CMP_GT_OQ), b, a);}
+inline __m512  packet_select_greater(const __m512&  l, const __m512&  r,
+                                     const __m512&  a, const __m512&  b)
+{return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(l, r, _CMP_GT_OQ), b, a);}
+
+#elif defined(__AVX__)
+
+template<>
+struct packet_traits<double>
+{
+    using type = __m256d;
+    constexpr static std::size_t size = 4;
+    constexpr static bool is_simd = true;
+
+    static type load(const double* p)           {return _mm256_loadu_pd(p);}
+    static void store(double* p, const type& v) {_mm256_storeu_pd(p, v);}
+    static type broadcast(const double v)       {return _mm256_set1_pd(v);}
+    static double reduce(const type& v)
+    {
+        const __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v),
+                                     _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+};
+
+template<>
+struct packet_traits<float>
+{
+    using type = __m256;
+    constexpr static std::size_t size = 8;
+    constexpr static bool is_simd = true;
+
+    static type load(const float* p)           {return _mm256_loadu_ps(p);}
+    static void store(float* p, const type& v) {_mm256_storeu_ps(p, v);}
+    static type broadcast(const float v)       {return _mm256_set1_ps(v);}
+    static float reduce(const type& v)
+    {
+        const __m128 s4 = _mm_add_ps(_mm256_castps256_ps128(v),
+                                     _mm256_extractf128_ps(v, 1));
+        const __m128 s2 = _mm_add_ps(s4, _mm_movehl_ps(s4, s4));
+        return _mm_cvtss_f32(_mm_add_ss(s2, _mm_shuffle_ps(s2, s2, 1)));
+    }
+};
+
+inline __m256d packet_add(const __m256d& l, const __m256d& r) {return _mm256_add_pd(l, r);}
+inline __m256d packet_sub(const __m256d& l, const __m256d& r) {return _mm256_sub_pd(l, r);}
+inline __m256d packet_mul(const __m256d& l, const __m256d& r) {return _mm256_mul_pd(l, r);}
+inline __m256d packet_div(const __m256d& l, const __m256d& r) {return _mm256_div_pd(l, r);}
+inline __m256  packet_add(const __m256&  l, const __m256&  r) {return _mm256_add_ps(l, r);}
+inline __m256  packet_sub(const __m256&  l, const __m256&  r) {return _mm256_sub_ps(l, r);}
+inline __m256  packet_mul(const __m256&  l, const __m256&  r) {return _mm256_mul_ps(l, r);}
+inline __m256  packet_div(const __m256&  l, const __m256&  r) {return _mm256_div_ps(l, r);}
+
+inline __m256d packet_sqrt(const __m256d& v) {return _mm256_sqrt_pd(v);}
+inline __m256  packet_sqrt(const __m256&  v) {return _mm256_sqrt_ps(v);}
+inline __m256d packet_abs(const __m256d& v) {return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v);}
+inline __m256  packet_abs(const __m256&  v) {return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);}
+inline int packet_greater_mask(const __m256d& l, const __m256d& r)
+{return _mm256_movemask_pd(_mm256_cmp_pd(l, r, _CMP_GT_OQ));}
+inline int packet_greater_mask(const __m256&  l, const __m256&  r)
+{return _mm256_movemask_ps(_mm256_cmp_ps(l, r, _CMP_GT_OQ));}
+inline __m256d packet_select_greater(const __m256d& l, const __m256d& r,
+                                     const __m256d& a, const __m256d& b)
+{return _mm256_blendv_pd(b, a, _mm256_cmp_pd(l, r, _CMP_GT_OQ));}
+inline __m256  packet_select_greater(const __m256&  l, const __m256&  r,
+                                     const __m256&  a, const __m256&  b)
+{return _mm256_blendv_ps(b, a, _mm256_cmp_ps(l, r, _CMP_GT_OQ));}
+
+#elif defined(__SSE2__)
+
+template<>
+struct packet_traits<double>
+{
+    using type = __m128d;
+    constexpr static std::size_t size = 2;
+    constexpr static bool is_simd = true;
+
+    static type load(const double* p)           {return _mm_loadu_pd(p);}
+    static void store(double* p, const type& v) {_mm_storeu_pd(p, v);}
+    static type broadcast(const double v)       {return _mm_set1_pd(v);}
+    static double reduce(const type& v)
+    {
+        return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+    }
+};
+
+template<>
+struct packet_traits<float>
+{
+    using type = __m128;
+    constexpr static std::size_t size = 4;
+    constexpr static bool is_simd = true;
+
+    static type load(const float* p)           {return _mm_loadu_ps(p);}
+    static void store(float* p, const type& v) {_mm_storeu_ps(p, v);}
+    static type broadcast(const float v)       {return _mm_set1_ps(v);}
+    static float reduce(const type& v)
+    {
+        const __m128 s2 = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_add_ss(s2, _mm_shuffle_ps(s2, s2, 1)));
+    }
+};
+
+inline __m128d packet_add(const __m128d& l, const __m128d& r) {return _mm_add_pd(l, r);}
+inline __m128d packet_sub(const __m128d& l, const __m128d& r) {return _mm_sub_pd(l, r);}
+inline __m128d packet_mul(const __m128d& l, const __m128d& r) {return _mm_mul_pd(l, r);}
+inline __m128d packet_div(const __m128d& l, const __m128d& r) {return _mm_div_pd(l, r);}
+inline __m128  packet_add(const __m128&  l, const __m128&  r) {return _mm_add_ps(l, r);}
+inline __m128  packet_sub(const __m128&  l, const __m128&  r) {return _mm_sub_ps(l, r);}
+inline __m128  packet_mul(const __m128&  l, const __m128&  r) {return _mm_mul_ps(l, r);}
+inline __m128  packet_div(const __m128&  l, const __m128&  r) {return _mm_div_ps(l, r);}
+
+inline __m128d packet_sqrt(const __m128d& v) {return _mm_sqrt_pd(v);}
+inline __m128  packet_sqrt(const __m128&  v) {return _mm_sqrt_ps(v);}
+inline __m128d packet_abs(const __m128d& v) {return _mm_andnot_pd(_mm_set1_pd(-0.0), v);}
+inline __m128  packet_abs(const __m128&  v) {return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);}
+inline int packet_greater_mask(const __m128d& l, const __m128d& r)
+{return _mm_movemask_pd(_mm_cmpgt_pd(l, r));}
+inline int packet_greater_mask(const __m128&  l, const __m128&  r)
+{return _mm_movemask_ps(_mm_cmpgt_ps(l, r));}
+inline __m128d packet_select_greater(const __m128d& l, const __m128d& r,
+                                     const __m128d& a, const __m128d& b)
+{
+    const __m128d m = _mm_cmpgt_pd(l, r);
+    return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+}
+inline __m128  packet_select_greater(const __m128&  l, const __m128&  r,
+                                     const __m128&  a, const __m128&  b)
+{
+    const __m128 m = _mm_cmpgt_ps(l, r);
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+
+#endif
+
+// true for the SIMD register types of packet_traits<double> and <float>.
+// found by overload resolution on packet_traits::type, because naming the
+// vector types as template arguments drops their attributes
+// (-Wignored-attributes).
+template<typename T_elem>
+struct packet_type_test
+{
+    static std::integral_constant<bool, packet_traits<T_elem>::is_simd>
+    test(const typename packet_traits<T_elem>::type&);
+    static std::false_type test(...);
+};
+
+template<typename T>
+struct is_packet : public std::integral_constant<bool,
+    decltype(packet_type_test<double>::test(std::declval<const T&>()))::value ||
+    decltype(packet_type_test<float>::test(std::declval<const T&>()))::value>
+{};
+
+// the same operations on a one-lane "packet", for kernels written against
+// packet_traits<T>::type that have to build without a SIMD type for T.
+template<typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+packet_add(const T& l, const T& r) {return l + r;}
+template<typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+packet_sub(const T& l, const T& r) {return l - r;}
+template<typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+packet_mul(const T& l, const T& r) {return l * r;}
+template<typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+packet_div(const T& l, const T& r) {return l / r;}
+template<typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+packet_sqrt(const T& v) {return std::sqrt(v);}
+template<typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+packet_abs(const T& v) {return v < T(0) ? -v : v;}
+template<typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, int>::type
+packet_greater_mask(const T& l, const T& r) {return l > r ? 1 : 0;}
+template<typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+packet_select_greater(const T& l, const T& r, const T& a, const T& b)
+{return l > r ? a : b;}
+
+// T::packet_access is true if T provides packet(i), a packet of the
+// elements i, i+1, ... in the order of the underlying linear storage.
+template<typename T, typename T_enable = void>
+struct has_packet_access : public std::false_type{};
+
+template<typename T>
+struct has_packet_access<T, typename std::enable_if<T::packet_access>::type>
+    : public std::true_type{};
+
+}// detail
+}// ax
+#endif /* AX_PACKET_H */
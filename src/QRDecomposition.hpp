@@ -0,0 +1,584 @@
+#ifndef AX_QR_DECOMPOSITION_H
+#define AX_QR_DECOMPOSITION_H
+#include "SymmetricEigen.hpp"
+#include "GEMM.hpp"
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <vector>
+#include <cmath>
+
+// number of reflectors in a block of the compact WY form
+#ifndef AX_QR_BLOCK_SIZE
+#define AX_QR_BLOCK_SIZE 32
+#endif
+
+namespace ax
+{
+
+/* Householder QR decomposition A * P = Q * R of an m x n matrix, with
+ * Q = H_0 * H_1 * ... * H_{k-1}, k = min(m, n), and R upper trapezoidal.
+ * the reflectors are kept below the diagonal of R (LAPACK dgeqrf) and
+ * grouped into blocks of AX_QR_BLOCK_SIZE in the compact WY form
+ * I - V * T * V^T (R. Schreiber and C. Van Loan, SIAM J. Sci. Stat. Comput.
+ * 10, 53 (1989)), so that updating the trailing matrix and applying Q or
+ * Q^T are matrix products. Q itself is never formed unless asked for.
+ * without pivoting P = I. with column pivoting the remaining column of the
+ * largest norm is taken next (LAPACK dgeqp3, unblocked), |R(i, i)| does not
+ * increase along the diagonal, and the number of them above a tolerance
+ * estimates the rank.                                                       */
+
+template<class T_mat>
+class QRDecomposition;
+
+namespace detail
+{
+
+// min(m, n) if both are known at compile time
+template<dimension_type I_row, dimension_type I_col>
+struct min_dimension
+{
+    constexpr static dimension_type value =
+        (is_static_dimension<I_row>::value && is_static_dimension<I_col>::value) ?
+        (I_row < I_col ? I_row : I_col) : DYNAMIC;
+};
+
+// a zero matrix or vector of the given shape
+template<class T_mat, typename std::enable_if<
+    is_static_dimension<T_mat::dim_row>::value&&
+    is_static_dimension<T_mat::dim_col>::value>::type*& = enabler>
+inline T_mat zero_matrix(const std::size_t, const std::size_t)
+{return T_mat();}
+template<class T_mat, typename std::enable_if<
+    is_dynamic_dimension<T_mat::dim_row>::value&&
+    is_dynamic_dimension<T_mat::dim_col>::value>::type*& = enabler>
+inline T_mat zero_matrix(const std::size_t row, const std::size_t col)
+{return T_mat(row, col);}
+template<class T_mat, typename std::enable_if<
+    is_dynamic_dimension<T_mat::dim_row>::value&&
+    is_static_dimension<T_mat::dim_col>::value>::type*& = enabler>
+inline T_mat zero_matrix(const std::size_t row, const std::size_t)
+{return T_mat(row);}
+template<class T_mat, typename std::enable_if<
+    is_static_dimension<T_mat::dim_row>::value&&
+    is_dynamic_dimension<T_mat::dim_col>::value>::type*& = enabler>
+inline T_mat zero_matrix(const std::size_t, const std::size_t col)
+{return T_mat(col);}
+
+template<class T_vec, typename std::enable_if<
+    is_static_dimension<T_vec::dim>::value>::type*& = enabler>
+inline T_vec zero_vector(const std::size_t) {return T_vec();}
+template<class T_vec, typename std::enable_if<
+    is_dynamic_dimension<T_vec::dim>::value>::type*& = enabler>
+inline T_vec zero_vector(const std::size_t n) {return T_vec(n);}
+
+// C = H * C for the rows x ncol matrix at c and H = I - tau * v * v^T with
+// v(0) = 1 and v(i) = v[i * incv]. work has ncol elements.
+template<typename T_elem>
+void qr_apply_reflector(const T_elem* const v, const std::size_t incv,
+                        const std::size_t rows, const T_elem tau,
+                        T_elem* const c, const std::size_t ldc,
+                        const std::size_t ncol, T_elem* const work)
+{
+    if(tau == T_elem(0)) return;
+    for(std::size_t j=0; j<ncol; ++j) work[j] = c[j];
+    for(std::size_t r=1; r<rows; ++r)
+    {
+        const T_elem vr = v[r * incv];
+        for(std::size_t j=0; j<ncol; ++j) work[j] += vr * c[r * ldc + j];
+    }
+    for(std::size_t j=0; j<ncol; ++j) c[j] -= tau * work[j];
+    for(std::size_t r=1; r<rows; ++r)
+    {
+        const T_elem vr = tau * v[r * incv];
+        for(std::size_t j=0; j<ncol; ++j) c[r * ldc + j] -= vr * work[j];
+    }
+    return;
+}
+
+// unblocked QR of the m x n matrix at a: R on and above the diagonal,
+// v_k(i) = a(i, k) for i > k below it (v_k(k) = 1)
+template<typename T_elem>
+void qr_factorize_unblocked(T_elem* const a, const std::size_t ld,
+                            const std::size_t m, const std::size_t n,
+                            T_elem* const tau)
+{
+    std::vector<T_elem> work(n);
+    for(std::size_t k=0, kmax=std::min(m, n); k<kmax; ++k)
+    {
+        tau[k] = householder_reflector(a + k * ld + k, m - k, ld);
+        qr_apply_reflector(a + k * ld + k, ld, m - k, tau[k],
+                           a + k * ld + k + 1, ld, n - k - 1, work.data());
+    }
+    return;
+}
+
+// the same with column pivoting: column k of A * P is column perm[k] of A.
+// the norms of the trailing columns are downdated after each step and
+// recomputed where that would cancel (LAPACK dlaqp2).
+template<typename T_elem>
+void qr_factorize_pivoted(T_elem* const a, const std::size_t ld,
+                          const std::size_t m, const std::size_t n,
+                          T_elem* const tau, std::size_t* const perm)
+{
+    const T_elem tol3z = std::sqrt(std::numeric_limits<T_elem>::epsilon());
+    std::vector<T_elem> vn1(n, T_elem(0)), vn2(n), work(n);
+    for(std::size_t r=0; r<m; ++r)
+        for(std::size_t j=0; j<n; ++j) vn1[j] += a[r * ld + j] * a[r * ld + j];
+    for(std::size_t j=0; j<n; ++j)
+    {
+        vn1[j] = vn2[j] = std::sqrt(vn1[j]);
+        perm[j] = j;
+    }
+
+    for(std::size_t k=0, kmax=std::min(m, n); k<kmax; ++k)
+    {
+        const std::size_t piv =
+            std::max_element(vn1.begin() + k, vn1.end()) - vn1.begin();
+        if(piv != k)
+        {
+            for(std::size_t r=0; r<m; ++r) std::swap(a[r * ld + k], a[r * ld + piv]);
+            std::swap(perm[k], perm[piv]);
+            std::swap(vn1[k],  vn1[piv]);
+            std::swap(vn2[k],  vn2[piv]);
+        }
+
+        tau[k] = householder_reflector(a + k * ld + k, m - k, ld);
+        qr_apply_reflector(a + k * ld + k, ld, m - k, tau[k],
+                           a + k * ld + k + 1, ld, n - k - 1, work.data());
+
+        for(std::size_t j=k+1; j<n; ++j)
+        {
+            if(vn1[j] == T_elem(0)) continue;
+            const T_elem ratio = std::abs(a[k * ld + j]) / vn1[j];
+            const T_elem temp  = std::max(T_elem(0), (1 - ratio) * (1 + ratio));
+            const T_elem rel   = vn1[j] / vn2[j];
+            if(temp * rel * rel > tol3z)
+            {
+                vn1[j] *= std::sqrt(temp);
+                continue;
+            }
+            T_elem norm2(0);
+            for(std::size_t r=k+1; r<m; ++r) norm2 += a[r * ld + j] * a[r * ld + j];
+            vn1[j] = vn2[j] = std::sqrt(norm2);
+        }
+    }
+    return;
+}
+
+// the upper triangular T of H_0 * ... * H_{nb-1} = I - V * T * V^T for the
+// reflectors in the columns of the m x nb block at a (LAPACK dlarft).
+// t has leading dimension ldt; its strict lower triangle is zeroed.
+template<typename T_elem>
+void qr_form_t(const T_elem* const a, const std::size_t ld, const std::size_t m,
+               const std::size_t nb, const T_elem* const tau,
+               T_elem* const t, const std::size_t ldt)
+{
+    for(std::size_t i=0; i<nb; ++i)
+    {
+        // z = V(:, 0:i)^T * v_i into column i of t
+        for(std::size_t j=0; j<i; ++j) t[j * ldt + i] = a[i * ld + j];
+        for(std::size_t r=i+1; r<m; ++r)
+        {
+            const T_elem vi = a[r * ld + i];
+            for(std::size_t j=0; j<i; ++j) t[j * ldt + i] += a[r * ld + j] * vi;
+        }
+        // t(0:i, i) = -tau_i * T(0:i, 0:i) * z, top down so that z(l >= j)
+        // is still there when t(j, i) is written
+        for(std::size_t j=0; j<i; ++j)
+        {
+            T_elem sum(0);
+            for(std::size_t l=j; l<i; ++l) sum += t[j * ldt + l] * t[l * ldt + i];
+            t[j * ldt + i] = -tau[i] * sum;
+        }
+        t[i * ldt + i] = tau[i];
+        for(std::size_t j=0; j<i; ++j) t[i * ldt + j] = T_elem(0);
+    }
+    return;
+}
+
+// C = (I - V * T * V^T) * C, or with T^T if transpose, for the m x nb
+// reflector block at a and the m x ncol matrix at c
+template<typename T_elem>
+void qr_apply_block(const T_elem* const a, const std::size_t ld,
+                    const std::size_t m, const std::size_t nb,
+                    const T_elem* const t, const std::size_t ldt,
+                    const bool transpose, T_elem* const c,
+                    const std::size_t ldc, const std::size_t ncol)
+{
+    if(ncol == 0) return;
+    // V with its unit diagonal and zeros above, and W = V^T * C
+    std::vector<T_elem> v(m * nb), w(nb * ncol);
+    for(std::size_t r=0; r<m; ++r)
+        for(std::size_t j=0; j<nb; ++j)
+            v[r * nb + j] = (r > j) ? a[r * ld + j] : T_elem(r == j ? 1 : 0);
+
+    const bool column = (ncol == 1 && ldc == 1);
+    if(column)
+        gemv_trans<T_elem>(m, nb, T_elem(1), v.data(), nb, c, T_elem(0), w.data());
+    else
+        gemm<T_elem>(nb, ncol, m, T_elem(1), v.data(), 1, nb, c, ldc, 1,
+                     T_elem(0), w.data(), ncol);
+
+    if(!transpose) // W = T * W, top down
+    {
+        for(std::size_t i=0; i<nb; ++i)
+        {
+            for(std::size_t j=0; j<ncol; ++j) w[i * ncol + j] *= t[i * ldt + i];
+            for(std::size_t l=i+1; l<nb; ++l)
+            {
+                const T_elem til = t[i * ldt + l];
+                for(std::size_t j=0; j<ncol; ++j) w[i * ncol + j] += til * w[l * ncol + j];
+            }
+        }
+    }
+    else // W = T^T * W, bottom up
+    {
+        for(std::size_t i=nb; i-- > 0;)
+        {
+            for(std::size_t j=0; j<ncol; ++j) w[i * ncol + j] *= t[i * ldt + i];
+            for(std::size_t l=0; l<i; ++l)
+            {
+                const T_elem tli = t[l * ldt + i];
+                for(std::size_t j=0; j<ncol; ++j) w[i * ncol + j] += tli * w[l * ncol + j];
+            }
+        }
+    }
+
+    if(column)
+        gemv<T_elem>(m, nb, T_elem(-1), v.data(), nb, w.data(), T_elem(1), c);
+    else
+        gemm<T_elem>(m, ncol, nb, T_elem(-1), v.data(), nb, 1, w.data(), ncol, 1,
+                     T_elem(1), c, ldc);
+    return;
+}
+
+// the T factors of the blocks of nb reflectors of the m x k reflector
+// columns at a, nb * nb elements per block in tfac
+template<typename T_elem>
+void qr_form_t_blocks(const T_elem* const a, const std::size_t ld,
+                      const std::size_t m, const std::size_t k,
+                      const T_elem* const tau, const std::size_t nb,
+                      T_elem* const tfac)
+{
+    for(std::size_t j0=0; j0<k; j0+=nb)
+        qr_form_t(a + j0 * ld + j0, ld, m - j0, std::min(nb, k - j0),
+                  tau + j0, tfac + (j0 / nb) * nb * nb, nb);
+    return;
+}
+
+// blocked QR of the m x n matrix at a: each panel of nb columns is
+// factored unblocked, its T is formed, and the columns right of it are
+// updated by the block reflector as matrix products.
+template<typename T_elem>
+void qr_factorize(T_elem* const a, const std::size_t ld, const std::size_t m,
+                  const std::size_t n, T_elem* const tau, const std::size_t nb,
+                  T_elem* const tfac)
+{
+    const std::size_t k = std::min(m, n);
+    for(std::size_t j0=0; j0<k; j0+=nb)
+    {
+        const std::size_t jb = std::min(nb, k - j0);
+        T_elem* const panel = a + j0 * ld + j0;
+        T_elem* const t = tfac + (j0 / nb) * nb * nb;
+        qr_factorize_unblocked(panel, ld, m - j0, jb, tau + j0);
+        qr_form_t(panel, ld, m - j0, jb, tau + j0, t, nb);
+        qr_apply_block(panel, ld, m - j0, jb, t, nb, true,
+                       panel + jb, ld, n - j0 - jb);
+    }
+    return;
+}
+
+// C = Q^T * C if transpose, otherwise C = Q * C, for the m x ncol matrix at
+// c and Q = H_0 * ... * H_{k-1} of the m x k reflector columns at a
+template<typename T_elem>
+void qr_apply_q(const T_elem* const a, const std::size_t ld, const std::size_t m,
+                const std::size_t k, const T_elem* const tfac, const std::size_t nb,
+                const bool transpose, T_elem* const c, const std::size_t ldc,
+                const std::size_t ncol)
+{
+    const std::size_t nblock = (k + nb - 1) / nb;
+    for(std::size_t i=0; i<nblock; ++i)
+    {
+        const std::size_t b  = transpose ? i : nblock - 1 - i;
+        const std::size_t j0 = b * nb;
+        qr_apply_block(a + j0 * ld + j0, ld, m - j0, std::min(nb, k - j0),
+                       tfac + b * nb * nb, nb, transpose, c + j0 * ldc, ldc, ncol);
+    }
+    return;
+}
+
+// X(0:r, :) = R(0:r, 0:r)^-1 * X(0:r, :) for the upper triangular R at a
+template<typename T_elem>
+void qr_back_substitute(const T_elem* const a, const std::size_t ld,
+                        const std::size_t r, T_elem* const x,
+                        const std::size_t ldx, const std::size_t ncol)
+{
+    for(std::size_t i=r; i-- > 0;)
+    {
+        T_elem* const xi = x + i * ldx;
+        for(std::size_t l=i+1; l<r; ++l)
+        {
+            const T_elem ail = a[i * ld + l];
+            for(std::size_t j=0; j<ncol; ++j) xi[j] -= ail * x[l * ldx + j];
+        }
+        const T_elem rcp = T_elem(1) / a[i * ld + i];
+        for(std::size_t j=0; j<ncol; ++j) xi[j] *= rcp;
+    }
+    return;
+}
+
+}// detail
+
+template<typename T_elem, dimension_type I_row, dimension_type I_col>
+class QRDecomposition<Matrix<T_elem, I_row, I_col>>
+{
+  public:
+
+    using elem_t = T_elem;
+    using matrix_type = Matrix<T_elem, I_row, I_col>;
+    constexpr static dimension_type dim_rank =
+        detail::min_dimension<I_row, I_col>::value;
+    using matrix_q_type = Matrix<T_elem, I_row, dim_rank>;
+    using matrix_r_type = Matrix<T_elem, dim_rank, I_col>;
+    using solution_type = Vector<T_elem, I_col>;
+    using permutation_type = std::vector<std::size_t>;
+
+    constexpr static std::size_t block_size = AX_QR_BLOCK_SIZE;
+
+  public:
+
+    explicit QRDecomposition(const matrix_type& mat, const bool pivoting = false)
+        : qr_(mat), pivoting_(pivoting)
+    {
+        this->factorize();
+    }
+    explicit QRDecomposition(matrix_type&& mat, const bool pivoting = false)
+        : qr_(std::move(mat)), pivoting_(pivoting)
+    {
+        this->factorize();
+    }
+    ~QRDecomposition() = default;
+
+    std::size_t size_row() const {return dimension_row(qr_);}
+    std::size_t size_col() const {return dimension_col(qr_);}
+    std::size_t size_rank() const {return tau_.size();}
+    bool pivoting() const {return pivoting_;}
+
+    // R and the reflectors packed in one matrix, and P: column k of A * P is
+    // column permutation()[k] of A (the identity without pivoting)
+    matrix_type      const& QR()          const {return qr_;}
+    permutation_type const& permutation() const {return perm_;}
+
+    // k x n upper trapezoidal factor
+    matrix_r_type R() const
+    {
+        matrix_r_type retval =
+            detail::zero_matrix<matrix_r_type>(this->size_rank(), this->size_col());
+        for(std::size_t i=0; i<this->size_rank(); ++i)
+            for(std::size_t j=i; j<this->size_col(); ++j)
+                retval(i, j) = qr_(i, j);
+        return retval;
+    }
+
+    // m x k factor with orthonormal columns
+    matrix_q_type Q() const
+    {
+        const std::size_t m = this->size_row();
+        const std::size_t k = this->size_rank();
+        std::vector<elem_t> c(m * k, elem_t(0));
+        for(std::size_t i=0; i<k; ++i) c[i * k + i] = elem_t(1);
+        this->apply(false, c.data(), k, k);
+
+        matrix_q_type retval = detail::zero_matrix<matrix_q_type>(m, k);
+        for(std::size_t i=0; i<m; ++i)
+            for(std::size_t j=0; j<k; ++j)
+                retval(i, j) = c[i * k + j];
+        return retval;
+    }
+
+    // |R(i, i)| at or below this are taken as zero by default
+    elem_t default_tolerance() const
+    {
+        if(this->size_rank() == 0) return elem_t(0);
+        return std::max(this->size_row(), this->size_col()) *
+               std::numeric_limits<elem_t>::epsilon() * std::abs(qr_(0, 0));
+    }
+
+    // number of leading |R(i, i)| larger than tol. an estimate of the rank
+    // with pivoting, just a check for zero pivots without.
+    std::size_t rank() const {return this->rank(this->default_tolerance());}
+    std::size_t rank(const elem_t tol) const
+    {
+        std::size_t r = 0;
+        while(r < this->size_rank() && std::abs(qr_(r, r)) > tol) ++r;
+        return r;
+    }
+
+    // Q^T * b and Q * b with the full m x m Q, without forming it
+    template<class T_vec, typename std::enable_if<
+        is_vector_expression<typename T_vec::tag>::value&&
+        std::is_same<typename T_vec::elem_t, elem_t>::value>::type*& = enabler>
+    Vector<elem_t, I_row> apply_Qt(const T_vec& b) const
+    {
+        this->check_rhs(dimension(b));
+        Vector<elem_t, I_row> c(b);
+        this->apply(true, c.data(), 1, 1);
+        return c;
+    }
+    template<class T_vec, typename std::enable_if<
+        is_vector_expression<typename T_vec::tag>::value&&
+        std::is_same<typename T_vec::elem_t, elem_t>::value>::type*& = enabler>
+    Vector<elem_t, I_row> apply_Q(const T_vec& b) const
+    {
+        this->check_rhs(dimension(b));
+        Vector<elem_t, I_row> c(b);
+        this->apply(false, c.data(), 1, 1);
+        return c;
+    }
+
+    // Q^T * B and Q * B, all the columns of B at once
+    template<class T_rhs, typename std::enable_if<
+        is_matrix_expression<typename T_rhs::tag>::value&&
+        std::is_same<typename T_rhs::elem_t, elem_t>::value>::type*& = enabler>
+    Matrix<elem_t, I_row, T_rhs::dim_col> apply_Qt(const T_rhs& B) const
+    {
+        this->check_rhs(dimension_row(B));
+        Matrix<elem_t, I_row, T_rhs::dim_col> C(B);
+        this->apply(true, C.data(), C.stride(), dimension_col(C));
+        return C;
+    }
+    template<class T_rhs, typename std::enable_if<
+        is_matrix_expression<typename T_rhs::tag>::value&&
+        std::is_same<typename T_rhs::elem_t, elem_t>::value>::type*& = enabler>
+    Matrix<elem_t, I_row, T_rhs::dim_col> apply_Q(const T_rhs& B) const
+    {
+        this->check_rhs(dimension_row(B));
+        Matrix<elem_t, I_row, T_rhs::dim_col> C(B);
+        this->apply(false, C.data(), C.stride(), dimension_col(C));
+        return C;
+    }
+
+    // x that minimizes |A * x - b| through R * P^T * x = Q^T * b. with
+    // pivoting the columns beyond rank() get x = 0 (the basic solution);
+    // without it a zero R(i, i) is an error.
+    template<class T_vec, typename std::enable_if<
+        is_vector_expression<typename T_vec::tag>::value&&
+        std::is_same<typename T_vec::elem_t, elem_t>::value>::type*& = enabler>
+    solution_type solve_least_squares(const T_vec& b) const
+    {
+        const Vector<elem_t, I_row> c = this->apply_Qt(b);
+        const std::size_t r = this->solvable_rank();
+        std::vector<elem_t> y(c.data(), c.data() + r);
+        detail::qr_back_substitute(qr_.data(), qr_.stride(), r, y.data(), 1, 1);
+
+        solution_type x = detail::zero_vector<solution_type>(this->size_col());
+        for(std::size_t i=0; i<r; ++i) x[perm_[i]] = y[i];
+        return x;
+    }
+    template<class T_rhs, typename std::enable_if<
+        is_matrix_expression<typename T_rhs::tag>::value&&
+        std::is_same<typename T_rhs::elem_t, elem_t>::value>::type*& = enabler>
+    Matrix<elem_t, I_col, T_rhs::dim_col> solve_least_squares(const T_rhs& B) const
+    {
+        const Matrix<elem_t, I_row, T_rhs::dim_col> C = this->apply_Qt(B);
+        const std::size_t r = this->solvable_rank();
+        const std::size_t ncol = dimension_col(C);
+        std::vector<elem_t> y(C.data(), C.data() + r * C.stride());
+        detail::qr_back_substitute(qr_.data(), qr_.stride(), r, y.data(),
+                                   C.stride(), ncol);
+
+        Matrix<elem_t, I_col, T_rhs::dim_col> X = detail::zero_matrix<
+            Matrix<elem_t, I_col, T_rhs::dim_col>>(this->size_col(), ncol);
+        for(std::size_t i=0; i<r; ++i)
+            for(std::size_t j=0; j<ncol; ++j)
+                X(perm_[i], j) = y[i * C.stride() + j];
+        return X;
+    }
+
+  private:
+
+    void factorize()
+    {
+        const std::size_t m = this->size_row();
+        const std::size_t n = this->size_col();
+        const std::size_t k = std::min(m, n);
+        tau_.assign(k, elem_t(0));
+        tfac_.assign(((k + block_size - 1) / block_size) * block_size * block_size,
+                     elem_t(0));
+        perm_.resize(n);
+        if(pivoting_)
+        {
+            detail::qr_factorize_pivoted(qr_.data(), qr_.stride(), m, n,
+                                         tau_.data(), perm_.data());
+            detail::qr_form_t_blocks(qr_.data(), qr_.stride(), m, k,
+                                     tau_.data(), block_size, tfac_.data());
+        }
+        else
+        {
+            for(std::size_t j=0; j<n; ++j) perm_[j] = j;
+            detail::qr_factorize(qr_.data(), qr_.stride(), m, n, tau_.data(),
+                                 block_size, tfac_.data());
+        }
+        return;
+    }
+
+    void apply(const bool transpose, elem_t* const c, const std::size_t ldc,
+               const std::size_t ncol) const
+    {
+        detail::qr_apply_q(qr_.data(), qr_.stride(), this->size_row(),
+                           this->size_rank(), tfac_.data(), block_size,
+                           transpose, c, ldc, ncol);
+        return;
+    }
+
+    void check_rhs(const std::size_t rhs_size) const
+    {
+        if(rhs_size != this->size_row())
+            throw std::invalid_argument("QR decomposition: rhs size different");
+        return;
+    }
+
+    std::size_t solvable_rank() const
+    {
+        if(pivoting_) return this->rank();
+        if(this->rank(elem_t(0)) != this->size_rank())
+            throw std::runtime_error("QR decomposition: rank deficient matrix");
+        return this->size_rank();
+    }
+
+  private:
+
+    matrix_type         qr_;
+    bool                pivoting_;
+    std::vector<elem_t> tau_;
+    std::vector<elem_t> tfac_;
+    permutation_type    perm_;
+};
+
+// helper functions
+template<typename T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value>::type*& = enabler>
+inline QRDecomposition<Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>>
+QRdecompose(const T_mat& mat)
+{
+    return QRDecomposition<
+        Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>>(
+            Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>(mat));
+}
+
+template<typename T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value>::type*& = enabler>
+inline QRDecomposition<Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>>
+QRdecompose_pivoted(const T_mat& mat)
+{
+    return QRDecomposition<
+        Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>>(
+            Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>(mat),
+            true);
+}
+
+}//ax
+
+#endif //AX_QR_DECOMPOSITION_H
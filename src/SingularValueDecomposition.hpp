@@ -0,0 +1,432 @@
+#ifndef AX_SINGULAR_VALUE_DECOMPOSITION_H
+#define AX_SINGULAR_VALUE_DECOMPOSITION_H
+#include "JacobiMethod.hpp"
+#include "QRDecomposition.hpp"
+#include "SymmetricEigen3x3.hpp"
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <vector>
+#include <cmath>
+
+namespace ax
+{
+
+/* thin singular value decomposition A = U * diag(s) * V^T of an m x n
+ * matrix, with r = min(m, n) singular values in descending order and U, V
+ * of r orthonormal columns.
+ * the general path is the one-sided Jacobi method preconditioned by a QR
+ * factorization with column pivoting (Z. Drmac and K. Veselic, SIAM J.
+ * Matrix Anal. Appl. 29, 1322 (2008)): A * P = Q * R, and the columns of
+ * R^T are rotated pairwise by the rotations of JacobiMethod until they are
+ * orthogonal, R^T * V1 = U1 * diag(s). then A = (Q * V1) * diag(s) *
+ * (P * U1)^T. a wide matrix is decomposed through its transpose.
+ * a 3x3 matrix (a cross-covariance of two coordinate sets) takes a closed
+ * form instead: V from the eigenvectors of A^T * A by eigen_symmetric3x3,
+ * and U from A * V. its error is about epsilon times the largest singular
+ * value, while the Jacobi path gets the small ones to a relative accuracy. */
+
+template<class T_mat>
+class SingularValueDecomposition;
+
+namespace detail
+{
+
+// one-sided Jacobi on the n rows of length len at x: the rows are rotated
+// pairwise, by the rotation that diagonalizes their 2x2 Gram matrix, until
+// every pair is orthogonal to rel_tol. the rotations are accumulated into
+// the rows of w. returns the number of sweeps, or max_sweep + 1.
+template<typename T_elem>
+std::size_t svd_jacobi_sweeps(T_elem* const x, const std::size_t ldx,
+                              const std::size_t n, const std::size_t len,
+                              T_elem* const w, const std::size_t ldw,
+                              const T_elem rel_tol, const std::size_t max_sweep)
+{
+    const T_elem tiny = std::numeric_limits<T_elem>::min();
+    const auto dot = [x, ldx, len](const std::size_t p, const std::size_t q)
+    {
+        T_elem retval(0);
+        for(std::size_t k=0; k<len; ++k) retval += x[p * ldx + k] * x[q * ldx + k];
+        return retval;
+    };
+
+    std::vector<T_elem> norm2(n);
+    for(std::size_t sweep=1; sweep<=max_sweep; ++sweep)
+    {
+        // the squared norms are updated by the rotations and refreshed here
+        for(std::size_t i=0; i<n; ++i) norm2[i] = dot(i, i);
+
+        bool rotated = false;
+        for(std::size_t p=0; p<n; ++p)
+        {
+            for(std::size_t q=p+1; q<n; ++q)
+            {
+                const T_elem apq = dot(p, q);
+                if(jacobi_negligible(norm2[p], norm2[q], apq, tiny, rel_tol))
+                    continue;
+
+                const jacobi_rotation<T_elem> rot(norm2[p], norm2[q], apq);
+                jacobi_rotate_rows(x, ldx, len, p, q, rot);
+                jacobi_rotate_rows(w, ldw, n, p, q, rot);
+                norm2[p] -= rot.t * apq;
+                norm2[q] += rot.t * apq;
+                rotated = true;
+            }
+        }
+        if(!rotated) return sweep;
+    }
+    return max_sweep + 1;
+}
+
+// rows of the n x len matrix u that are not valid (zero singular values)
+// are replaced by unit vectors orthogonal to all the others: the unit axis
+// that keeps the most of its length when projected out of the valid rows.
+template<typename T_elem>
+void svd_complete_rows(T_elem* const u, const std::size_t n, const std::size_t len,
+                       std::vector<bool>& valid)
+{
+    std::vector<T_elem> trial(len), best(len);
+    for(std::size_t i=0; i<n; ++i)
+    {
+        if(valid[i]) continue;
+        T_elem best_norm(-1);
+        for(std::size_t e=0; e<len; ++e)
+        {
+            std::fill(trial.begin(), trial.end(), T_elem(0));
+            trial[e] = T_elem(1);
+            for(std::size_t pass=0; pass<2; ++pass)
+            {
+                for(std::size_t j=0; j<n; ++j)
+                {
+                    if(!valid[j]) continue;
+                    const T_elem* const uj = u + j * len;
+                    T_elem d(0);
+                    for(std::size_t k=0; k<len; ++k) d += uj[k] * trial[k];
+                    for(std::size_t k=0; k<len; ++k) trial[k] -= d * uj[k];
+                }
+            }
+            T_elem norm(0);
+            for(std::size_t k=0; k<len; ++k) norm += trial[k] * trial[k];
+            if(norm > best_norm){best_norm = norm; best.swap(trial);}
+        }
+        const T_elem rcp = T_elem(1) / std::sqrt(best_norm);
+        for(std::size_t k=0; k<len; ++k) u[i * len + k] = best[k] * rcp;
+        valid[i] = true;
+    }
+    return;
+}
+
+// unit vector orthogonal to the unit vector x
+template<typename T_elem>
+inline void svd3_orthogonal(const T_elem (&x)[3], T_elem (&y)[3])
+{
+    // cross product with the axis least aligned to x
+    std::size_t axis = 0;
+    for(std::size_t i=1; i<3; ++i)
+        if(std::abs(x[i]) < std::abs(x[axis])) axis = i;
+    T_elem e[3] = {T_elem(0), T_elem(0), T_elem(0)};
+    e[axis] = T_elem(1);
+    sym3_cross(x, e, y);
+    const T_elem rcp = T_elem(1) / std::sqrt(sym3_dot(y, y));
+    for(std::size_t i=0; i<3; ++i) y[i] *= rcp;
+    return;
+}
+
+// closed form SVD of the 3x3 matrix a: u[i] and v[i] are the i-th left
+// and right singular vectors, s in descending order.
+template<typename T_elem>
+void svd3_closed_form(const T_elem (&a)[3][3], T_elem (&u)[3][3],
+                      T_elem (&s)[3], T_elem (&v)[3][3])
+{
+    const T_elem eps = std::numeric_limits<T_elem>::epsilon();
+    T_elem scale(0);
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j) scale = std::max(scale, std::abs(a[i][j]));
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j)
+            u[i][j] = v[i][j] = (i == j) ? T_elem(1) : T_elem(0);
+    s[0] = s[1] = s[2] = T_elem(0);
+    if(scale == T_elem(0)) return;
+
+    T_elem b[3][3];
+    const T_elem inv = T_elem(1) / scale;
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j) b[i][j] = a[i][j] * inv;
+
+    // right singular vectors: eigenvectors of B^T * B, largest first
+    Matrix<T_elem, 3, 3> btb;
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j)
+            btb(i, j) = b[0][i] * b[0][j] + b[1][i] * b[1][j] + b[2][i] * b[2][j];
+    const auto eig = eigen_symmetric3x3(btb);
+    T_elem w[3][3]; // B * v[i]
+    for(std::size_t i=0; i<3; ++i)
+    {
+        for(std::size_t j=0; j<3; ++j) v[i][j] = eig[2 - i].second[j];
+        for(std::size_t j=0; j<3; ++j) w[i][j] = sym3_dot(b[j], v[i]);
+    }
+
+    // U by Gram-Schmidt on B * V, completed by a cross product
+    s[0] = std::sqrt(sym3_dot(w[0], w[0]));
+    for(std::size_t j=0; j<3; ++j) u[0][j] = w[0][j] / s[0];
+
+    const T_elem d = sym3_dot(u[0], w[1]);
+    for(std::size_t j=0; j<3; ++j) w[1][j] -= d * u[0][j];
+    s[1] = std::sqrt(sym3_dot(w[1], w[1]));
+    if(s[1] > 4 * eps * s[0])
+        for(std::size_t j=0; j<3; ++j) u[1][j] = w[1][j] / s[1];
+    else
+        svd3_orthogonal(u[0], u[1]);
+
+    sym3_cross(u[0], u[1], u[2]);
+    s[2] = sym3_dot(u[2], w[2]);
+    if(s[2] < T_elem(0))
+    {
+        s[2] = -s[2];
+        for(std::size_t j=0; j<3; ++j) u[2][j] = -u[2][j];
+    }
+    for(std::size_t i=0; i<3; ++i) s[i] *= scale;
+    return;
+}
+
+}// detail
+
+template<typename T_elem, dimension_type I_row, dimension_type I_col>
+class SingularValueDecomposition<Matrix<T_elem, I_row, I_col>>
+{
+  public:
+
+    using elem_t = T_elem;
+    using matrix_type = Matrix<T_elem, I_row, I_col>;
+    constexpr static dimension_type dim_rank =
+        detail::min_dimension<I_row, I_col>::value;
+    using matrix_u_type = Matrix<T_elem, I_row, dim_rank>;
+    using matrix_v_type = Matrix<T_elem, I_col, dim_rank>;
+    using singular_value_type = Vector<T_elem, dim_rank>;
+    using solution_type = Vector<T_elem, I_col>;
+    using pseudo_inverse_type = Matrix<T_elem, I_col, I_row>;
+
+    constexpr static std::size_t MAX_SWEEP = 30;
+
+  public:
+
+    explicit SingularValueDecomposition(const matrix_type& mat)
+        : row_(dimension_row(mat)), col_(dimension_col(mat)), num_sweep_(0),
+          u_(detail::zero_matrix<matrix_u_type>(row_, std::min(row_, col_))),
+          v_(detail::zero_matrix<matrix_v_type>(col_, std::min(row_, col_))),
+          s_(detail::zero_vector<singular_value_type>(std::min(row_, col_)))
+    {
+        this->decompose(mat, std::integral_constant<bool,
+                is_same_dimension<I_row, 3>::value &&
+                is_same_dimension<I_col, 3>::value>());
+    }
+    ~SingularValueDecomposition() = default;
+
+    std::size_t size_row() const {return row_;}
+    std::size_t size_col() const {return col_;}
+
+    // m x r and n x r with orthonormal columns, and the r singular values in
+    // descending order
+    matrix_u_type       const& U()               const {return u_;}
+    matrix_v_type       const& V()               const {return v_;}
+    singular_value_type const& singular_values() const {return s_;}
+
+    // Jacobi sweeps of the decomposition, 0 for the 3x3 closed form
+    std::size_t num_sweep() const {return num_sweep_;}
+
+    // singular values at or below this are taken as zero by default
+    elem_t default_tolerance() const
+    {
+        if(dimension(s_) == 0) return elem_t(0);
+        return std::max(row_, col_) * std::numeric_limits<elem_t>::epsilon() * s_[0];
+    }
+
+    // number of singular values larger than tol
+    std::size_t rank() const {return this->rank(this->default_tolerance());}
+    std::size_t rank(const elem_t tol) const
+    {
+        std::size_t r = 0;
+        while(r < dimension(s_) && s_[r] > tol) ++r;
+        return r;
+    }
+
+    // s_max / s_min, infinity if the matrix is rank deficient
+    elem_t condition_number() const
+    {
+        const std::size_t r = dimension(s_);
+        if(r == 0 || s_[r-1] == elem_t(0))
+            return std::numeric_limits<elem_t>::infinity();
+        return s_[0] / s_[r-1];
+    }
+
+    // the x of least norm that minimizes |A * x - b|. singular values at or
+    // below tol are taken as zero.
+    template<class T_vec, typename std::enable_if<
+        is_vector_expression<typename T_vec::tag>::value&&
+        std::is_same<typename T_vec::elem_t, elem_t>::value>::type*& = enabler>
+    solution_type solve(const T_vec& b) const
+    {
+        return this->solve(b, this->default_tolerance());
+    }
+    template<class T_vec, typename std::enable_if<
+        is_vector_expression<typename T_vec::tag>::value&&
+        std::is_same<typename T_vec::elem_t, elem_t>::value>::type*& = enabler>
+    solution_type solve(const T_vec& b, const elem_t tol) const
+    {
+        if(dimension(b) != row_)
+            throw std::invalid_argument("SVD: rhs size different");
+        solution_type x = detail::zero_vector<solution_type>(col_);
+        for(std::size_t i=0, r=this->rank(tol); i<r; ++i)
+        {
+            elem_t c(0);
+            for(std::size_t k=0; k<row_; ++k) c += u_(k, i) * b[k];
+            c /= s_[i];
+            for(std::size_t k=0; k<col_; ++k) x[k] += c * v_(k, i);
+        }
+        return x;
+    }
+
+    // the Moore-Penrose pseudo-inverse V * diag(s)^+ * U^T
+    pseudo_inverse_type pseudo_inverse() const
+    {
+        return this->pseudo_inverse(this->default_tolerance());
+    }
+    pseudo_inverse_type pseudo_inverse(const elem_t tol) const
+    {
+        pseudo_inverse_type retval =
+            detail::zero_matrix<pseudo_inverse_type>(col_, row_);
+        for(std::size_t i=0, r=this->rank(tol); i<r; ++i)
+        {
+            const elem_t rcp = elem_t(1) / s_[i];
+            for(std::size_t j=0; j<col_; ++j)
+            {
+                const elem_t vj = v_(j, i) * rcp;
+                for(std::size_t k=0; k<row_; ++k) retval(j, k) += vj * u_(k, i);
+            }
+        }
+        return retval;
+    }
+
+  private:
+
+    void decompose(const matrix_type& mat, std::true_type /* 3x3 */);
+    void decompose(const matrix_type& mat, std::false_type);
+
+  private:
+
+    std::size_t         row_;
+    std::size_t         col_;
+    std::size_t         num_sweep_;
+    matrix_u_type       u_;
+    matrix_v_type       v_;
+    singular_value_type s_;
+};
+
+template<typename T_elem, dimension_type I_row, dimension_type I_col>
+void SingularValueDecomposition<Matrix<T_elem, I_row, I_col>>::decompose(
+        const matrix_type& mat, std::true_type)
+{
+    elem_t a[3][3], u[3][3], s[3], v[3][3];
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j) a[i][j] = mat(i, j);
+    detail::svd3_closed_form(a, u, s, v);
+    for(std::size_t i=0; i<3; ++i)
+    {
+        s_[i] = s[i];
+        for(std::size_t j=0; j<3; ++j)
+        {
+            u_(j, i) = u[i][j];
+            v_(j, i) = v[i][j];
+        }
+    }
+    return;
+}
+
+template<typename T_elem, dimension_type I_row, dimension_type I_col>
+void SingularValueDecomposition<Matrix<T_elem, I_row, I_col>>::decompose(
+        const matrix_type& mat, std::false_type)
+{
+    // the tall m x n matrix that is decomposed, A or A^T
+    const bool transposed = row_ < col_;
+    const std::size_t m = transposed ? col_ : row_;
+    const std::size_t n = transposed ? row_ : col_;
+    if(n == 0) return;
+
+    std::vector<elem_t> a(m * n), tau(n);
+    std::vector<std::size_t> perm(n);
+    for(std::size_t i=0; i<row_; ++i)
+        for(std::size_t j=0; j<col_; ++j)
+            (transposed ? a[j * n + i] : a[i * n + j]) = mat(i, j);
+
+    detail::qr_factorize_pivoted(a.data(), n, m, n, tau.data(), perm.data());
+
+    // the rows of x are the columns of R^T, w accumulates V1^T
+    std::vector<elem_t> x(n * n, elem_t(0)), w(n * n, elem_t(0));
+    for(std::size_t i=0; i<n; ++i)
+    {
+        for(std::size_t j=i; j<n; ++j) x[i * n + j] = a[i * n + j];
+        w[i * n + i] = elem_t(1);
+    }
+    const elem_t rel_tol = std::sqrt(static_cast<elem_t>(n)) *
+                           std::numeric_limits<elem_t>::epsilon();
+    num_sweep_ = detail::svd_jacobi_sweeps(x.data(), n, n, n, w.data(), n,
+                                           rel_tol, MAX_SWEEP);
+    if(num_sweep_ > MAX_SWEEP)
+        throw std::runtime_error("SVD: no convergence");
+
+    // s and the rows of x normalized, U1^T
+    std::vector<elem_t> s(n);
+    std::vector<bool> valid(n);
+    for(std::size_t i=0; i<n; ++i)
+    {
+        elem_t norm2(0);
+        for(std::size_t k=0; k<n; ++k) norm2 += x[i * n + k] * x[i * n + k];
+        s[i] = std::sqrt(norm2);
+        valid[i] = s[i] > elem_t(0);
+        if(valid[i])
+            for(std::size_t k=0; k<n; ++k) x[i * n + k] /= s[i];
+    }
+    detail::svd_complete_rows(x.data(), n, n, valid);
+
+    // Y = Q * V1, the left singular vectors of the tall matrix
+    constexpr std::size_t nb = AX_QR_BLOCK_SIZE;
+    std::vector<elem_t> y(m * n, elem_t(0)), tfac(((n + nb - 1) / nb) * nb * nb);
+    for(std::size_t r=0; r<n; ++r)
+        for(std::size_t i=0; i<n; ++i) y[r * n + i] = w[i * n + r];
+    detail::qr_form_t_blocks(a.data(), n, m, n, tau.data(), nb, tfac.data());
+    detail::qr_apply_q(a.data(), n, m, n, tfac.data(), nb, false, y.data(), n, n);
+
+    std::vector<std::size_t> order(n);
+    for(std::size_t i=0; i<n; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [&s](const std::size_t i, const std::size_t j){return s[i] > s[j];});
+
+    // left vectors Y of the tall matrix, right vectors P * U1
+    for(std::size_t c=0; c<n; ++c)
+    {
+        const std::size_t i = order[c];
+        s_[c] = s[i];
+        for(std::size_t r=0; r<m; ++r)
+            (transposed ? v_(r, c) : u_(r, c)) = y[r * n + i];
+        for(std::size_t k=0; k<n; ++k)
+            (transposed ? u_(perm[k], c) : v_(perm[k], c)) = x[i * n + k];
+    }
+    return;
+}
+
+// helper function
+template<typename T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value>::type*& = enabler>
+inline SingularValueDecomposition<
+    Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>>
+SVdecompose(const T_mat& mat)
+{
+    return SingularValueDecomposition<
+        Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>>(
+            Matrix<typename T_mat::elem_t, T_mat::dim_row, T_mat::dim_col>(mat));
+}
+
+}//ax
+
+#endif //AX_SINGULAR_VALUE_DECOMPOSITION_H
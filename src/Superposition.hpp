@@ -0,0 +1,425 @@
+#ifndef AX_SUPERPOSITION_H
+#define AX_SUPERPOSITION_H
+#include "JacobiMethod.hpp"
+#include "Packet.hpp"
+#include "AlignedAllocator.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+
+namespace ax
+{
+
+/* optimal superposition of two sets of n corresponding points: the
+ * rotation R that minimizes sum |R * (y_i - c_y) - (x_i - c_x)|^2 around
+ * the centroids, and the RMSD that remains.
+ * with S = sum (y_i - c_y) * (x_i - c_x)^T, the best rotation is the unit
+ * quaternion of the largest eigenvalue lambda of the traceless symmetric
+ * 4x4 key matrix K(S) (B. K. P. Horn, J. Opt. Soc. Am. A 4, 629 (1987)),
+ * and RMSD^2 = (G_x + G_y - 2 * lambda) / n with G the sums of squares.
+ * lambda is found by Newton's method on the characteristic polynomial of
+ * K, started from (G_x + G_y) / 2 (QCP; D. L. Theobald, Acta Cryst. A 61,
+ * 478 (2005)). the quaternion is a column of the adjugate of K - lambda * I
+ * (P. Liu et al., J. Comput. Chem. 31, 1561 (2010)); if every column is
+ * too short, because lambda is (nearly) a multiple eigenvalue, it comes
+ * from JacobiMethod on K.
+ * the RMSD is computed through a difference of sums, so it is accurate to
+ * about sqrt(epsilon * G / n) for structures that nearly coincide. for
+ * (nearly) collinear sets lambda is a double root, and the RMSD without the
+ * rotation (superposed_rmsd, superposed_rmsd_matrix) is accurate only to
+ * about sqrt(sqrt(epsilon) * G / n).                                       */
+
+// x_i - reference_center ~ rotation * (y_i - mobile_center)
+template<typename T_elem>
+struct Superposition
+{
+    Matrix<T_elem, 3, 3> rotation;
+    Vector<T_elem, 3>    reference_center;
+    Vector<T_elem, 3>    mobile_center;
+    T_elem               rmsd;
+};
+
+namespace detail
+{
+
+// Horn's key matrix of s(a, b) = sum y_a * x_b
+template<typename T_elem>
+void qcp_key_matrix(const T_elem (&s)[3][3], T_elem (&k)[4][4])
+{
+    k[0][0] =  s[0][0] + s[1][1] + s[2][2];
+    k[1][1] =  s[0][0] - s[1][1] - s[2][2];
+    k[2][2] = -s[0][0] + s[1][1] - s[2][2];
+    k[3][3] = -s[0][0] - s[1][1] + s[2][2];
+    k[0][1] = k[1][0] = s[1][2] - s[2][1];
+    k[0][2] = k[2][0] = s[2][0] - s[0][2];
+    k[0][3] = k[3][0] = s[0][1] - s[1][0];
+    k[1][2] = k[2][1] = s[0][1] + s[1][0];
+    k[1][3] = k[3][1] = s[2][0] + s[0][2];
+    k[2][3] = k[3][2] = s[1][2] + s[2][1];
+    return;
+}
+
+template<typename T_elem>
+inline T_elem qcp_det3(const T_elem a00, const T_elem a01, const T_elem a02,
+                       const T_elem a10, const T_elem a11, const T_elem a12,
+                       const T_elem a20, const T_elem a21, const T_elem a22)
+{
+    return a00 * (a11 * a22 - a12 * a21) - a01 * (a10 * a22 - a12 * a20) +
+           a02 * (a10 * a21 - a11 * a20);
+}
+
+// by the 2x2 minors of the rows 0, 1 and of the rows 2, 3
+template<typename T_elem>
+T_elem qcp_det4(const T_elem (&k)[4][4])
+{
+    const auto minor = [&k](const std::size_t r, const std::size_t i,
+                            const std::size_t j)
+    {
+        return k[r][i] * k[r+1][j] - k[r][j] * k[r+1][i];
+    };
+    return minor(0, 0, 1) * minor(2, 2, 3) - minor(0, 0, 2) * minor(2, 1, 3) +
+           minor(0, 0, 3) * minor(2, 1, 2) + minor(0, 1, 2) * minor(2, 0, 3) -
+           minor(0, 1, 3) * minor(2, 0, 2) + minor(0, 2, 3) * minor(2, 0, 1);
+}
+
+// the largest eigenvalue of K(s), not above e0 = (G_x + G_y) / 2. the
+// characteristic polynomial is l^4 + c2 * l^2 + c1 * l + c0 with
+// c2 = -2 * |S|_F^2, c1 = -8 * det(S) and c0 = det(K); Newton's method
+// from e0 comes down to the largest root monotonically.
+template<typename T_elem>
+T_elem qcp_max_eigenvalue(const T_elem (&s)[3][3], const T_elem (&k)[4][4],
+                          const T_elem e0)
+{
+    T_elem norm2(0);
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j) norm2 += s[i][j] * s[i][j];
+    const T_elem c2 = -2 * norm2;
+    const T_elem c1 = -8 * qcp_det3(s[0][0], s[0][1], s[0][2], s[1][0], s[1][1],
+                                    s[1][2], s[2][0], s[2][1], s[2][2]);
+    const T_elem c0 = qcp_det4(k);
+
+    const T_elem tol = 1e-11;
+    T_elem lambda = e0;
+    for(std::size_t iter=0; iter<50; ++iter)
+    {
+        const T_elem l2 = lambda * lambda;
+        const T_elem b  = (l2 + c2) * lambda;
+        const T_elem a  = b + c1;
+        const T_elem dp = 2 * l2 * lambda + b + a; // P'(lambda)
+        if(dp == T_elem(0)) break;
+        const T_elem delta = (a * lambda + c0) / dp;
+        lambda -= delta;
+        if(std::abs(delta) < std::abs(tol * lambda)) break;
+    }
+    return lambda;
+}
+
+// unit quaternion of the eigenvalue lambda of k. when it comes from
+// JacobiMethod, lambda is replaced by the Jacobi eigenvalue: Newton's
+// method converges to a double root only to about sqrt(epsilon).
+template<typename T_elem>
+void qcp_quaternion(const T_elem (&k)[4][4], T_elem& lambda,
+                    const T_elem e0, T_elem (&q)[4])
+{
+    T_elem a[4][4];
+    for(std::size_t i=0; i<4; ++i)
+        for(std::size_t j=0; j<4; ++j)
+            a[i][j] = k[i][j] - (i == j ? lambda : T_elem(0));
+
+    // columns of adj(A), A symmetric: column c, row r is the (c, r) cofactor
+    T_elem best = T_elem(-1);
+    for(std::size_t c=0; c<4; ++c)
+    {
+        std::size_t rows[3];
+        for(std::size_t i=0, n=0; i<4; ++i) if(i != c) rows[n++] = i;
+        T_elem col[4], norm2(0);
+        for(std::size_t r=0; r<4; ++r)
+        {
+            std::size_t cols[3];
+            for(std::size_t j=0, n=0; j<4; ++j) if(j != r) cols[n++] = j;
+            const T_elem minor = qcp_det3(
+                a[rows[0]][cols[0]], a[rows[0]][cols[1]], a[rows[0]][cols[2]],
+                a[rows[1]][cols[0]], a[rows[1]][cols[1]], a[rows[1]][cols[2]],
+                a[rows[2]][cols[0]], a[rows[2]][cols[1]], a[rows[2]][cols[2]]);
+            col[r] = ((r + c) % 2 == 0) ? minor : -minor;
+            norm2 += col[r] * col[r];
+        }
+        if(norm2 > best)
+        {
+            best = norm2;
+            std::copy(col, col + 4, q);
+        }
+    }
+
+    // the adjugate scales as e0^3 and vanishes at a multiple eigenvalue
+    const T_elem scale = e0 * e0 * e0;
+    if(std::sqrt(best) > T_elem(1e-6) * scale)
+    {
+        const T_elem rcp = T_elem(1) / std::sqrt(best);
+        for(std::size_t i=0; i<4; ++i) q[i] *= rcp;
+        return;
+    }
+    Matrix<T_elem, 4, 4> key;
+    for(std::size_t i=0; i<4; ++i)
+        for(std::size_t j=0; j<4; ++j) key(i, j) = k[i][j];
+    const auto eigenpair = Jacobimethod(key);
+    std::size_t imax = 0;
+    for(std::size_t i=1; i<4; ++i)
+        if(eigenpair[i].first > eigenpair[imax].first) imax = i;
+    for(std::size_t i=0; i<4; ++i) q[i] = eigenpair[imax].second[i];
+    lambda = eigenpair[imax].first;
+    return;
+}
+
+template<typename T_elem>
+Matrix<T_elem, 3, 3> quaternion_rotation(const T_elem (&q)[4])
+{
+    const T_elem q00 = q[0] * q[0], q11 = q[1] * q[1];
+    const T_elem q22 = q[2] * q[2], q33 = q[3] * q[3];
+    const T_elem q01 = q[0] * q[1], q02 = q[0] * q[2], q03 = q[0] * q[3];
+    const T_elem q12 = q[1] * q[2], q13 = q[1] * q[3], q23 = q[2] * q[3];
+
+    Matrix<T_elem, 3, 3> r;
+    r(0, 0) = q00 + q11 - q22 - q33;
+    r(1, 1) = q00 - q11 + q22 - q33;
+    r(2, 2) = q00 - q11 - q22 + q33;
+    r(0, 1) = 2 * (q12 - q03); r(1, 0) = 2 * (q12 + q03);
+    r(0, 2) = 2 * (q13 + q02); r(2, 0) = 2 * (q13 - q02);
+    r(1, 2) = 2 * (q23 - q01); r(2, 1) = 2 * (q23 + q01);
+    return r;
+}
+
+// centroids, S and e0 of two point sets
+template<typename T_elem>
+void qcp_inner_product(const Vector<T_elem, 3>* const x, const Vector<T_elem, 3>* const y,
+                       const std::size_t n, Vector<T_elem, 3>& cx,
+                       Vector<T_elem, 3>& cy, T_elem (&s)[3][3], T_elem& e0)
+{
+    if(n == 0) throw std::invalid_argument("superpose: no coordinates");
+    for(std::size_t a=0; a<3; ++a){cx[a] = T_elem(0); cy[a] = T_elem(0);}
+    for(std::size_t i=0; i<n; ++i)
+        for(std::size_t a=0; a<3; ++a)
+        {
+            cx[a] += x[i][a];
+            cy[a] += y[i][a];
+        }
+    const T_elem rcp = T_elem(1) / n;
+    for(std::size_t a=0; a<3; ++a){cx[a] *= rcp; cy[a] *= rcp;}
+
+    for(std::size_t a=0; a<3; ++a)
+        for(std::size_t b=0; b<3; ++b) s[a][b] = T_elem(0);
+    T_elem g(0);
+    for(std::size_t i=0; i<n; ++i)
+    {
+        const T_elem dx[3] = {x[i][0] - cx[0], x[i][1] - cx[1], x[i][2] - cx[2]};
+        const T_elem dy[3] = {y[i][0] - cy[0], y[i][1] - cy[1], y[i][2] - cy[2]};
+        for(std::size_t a=0; a<3; ++a)
+        {
+            g += dx[a] * dx[a] + dy[a] * dy[a];
+            for(std::size_t b=0; b<3; ++b) s[a][b] += dy[a] * dx[b];
+        }
+    }
+    e0 = g / 2;
+    return;
+}
+
+template<typename T_elem>
+inline T_elem qcp_rmsd(const T_elem e0, const T_elem lambda, const std::size_t n)
+{
+    return std::sqrt(std::max(T_elem(0), 2 * (e0 - lambda) / n));
+}
+
+// centered coordinates of one structure, x, y and z each contiguous and
+// padded with zeros to a multiple of the packet size, and their sum of
+// squares
+template<typename T_elem>
+struct qcp_frame
+{
+    std::vector<T_elem, aligned_allocator<T_elem>> xyz;
+    std::size_t stride;
+    T_elem      g;
+};
+
+template<typename T_elem>
+void qcp_prepare(const std::vector<Vector<T_elem, 3>>& x, qcp_frame<T_elem>& frame)
+{
+    constexpr std::size_t lanes = packet_traits<T_elem>::size;
+    const std::size_t n = x.size();
+    frame.stride = (n + lanes - 1) / lanes * lanes;
+    frame.xyz.assign(3 * frame.stride, T_elem(0));
+
+    T_elem c[3] = {T_elem(0), T_elem(0), T_elem(0)};
+    for(std::size_t i=0; i<n; ++i)
+        for(std::size_t a=0; a<3; ++a) c[a] += x[i][a];
+    frame.g = T_elem(0);
+    for(std::size_t a=0; a<3; ++a)
+    {
+        c[a] /= n;
+        for(std::size_t i=0; i<n; ++i)
+        {
+            const T_elem d = x[i][a] - c[a];
+            frame.xyz[a * frame.stride + i] = d;
+            frame.g += d * d;
+        }
+    }
+    return;
+}
+
+// s(a, b) = sum y_a * x_b. the nine accumulators are spelled out so that
+// they stay in registers.
+template<typename T_elem>
+void qcp_inner_product(const qcp_frame<T_elem>& x, const qcp_frame<T_elem>& y,
+                       T_elem (&s)[3][3])
+{
+    using traits = packet_traits<T_elem>;
+    using packet = typename traits::type;
+    constexpr std::size_t lanes = traits::size;
+    const std::size_t stride = x.stride;
+    const T_elem* const x0 = x.xyz.data();
+    const T_elem* const x1 = x0 + stride;
+    const T_elem* const x2 = x1 + stride;
+    const T_elem* const y0 = y.xyz.data();
+    const T_elem* const y1 = y0 + stride;
+    const T_elem* const y2 = y1 + stride;
+
+    packet s00 = traits::broadcast(T_elem(0)), s01 = s00, s02 = s00;
+    packet s10 = s00, s11 = s00, s12 = s00;
+    packet s20 = s00, s21 = s00, s22 = s00;
+    for(std::size_t i=0; i<stride; i+=lanes)
+    {
+        const packet px0 = traits::load(x0 + i);
+        const packet px1 = traits::load(x1 + i);
+        const packet px2 = traits::load(x2 + i);
+        const packet py0 = traits::load(y0 + i);
+        s00 = packet_add(s00, packet_mul(py0, px0));
+        s01 = packet_add(s01, packet_mul(py0, px1));
+        s02 = packet_add(s02, packet_mul(py0, px2));
+        const packet py1 = traits::load(y1 + i);
+        s10 = packet_add(s10, packet_mul(py1, px0));
+        s11 = packet_add(s11, packet_mul(py1, px1));
+        s12 = packet_add(s12, packet_mul(py1, px2));
+        const packet py2 = traits::load(y2 + i);
+        s20 = packet_add(s20, packet_mul(py2, px0));
+        s21 = packet_add(s21, packet_mul(py2, px1));
+        s22 = packet_add(s22, packet_mul(py2, px2));
+    }
+    s[0][0] = traits::reduce(s00); s[0][1] = traits::reduce(s01);
+    s[0][2] = traits::reduce(s02); s[1][0] = traits::reduce(s10);
+    s[1][1] = traits::reduce(s11); s[1][2] = traits::reduce(s12);
+    s[2][0] = traits::reduce(s20); s[2][1] = traits::reduce(s21);
+    s[2][2] = traits::reduce(s22);
+    return;
+}
+
+}// detail
+
+// the rotation that superposes mobile[i] onto reference[i], i < n, and the
+// RMSD after the superposition
+template<typename T_elem>
+Superposition<T_elem>
+superpose(const Vector<T_elem, 3>* const reference,
+          const Vector<T_elem, 3>* const mobile, const std::size_t n)
+{
+    Superposition<T_elem> retval;
+    T_elem s[3][3], k[4][4], e0, q[4];
+    detail::qcp_inner_product(reference, mobile, n, retval.reference_center,
+                              retval.mobile_center, s, e0);
+    if(e0 == T_elem(0)) // every point at its centroid
+    {
+        retval.rotation = Matrix<T_elem, 3, 3>(T_elem(1));
+        retval.rmsd = T_elem(0);
+        return retval;
+    }
+    detail::qcp_key_matrix(s, k);
+    T_elem lambda = detail::qcp_max_eigenvalue(s, k, e0);
+    detail::qcp_quaternion(k, lambda, e0, q);
+    retval.rotation = detail::quaternion_rotation(q);
+    retval.rmsd = detail::qcp_rmsd(e0, lambda, n);
+    return retval;
+}
+
+template<typename T_elem>
+Superposition<T_elem>
+superpose(const std::vector<Vector<T_elem, 3>>& reference,
+          const std::vector<Vector<T_elem, 3>>& mobile)
+{
+    if(reference.size() != mobile.size())
+        throw std::invalid_argument("superpose: number of coordinates different");
+    return superpose(reference.data(), mobile.data(), reference.size());
+}
+
+// the RMSD after the optimal superposition, without the rotation
+template<typename T_elem>
+T_elem superposed_rmsd(const Vector<T_elem, 3>* const reference,
+                       const Vector<T_elem, 3>* const mobile, const std::size_t n)
+{
+    T_elem s[3][3], k[4][4], e0;
+    Vector<T_elem, 3> cx, cy;
+    detail::qcp_inner_product(reference, mobile, n, cx, cy, s, e0);
+    if(e0 == T_elem(0)) return T_elem(0);
+    detail::qcp_key_matrix(s, k);
+    return detail::qcp_rmsd(e0, detail::qcp_max_eigenvalue(s, k, e0), n);
+}
+
+template<typename T_elem>
+T_elem superposed_rmsd(const std::vector<Vector<T_elem, 3>>& reference,
+                       const std::vector<Vector<T_elem, 3>>& mobile)
+{
+    if(reference.size() != mobile.size())
+        throw std::invalid_argument("superpose: number of coordinates different");
+    return superposed_rmsd(reference.data(), mobile.data(), reference.size());
+}
+
+// RMSD after superposition of every pair of frames. every frame is
+// centered once, and a pair costs one pass of packet multiply-adds over
+// the coordinates and a few Newton steps. the rows are spread over the
+// thread pool; each element is computed the same way on any thread.
+template<typename T_elem>
+Matrix<T_elem, DYNAMIC, DYNAMIC>
+superposed_rmsd_matrix(const std::vector<std::vector<Vector<T_elem, 3>>>& frames)
+{
+    const std::size_t nframe = frames.size();
+    Matrix<T_elem, DYNAMIC, DYNAMIC> retval(nframe, nframe);
+    if(nframe == 0) return retval;
+    const std::size_t n = frames.front().size();
+    if(n == 0) throw std::invalid_argument("superpose: no coordinates");
+
+    std::vector<detail::qcp_frame<T_elem>> centered(nframe);
+    for(std::size_t f=0; f<nframe; ++f)
+    {
+        if(frames[f].size() != n)
+            throw std::invalid_argument("superpose: number of coordinates different");
+        detail::qcp_prepare(frames[f], centered[f]);
+    }
+
+    T_elem* const out = retval.data();
+    const std::size_t ld = retval.stride();
+    const std::function<void(std::size_t)> row = [&](const std::size_t i)
+    {
+        for(std::size_t j=i+1; j<nframe; ++j)
+        {
+            T_elem s[3][3], k[4][4];
+            const T_elem e0 = (centered[i].g + centered[j].g) / 2;
+            if(e0 == T_elem(0)){out[i * ld + j] = T_elem(0); continue;}
+            detail::qcp_inner_product(centered[i], centered[j], s);
+            detail::qcp_key_matrix(s, k);
+            out[i * ld + j] = detail::qcp_rmsd(
+                    e0, detail::qcp_max_eigenvalue(s, k, e0), n);
+        }
+    };
+    if(get_num_threads() > 1 && nframe * nframe * n * 9 / 2 >= get_parallel_threshold())
+        default_thread_pool().parallel_for(nframe, row);
+    else
+        for(std::size_t i=0; i<nframe; ++i) row(i);
+
+    for(std::size_t i=0; i<nframe; ++i)
+        for(std::size_t j=0; j<i; ++j) out[i * ld + j] = out[j * ld + i];
+    return retval;
+}
+
+}//ax
+
+#endif //AX_SUPERPOSITION_H
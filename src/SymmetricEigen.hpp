@@ -0,0 +1,652 @@
+#ifndef AX_SYMMETRIC_EIGEN_H
+#define AX_SYMMETRIC_EIGEN_H
+#include "Matrix.hpp"
+#include "Vector.hpp"
+#include "DynamicMatrix.hpp"
+#include "DynamicVector.hpp"
+#include "GEMM.hpp"
+#include "Packet.hpp"
+#include "ThreadPool.hpp"
+#include "Aliasing.hpp"
+#include <utility>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <stdexcept>
+#include <limits>
+#include <vector>
+#include <cmath>
+
+// number of Householder reflectors per panel of the tridiagonal reduction
+// and per block of the back transformation
+#ifndef AX_TRIDIAGONAL_BLOCK_SIZE
+#define AX_TRIDIAGONAL_BLOCK_SIZE 32
+#endif
+
+// the rotations of AX_QL_BATCH_SIZE QL steps are applied to strips of
+// AX_QL_CHUNK_SIZE columns of the eigenvectors at a time
+#ifndef AX_QL_BATCH_SIZE
+#define AX_QL_BATCH_SIZE 64
+#endif
+#ifndef AX_QL_CHUNK_SIZE
+#define AX_QL_CHUNK_SIZE 64
+#endif
+
+namespace ax
+{
+
+/* eigenpairs of large symmetric matrices.
+ * A = Q * T * Q^T is reduced to a symmetric tridiagonal T with Householder
+ * reflectors, AX_TRIDIAGONAL_BLOCK_SIZE at a time: the reflectors of a panel
+ * are accumulated as A - V * W^T - W * V^T and the trailing matrix is
+ * updated by matrix products (LAPACK dsytrd). T is diagonalized by the
+ * implicit QL method with Wilkinson shifts (EISPACK tql2), and the
+ * eigenvectors of T are taken back to those of A by Q in the compact WY
+ * form I - V * T_b * V^T.
+ * the rotations of the QL steps are collected and applied to strips of the
+ * eigenvector matrix many steps at a time, and the rows of the trailing
+ * matrix, the strips and the blocks of Q are split over the thread pool.   */
+
+template <typename T_mat>
+class HouseholderQL;
+
+namespace detail
+{
+
+// runs body(0), ..., body(nchunk - 1) on the thread pool if work is large
+template<typename T_func>
+inline void eigen_for_chunks(const std::size_t nchunk, const std::size_t work,
+                             T_func&& body)
+{
+    if(nchunk > 1 && get_num_threads() > 1 && work >= get_parallel_threshold())
+        default_thread_pool().parallel_for(nchunk, std::function<void(std::size_t)>(body));
+    else
+        for(std::size_t i=0; i<nchunk; ++i) body(i);
+    return;
+}
+
+// y += A * x over the rows r0..r1-1 of a symmetric matrix of which only the
+// lower triangle is read: row r adds its part left of the diagonal to y[r]
+// and, transposed, to y[0..r-1], so every element is loaded once.
+template<typename T_elem>
+void symv_lower_rows(const T_elem* const a, const std::size_t ld,
+                     const std::size_t r0, const std::size_t r1,
+                     const T_elem* const x, T_elem* const y)
+{
+    using traits = packet_traits<T_elem>;
+    constexpr std::size_t lanes = traits::size;
+    for(std::size_t r=r0; r<r1; ++r)
+    {
+        const T_elem* const ar = a + r * ld;
+        const T_elem xr = x[r];
+        const auto xrp = traits::broadcast(xr);
+        auto acc = traits::broadcast(T_elem(0));
+        std::size_t k = 0;
+        for(; k + lanes <= r; k += lanes)
+        {
+            const auto ak = traits::load(ar + k);
+            acc = packet_add(acc, packet_mul(ak, traits::load(x + k)));
+            traits::store(y + k, packet_add(traits::load(y + k), packet_mul(ak, xrp)));
+        }
+        T_elem sum = traits::reduce(acc);
+        for(; k<r; ++k)
+        {
+            sum  += ar[k] * x[k];
+            y[k] += ar[k] * xr;
+        }
+        y[r] += sum + ar[r] * xr;
+    }
+    return;
+}
+
+// Householder reflector H = I - tau * v * v^T with H * x = beta * e_1 for
+// the len elements x[0], x[inc], ... . x[1..] are overwritten by v[1..]
+// (v[0] = 1) and x[0] by beta. returns tau, 0 if x is already e_1-aligned.
+template<typename T_elem>
+T_elem householder_reflector(T_elem* const x, const std::size_t len,
+                             const std::size_t inc)
+{
+    T_elem scale(0);
+    for(std::size_t i=1; i<len; ++i)
+        scale = std::max(scale, std::abs(x[i * inc]));
+    if(scale == T_elem(0)) return T_elem(0);
+
+    T_elem ssq(0);
+    for(std::size_t i=1; i<len; ++i)
+    {
+        const T_elem xi = x[i * inc] / scale;
+        ssq += xi * xi;
+    }
+    const T_elem alpha = x[0];
+    T_elem beta = std::hypot(alpha, scale * std::sqrt(ssq));
+    if(alpha > T_elem(0)) beta = -beta;
+
+    const T_elem tau = (beta - alpha) / beta;
+    const T_elem rcp = T_elem(1) / (alpha - beta);
+    for(std::size_t i=1; i<len; ++i) x[i * inc] *= rcp;
+    x[0] = beta;
+    return tau;
+}
+
+// reduces the symmetric n x n matrix a (row major, leading dimension ld) to
+// tridiagonal form; only the lower triangle of a is read. on return
+// d[i] = T(i, i), e[i] = T(i, i+1) (e[n-1] = 0), and the reflector
+// H_k = I - tau[k] * v_k * v_k^T has v_k(k+1) = 1 and v_k(i) = a(i, k) for
+// i > k + 1. the rest of a is garbage.
+template<typename T_elem>
+void tridiagonalize(T_elem* const a, const std::size_t ld, const std::size_t n,
+                    T_elem* const d, T_elem* const e, T_elem* const tau)
+{
+    const std::size_t nb = AX_TRIDIAGONAL_BLOCK_SIZE;
+    gemm_buffer<T_elem> V(n * nb), W(n * nb), X(2 * n * nb), Y(2 * n * nb);
+    std::vector<T_elem> v(n), vw(nb), vv(nb);
+    const std::size_t nsymv_chunk = 8;
+    std::vector<T_elem> ypart(nsymv_chunk * n);
+
+    for(std::size_t k0=0; k0<n; k0+=nb)
+    {
+        const std::size_t kb = std::min(nb, n - k0);
+        std::fill(V.begin() + k0 * nb, V.end(), T_elem(0));
+        std::fill(W.begin() + k0 * nb, W.end(), T_elem(0));
+
+        for(std::size_t i=0; i<kb; ++i)
+        {
+            const std::size_t k = k0 + i;
+
+            // bring column k up to date with the reflectors of this panel
+            for(std::size_t r=k; r<n; ++r)
+            {
+                const T_elem* const vr = V.data() + r * nb;
+                const T_elem* const wr = W.data() + r * nb;
+                const T_elem* const vk = V.data() + k * nb;
+                const T_elem* const wk = W.data() + k * nb;
+                T_elem sum(0);
+                for(std::size_t t=0; t<i; ++t) sum += vr[t] * wk[t] + wr[t] * vk[t];
+                a[r * ld + k] -= sum;
+            }
+            d[k] = a[k * ld + k];
+            tau[k] = T_elem(0);
+            e[k] = T_elem(0);
+            if(k + 1 == n) break;
+
+            tau[k] = householder_reflector(a + (k+1) * ld + k, n - k - 1, ld);
+            e[k] = a[(k+1) * ld + k];
+            if(tau[k] == T_elem(0)) continue;
+
+            v[k+1] = T_elem(1);
+            for(std::size_t r=k+2; r<n; ++r) v[r] = a[r * ld + k];
+            for(std::size_t r=k+1; r<n; ++r) V[r * nb + i] = v[r];
+
+            // w = tau * (A - V * W^T - W * V^T) * v on the trailing rows. the
+            // product with the stale trailing matrix reads its lower triangle
+            // only, split into row ranges of equal area with a partial sum each
+            const std::size_t m = n - k - 1;
+            const std::size_t nchunk = (m < 256) ? 1 : nsymv_chunk;
+            T_elem* const a22 = a + (k+1) * ld + k + 1;
+            eigen_for_chunks(nchunk, m * m, [&](const std::size_t c)
+            {
+                const std::size_t r0 = static_cast<std::size_t>(
+                        m * std::sqrt(static_cast<double>(c) / nchunk));
+                const std::size_t r1 = (c + 1 == nchunk) ? m :
+                    static_cast<std::size_t>(
+                        m * std::sqrt(static_cast<double>(c + 1) / nchunk));
+                T_elem* const y = ypart.data() + c * n;
+                std::fill(y, y + m, T_elem(0));
+                symv_lower_rows(a22, ld, r0, r1, v.data() + k + 1, y);
+            });
+            for(std::size_t r=0; r<m; ++r)
+            {
+                T_elem sum(0);
+                for(std::size_t c=0; c<nchunk; ++c) sum += ypart[c * n + r];
+                W[(k + 1 + r) * nb + i] = sum;
+            }
+            std::fill(vw.begin(), vw.end(), T_elem(0));
+            std::fill(vv.begin(), vv.end(), T_elem(0));
+            for(std::size_t r=k+1; r<n; ++r)
+                for(std::size_t t=0; t<i; ++t)
+                {
+                    vw[t] += W[r * nb + t] * v[r];
+                    vv[t] += V[r * nb + t] * v[r];
+                }
+            T_elem wv(0);
+            for(std::size_t r=k+1; r<n; ++r)
+            {
+                T_elem& w = W[r * nb + i];
+                for(std::size_t t=0; t<i; ++t)
+                    w -= V[r * nb + t] * vw[t] + W[r * nb + t] * vv[t];
+                w *= tau[k];
+                wv += w * v[r];
+            }
+            const T_elem alpha = -tau[k] * wv / 2;
+            for(std::size_t r=k+1; r<n; ++r) W[r * nb + i] += alpha * v[r];
+        }
+
+        // A22 -= [V W] * [W V]^T on the lower triangle, by block rows
+        const std::size_t k1 = k0 + kb;
+        if(k1 < n)
+        {
+            for(std::size_t r=k1; r<n; ++r)
+            {
+                const auto vr = V.begin() + r * nb;
+                const auto wr = W.begin() + r * nb;
+                std::copy(vr, vr + kb, std::copy(wr, wr + kb, Y.begin() + r * 2 * kb));
+                std::copy(wr, wr + kb, std::copy(vr, vr + kb, X.begin() + r * 2 * kb));
+            }
+            const std::size_t m = n - k1;
+            const std::size_t nbr = 2 * nb;
+            for(std::size_t r0=0; r0<m; r0+=nbr)
+            {
+                const std::size_t r1 = std::min(m, r0 + nbr);
+                gemm<T_elem>(r1 - r0, r1, 2 * kb, T_elem(-1),
+                             X.data() + (k1 + r0) * 2 * kb, 2 * kb, 1,
+                             Y.data() + k1 * 2 * kb, 1, 2 * kb,
+                             T_elem(1), a + (k1 + r0) * ld + k1, ld);
+            }
+        }
+    }
+    return;
+}
+
+// zt <- zt * Q^T where Q = H_0 * H_1 * ... * H_{n-3} are the reflectors
+// left by tridiagonalize. the rows of zt are eigenvectors of T on entry and
+// of A on return. the reflectors are applied by blocks, last block first,
+// as zt - (zt * V) * T_b^T * V^T.
+template<typename T_elem>
+void tridiagonal_back_transform(const T_elem* const a, const std::size_t ld,
+        const std::size_t n, const T_elem* const tau,
+        T_elem* const zt, const std::size_t ldz, const std::size_t nrow)
+{
+    if(n < 3) return;
+    const std::size_t nb = AX_TRIDIAGONAL_BLOCK_SIZE;
+    const std::size_t nref = n - 2;
+    gemm_buffer<T_elem> V(n * nb), Y(nrow * nb);
+    std::vector<T_elem> Tb(nb * nb), tmp(nb);
+
+    const std::size_t nblock = (nref + nb - 1) / nb;
+    for(std::size_t blk=nblock; blk-- > 0;)
+    {
+        const std::size_t j0 = blk * nb;
+        const std::size_t jb = std::min(nb, nref - j0);
+        const std::size_t r0 = j0 + 1; // the first row touched by the block
+
+        std::fill(V.begin(), V.end(), T_elem(0));
+        for(std::size_t i=0; i<jb; ++i)
+        {
+            const std::size_t j = j0 + i;
+            if(tau[j] == T_elem(0)) continue;
+            V[(j+1) * nb + i] = T_elem(1);
+            for(std::size_t r=j+2; r<n; ++r) V[r * nb + i] = a[r * ld + j];
+        }
+
+        // H_{j0} * ... * H_{j0+jb-1} = I - V * T_b * V^T, T_b upper
+        std::fill(Tb.begin(), Tb.end(), T_elem(0));
+        for(std::size_t i=0; i<jb; ++i)
+        {
+            const T_elem t = tau[j0 + i];
+            Tb[i * nb + i] = t;
+            if(t == T_elem(0)) continue;
+            std::fill(tmp.begin(), tmp.end(), T_elem(0));
+            for(std::size_t r=j0+i+1; r<n; ++r)
+                for(std::size_t p=0; p<i; ++p)
+                    tmp[p] += V[r * nb + p] * V[r * nb + i];
+            for(std::size_t p=0; p<i; ++p)
+            {
+                T_elem sum(0);
+                for(std::size_t q=p; q<i; ++q) sum += Tb[p * nb + q] * tmp[q];
+                Tb[p * nb + i] = -t * sum;
+            }
+        }
+
+        const std::size_t m = n - r0;
+        gemm<T_elem>(nrow, jb, m, T_elem(1), zt + r0, ldz, 1,
+                     V.data() + r0 * nb, nb, 1, T_elem(0), Y.data(), nb);
+        for(std::size_t r=0; r<nrow; ++r)
+        {
+            T_elem* const y = Y.data() + r * nb;
+            for(std::size_t i=0; i<jb; ++i)
+            {
+                T_elem sum(0);
+                for(std::size_t q=i; q<jb; ++q) sum += y[q] * Tb[i * nb + q];
+                y[i] = sum;
+            }
+        }
+        gemm<T_elem>(nrow, m, jb, T_elem(-1), Y.data(), nb, 1,
+                     V.data() + r0 * nb, 1, nb, T_elem(1), zt + r0, ldz);
+    }
+    return;
+}
+
+// applies the rotations (cs[2(j-l)], cs[2(j-l)+1]) for j = m-1 down to l of
+// one QL step to the rows l..m of the row major strip z of width w. the row
+// shared by consecutive rotations stays in registers, four packets at a
+// time, so every row is read and written once per step.
+template<typename T_elem>
+void ql_rotate_rows(T_elem* const z, const std::size_t w,
+                    const T_elem* const cs, const std::size_t l, const std::size_t m)
+{
+    using traits = packet_traits<T_elem>;
+    constexpr std::size_t lanes = traits::size;
+    std::size_t k = 0;
+    for(; k + 4 * lanes <= w; k += 4 * lanes)
+    {
+        auto y0 = traits::load(z + m * w + k);
+        auto y1 = traits::load(z + m * w + k + lanes);
+        auto y2 = traits::load(z + m * w + k + 2 * lanes);
+        auto y3 = traits::load(z + m * w + k + 3 * lanes);
+        for(std::size_t j=m; j-- > l;)
+        {
+            const auto c = traits::broadcast(cs[2 * (j - l)]);
+            const auto s = traits::broadcast(cs[2 * (j - l) + 1]);
+            const T_elem* const x  = z + j * w + k;
+            T_elem*       const z1 = z + (j+1) * w + k;
+            const auto x0 = traits::load(x);
+            const auto x1 = traits::load(x + lanes);
+            const auto x2 = traits::load(x + 2 * lanes);
+            const auto x3 = traits::load(x + 3 * lanes);
+            traits::store(z1,             packet_add(packet_mul(s, x0), packet_mul(c, y0)));
+            traits::store(z1 + lanes,     packet_add(packet_mul(s, x1), packet_mul(c, y1)));
+            traits::store(z1 + 2 * lanes, packet_add(packet_mul(s, x2), packet_mul(c, y2)));
+            traits::store(z1 + 3 * lanes, packet_add(packet_mul(s, x3), packet_mul(c, y3)));
+            y0 = packet_sub(packet_mul(c, x0), packet_mul(s, y0));
+            y1 = packet_sub(packet_mul(c, x1), packet_mul(s, y1));
+            y2 = packet_sub(packet_mul(c, x2), packet_mul(s, y2));
+            y3 = packet_sub(packet_mul(c, x3), packet_mul(s, y3));
+        }
+        traits::store(z + l * w + k,             y0);
+        traits::store(z + l * w + k + lanes,     y1);
+        traits::store(z + l * w + k + 2 * lanes, y2);
+        traits::store(z + l * w + k + 3 * lanes, y3);
+    }
+    for(; k<w; ++k)
+    {
+        T_elem y = z[m * w + k];
+        for(std::size_t j=m; j-- > l;)
+        {
+            const T_elem c = cs[2 * (j - l)];
+            const T_elem s = cs[2 * (j - l) + 1];
+            const T_elem x = z[j * w + k];
+            z[(j+1) * w + k] = s * x + c * y;
+            y = c * x - s * y;
+        }
+        z[l * w + k] = y;
+    }
+    return;
+}
+
+// the rotations of consecutive QL steps, kept until they are applied to the
+// eigenvectors together. the QL iteration never reads the eigenvectors, so
+// a strip of columns can take all steps of a batch while it is in cache.
+template<typename T_elem>
+struct ql_rotation_batch
+{
+    std::vector<T_elem>      cs;    // (c, s) pairs, step after step
+    std::vector<std::size_t> first; // rows first[i]..last[i] for step i
+    std::vector<std::size_t> last;
+    std::vector<std::size_t> offset;
+
+    std::size_t size() const {return first.size();}
+
+    T_elem* push(const std::size_t l, const std::size_t m)
+    {
+        first.push_back(l);
+        last.push_back(m);
+        offset.push_back(cs.size());
+        cs.resize(cs.size() + 2 * (m - l));
+        return cs.data() + offset.back();
+    }
+
+    // the rotations of the last step are for rows l..m only
+    void shrink(const std::size_t l)
+    {
+        const std::size_t skip = 2 * (l - first.back());
+        std::copy(cs.begin() + offset.back() + skip, cs.end(),
+                  cs.begin() + offset.back());
+        cs.resize(cs.size() - skip);
+        first.back() = l;
+    }
+
+    void apply(T_elem* const zt, const std::size_t ldz, const std::size_t ncol)
+    {
+        const std::size_t nstep = this->size();
+        if(nstep == 0) return;
+        const std::size_t chunk = AX_QL_CHUNK_SIZE;
+        const std::size_t nchunk = (ncol + chunk - 1) / chunk;
+        const std::size_t lo = *std::min_element(first.begin(), first.end());
+        const std::size_t hi = *std::max_element(last.begin(), last.end()) + 1;
+        eigen_for_chunks(nchunk, cs.size() * ncol * 4, [&](const std::size_t ch)
+        {
+            // the strip is copied out so that its rows are contiguous
+            const std::size_t c0 = ch * chunk;
+            const std::size_t w  = std::min(ncol, c0 + chunk) - c0;
+            std::vector<T_elem>& strip = scratch_buffer<std::vector<T_elem>>();
+            strip.resize((hi - lo) * w);
+            for(std::size_t r=lo; r<hi; ++r)
+                std::copy(zt + r * ldz + c0, zt + r * ldz + c0 + w,
+                          strip.begin() + (r - lo) * w);
+            for(std::size_t i=0; i<nstep; ++i)
+                ql_rotate_rows(strip.data(), w, cs.data() + offset[i],
+                               first[i] - lo, last[i] - lo);
+            for(std::size_t r=lo; r<hi; ++r)
+                std::copy(strip.begin() + (r - lo) * w, strip.begin() + (r - lo + 1) * w,
+                          zt + r * ldz + c0);
+        });
+        cs.clear();
+        first.clear();
+        last.clear();
+        offset.clear();
+        return;
+    }
+};
+
+// implicit QL with Wilkinson shifts on the symmetric tridiagonal matrix
+// with diagonal d and off-diagonal e (e[i] couples i and i+1, e[n-1] = 0).
+// d is overwritten by the unsorted eigenvalues and e is destroyed. if zt is
+// not null, the rotations are applied to its rows (ncol columns each),
+// AX_QL_BATCH_SIZE steps at a time.
+// returns false if an eigenvalue needs more than max_iter steps.
+template<typename T_elem>
+bool tridiagonal_ql(T_elem* const d, T_elem* const e, const std::size_t n,
+                    T_elem* const zt, const std::size_t ldz, const std::size_t ncol,
+                    const std::size_t max_iter)
+{
+    if(n == 0) return true;
+    e[n-1] = T_elem(0);
+    const T_elem eps = std::numeric_limits<T_elem>::epsilon();
+    ql_rotation_batch<T_elem> batch;
+
+    for(std::size_t l=0; l<n; ++l)
+    {
+        std::size_t iter = 0;
+        std::size_t m;
+        do
+        {
+            for(m=l; m+1<n; ++m)
+            {
+                const T_elem dd = std::abs(d[m]) + std::abs(d[m+1]);
+                if(std::abs(e[m]) <= eps * dd) break;
+            }
+            if(m == l) break;
+            if(iter++ == max_iter)
+            {
+                if(zt != nullptr) batch.apply(zt, ldz, ncol);
+                return false;
+            }
+
+            T_elem* const cs = (zt != nullptr) ? batch.push(l, m) : nullptr;
+            T_elem g = (d[l+1] - d[l]) / (2 * e[l]);
+            T_elem r = std::hypot(g, T_elem(1));
+            g = d[m] - d[l] + e[l] / (g + (g < T_elem(0) ? -r : r));
+            T_elem s(1), c(1), p(0);
+            bool underflow = false;
+            std::size_t i = m;
+            while(i-- > l)
+            {
+                const T_elem f = s * e[i];
+                const T_elem b = c * e[i];
+                r = std::hypot(f, g);
+                e[i+1] = r;
+                if(r == T_elem(0))
+                {
+                    d[i+1] -= p;
+                    e[m] = T_elem(0);
+                    underflow = true;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i+1] - p;
+                r = (d[i] - g) * s + 2 * c * b;
+                p = s * r;
+                d[i+1] = g + p;
+                g = c * r - b;
+                if(cs != nullptr)
+                {
+                    cs[2 * (i - l)]     = c;
+                    cs[2 * (i - l) + 1] = s;
+                }
+            }
+            if(zt != nullptr)
+            {
+                // after an underflow only the rotations of rows i+1..m were made
+                if(underflow) batch.shrink(i + 1);
+                if(batch.size() == AX_QL_BATCH_SIZE) batch.apply(zt, ldz, ncol);
+            }
+            if(underflow) continue;
+            d[l] -= p;
+            e[l] = g;
+            e[m] = T_elem(0);
+        }
+        while(m != l);
+    }
+    if(zt != nullptr) batch.apply(zt, ldz, ncol);
+    return true;
+}
+
+}// detail
+
+template <typename T_elem>
+class HouseholderQL<Matrix<T_elem, DYNAMIC, DYNAMIC>>
+{
+  public:
+    // traits
+    using elem_t = T_elem;
+    constexpr static dimension_type dim = DYNAMIC;
+
+    using matrix_type = Matrix<elem_t, DYNAMIC, DYNAMIC>;
+    using vector_type = Vector<elem_t, DYNAMIC>;
+    using eigenvalue_type = elem_t;
+    using eigenvector_type = vector_type;
+    using eigenpair_type = std::pair<elem_t, vector_type>;
+
+    constexpr static elem_t ABS_TOLERANCE = 1e-10;
+    constexpr static std::size_t MAX_ITERATION = 30; // QL steps per eigenvalue
+
+  public:
+    HouseholderQL(){}
+    ~HouseholderQL() = default;
+
+    template<class T_mat, typename std::enable_if<
+        is_matrix_expression<typename T_mat::tag>::value
+        >::type*& = enabler>
+    HouseholderQL(const T_mat& mat) : matrix_(mat){}
+
+    // eigenpairs in ascending order of the eigenvalues
+    std::vector<eigenpair_type> solve() const;
+    // eigenvalues alone in ascending order, without the O(n^3) eigenvector work
+    std::vector<elem_t> eigenvalues() const;
+
+    matrix_type const& matrix() const {return this->matrix_;}
+    matrix_type&       matrix()       {return this->matrix_;}
+
+  private:
+
+    void check() const;
+
+  private:
+
+    matrix_type matrix_;
+};
+
+template <typename T_elem>
+void HouseholderQL<Matrix<T_elem, DYNAMIC, DYNAMIC>>::check() const
+{
+    if(dimension_row(matrix_) != dimension_col(matrix_))
+        throw std::invalid_argument("HouseholderQL: not square matrix");
+    const std::size_t n = dimension_row(matrix_);
+    for(std::size_t i(0); i+1<n; ++i)
+        for(std::size_t j(i+1); j<n; ++j)
+            if(std::abs(matrix_(i,j) - matrix_(j,i)) > ABS_TOLERANCE)
+                throw std::invalid_argument("HouseholderQL: asymmetric matrix");
+    return;
+}
+
+template <typename T_elem>
+std::vector<T_elem>
+HouseholderQL<Matrix<T_elem, DYNAMIC, DYNAMIC>>::eigenvalues() const
+{
+    this->check();
+    const std::size_t n = dimension_row(matrix_);
+    matrix_type target(matrix_);
+    std::vector<elem_t> d(n), e(n), tau(n);
+    detail::tridiagonalize(target.data(), target.stride(), n,
+                           d.data(), e.data(), tau.data());
+    if(!detail::tridiagonal_ql<elem_t>(d.data(), e.data(), n, nullptr, 0, 0,
+                                       MAX_ITERATION))
+        throw std::runtime_error("HouseholderQL: no convergence");
+    std::sort(d.begin(), d.end());
+    return d;
+}
+
+template <typename T_elem>
+std::vector<typename HouseholderQL<Matrix<T_elem, DYNAMIC, DYNAMIC>>::eigenpair_type>
+HouseholderQL<Matrix<T_elem, DYNAMIC, DYNAMIC>>::solve() const
+{
+    this->check();
+    const std::size_t n = dimension_row(matrix_);
+    matrix_type target(matrix_);
+    std::vector<elem_t> d(n), e(n), tau(n);
+    detail::tridiagonalize(target.data(), target.stride(), n,
+                           d.data(), e.data(), tau.data());
+
+    // row i of Zt is the i-th eigenvector
+    matrix_type Zt(n, n);
+    for(std::size_t i(0); i<n; ++i) Zt(i,i) = 1e0;
+    if(!detail::tridiagonal_ql(d.data(), e.data(), n, Zt.data(), Zt.stride(),
+                               n, MAX_ITERATION))
+        throw std::runtime_error("HouseholderQL: no convergence");
+    detail::tridiagonal_back_transform(target.data(), target.stride(), n,
+                                       tau.data(), Zt.data(), Zt.stride(), n);
+
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::sort(order.begin(), order.end(),
+        [&d](const std::size_t i, const std::size_t j){return d[i] < d[j];});
+
+    std::vector<eigenpair_type> retval;
+    retval.reserve(n);
+    for(std::size_t i(0); i<n; ++i)
+    {
+        const std::size_t k = order[i];
+        vector_type evec(n);
+        for(std::size_t j(0); j<n; ++j) evec[j] = Zt(k,j);
+        retval.push_back(std::make_pair(d[k], std::move(evec)));
+    }
+    return retval;
+}
+
+// helper function
+template<typename T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value&&(
+    is_dynamic_dimension<T_mat::dim_row>::value||
+    is_dynamic_dimension<T_mat::dim_col>::value)>::type*& = enabler>
+std::vector<typename HouseholderQL<
+    Matrix<typename T_mat::elem_t, DYNAMIC, DYNAMIC>>::eigenpair_type>
+eigen_symmetric(const T_mat& mat)
+{
+    return (HouseholderQL<Matrix<typename T_mat::elem_t, DYNAMIC, DYNAMIC>>(
+                Matrix<typename T_mat::elem_t, DYNAMIC, DYNAMIC>(mat))).solve();
+}
+
+}//ax
+
+#endif //AX_SYMMETRIC_EIGEN_H
@@ -0,0 +1,483 @@
+#ifndef AX_SYMMETRIC_EIGEN_3X3_H
+#define AX_SYMMETRIC_EIGEN_3X3_H
+#include "JacobiMethod.hpp"
+#include "Matrix3Batch.hpp"
+#include <array>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+namespace ax
+{
+
+/* eigenpairs of symmetric 3x3 matrices (inertia, gyration, stress tensors).
+ * the eigenvalues are the roots of the characteristic cubic in the
+ * trigonometric form: with q = tr(A) / 3, p^2 = |A - q * I|_F^2 / 6 and
+ * B = (A - q * I) / p, they are q + 2 * p * cos(phi + 2 * pi * k / 3) where
+ * cos(3 * phi) = det(B) / 2. the eigenvectors follow from cross products of
+ * the rows of A - lambda * I (D. Eberly, "A Robust Eigensolver for 3x3
+ * Symmetric Matrices").
+ * only the upper triangle of the matrix is read.                           */
+
+namespace detail
+{
+
+// the kernels below work on plain arrays: a symmetric matrix is its upper
+// triangle {a00, a01, a02, a11, a12, a22}.
+
+template<typename T_elem>
+inline void sym3_cross(const T_elem (&x)[3], const T_elem (&y)[3], T_elem (&z)[3])
+{
+    z[0] = x[1] * y[2] - x[2] * y[1];
+    z[1] = x[2] * y[0] - x[0] * y[2];
+    z[2] = x[0] * y[1] - x[1] * y[0];
+    return;
+}
+
+template<typename T_elem>
+inline T_elem sym3_dot(const T_elem (&x)[3], const T_elem (&y)[3])
+{
+    return x[0] * y[0] + x[1] * y[1] + x[2] * y[2];
+}
+
+// y = A * x
+template<typename T_elem>
+inline void sym3_apply(const T_elem (&a)[6], const T_elem (&x)[3], T_elem (&y)[3])
+{
+    y[0] = a[0] * x[0] + a[1] * x[1] + a[2] * x[2];
+    y[1] = a[1] * x[0] + a[3] * x[1] + a[4] * x[2];
+    y[2] = a[2] * x[0] + a[4] * x[1] + a[5] * x[2];
+    return;
+}
+
+// the eigenvector for an eigenvalue l that is well separated from the
+// other two: the longest cross product of two rows of A - l * I.
+template<typename T_elem>
+void sym3_eigenvector0(const T_elem (&a)[6], const T_elem l, T_elem (&v)[3])
+{
+    const T_elem r0[3] = {a[0] - l, a[1], a[2]};
+    const T_elem r1[3] = {a[1], a[3] - l, a[4]};
+    const T_elem r2[3] = {a[2], a[4], a[5] - l};
+    T_elem c[3][3];
+    sym3_cross(r0, r1, c[0]);
+    sym3_cross(r0, r2, c[1]);
+    sym3_cross(r1, r2, c[2]);
+
+    std::size_t imax = 0;
+    T_elem dmax = sym3_dot(c[0], c[0]);
+    for(std::size_t i=1; i<3; ++i)
+    {
+        const T_elem d = sym3_dot(c[i], c[i]);
+        if(d > dmax){dmax = d; imax = i;}
+    }
+    if(dmax == T_elem(0))
+    {
+        v[0] = T_elem(1); v[1] = T_elem(0); v[2] = T_elem(0);
+        return;
+    }
+    const T_elem inv = T_elem(1) / std::sqrt(dmax);
+    for(std::size_t j=0; j<3; ++j) v[j] = c[imax][j] * inv;
+    return;
+}
+
+// the eigenvector for l orthogonal to the eigenvector v0. the problem is
+// reduced to 2x2 on the orthogonal complement of v0, which stays accurate
+// when l is a double eigenvalue.
+template<typename T_elem>
+void sym3_eigenvector1(const T_elem (&a)[6], const T_elem (&v0)[3],
+                       const T_elem l, T_elem (&v1)[3])
+{
+    T_elem u[3], w[3];
+    if(std::abs(v0[0]) > std::abs(v0[1]))
+    {
+        const T_elem inv = T_elem(1) / std::sqrt(v0[0] * v0[0] + v0[2] * v0[2]);
+        u[0] = -v0[2] * inv; u[1] = T_elem(0); u[2] = v0[0] * inv;
+    }
+    else
+    {
+        const T_elem inv = T_elem(1) / std::sqrt(v0[1] * v0[1] + v0[2] * v0[2]);
+        u[0] = T_elem(0); u[1] = v0[2] * inv; u[2] = -v0[1] * inv;
+    }
+    sym3_cross(v0, u, w);
+
+    T_elem au[3], aw[3];
+    sym3_apply(a, u, au);
+    sym3_apply(a, w, aw);
+    T_elem m00 = sym3_dot(u, au) - l;
+    T_elem m01 = sym3_dot(u, aw);
+    T_elem m11 = sym3_dot(w, aw) - l;
+
+    // null vector (x, y) of [[m00, m01], [m01, m11]] from its larger row,
+    // v1 = x * u + y * w
+    const T_elem abs00 = std::abs(m00);
+    const T_elem abs01 = std::abs(m01);
+    const T_elem abs11 = std::abs(m11);
+    T_elem x(1), y(0);
+    if(abs00 >= abs11 && std::max(abs00, abs01) > T_elem(0))
+    {
+        if(abs00 >= abs01)
+        {
+            m01 /= m00;
+            m00  = T_elem(1) / std::sqrt(1 + m01 * m01);
+            m01 *= m00;
+        }
+        else
+        {
+            m00 /= m01;
+            m01  = T_elem(1) / std::sqrt(1 + m00 * m00);
+            m00 *= m01;
+        }
+        x = m01; y = -m00;
+    }
+    else if(abs00 < abs11 && std::max(abs11, abs01) > T_elem(0))
+    {
+        if(abs11 >= abs01)
+        {
+            m01 /= m11;
+            m11  = T_elem(1) / std::sqrt(1 + m01 * m01);
+            m01 *= m11;
+        }
+        else
+        {
+            m11 /= m01;
+            m01  = T_elem(1) / std::sqrt(1 + m11 * m11);
+            m11 *= m01;
+        }
+        x = m11; y = -m01;
+    }
+    for(std::size_t j=0; j<3; ++j) v1[j] = x * u[j] + y * w[j];
+    return;
+}
+
+// cos(acos(h) / 3) for the largest root, and the other two from it
+template<typename T_elem>
+inline void sym3_roots(const T_elem half_det, T_elem& beta0, T_elem& beta1,
+                       T_elem& beta2)
+{
+    const T_elem c = std::cos(std::acos(half_det) / 3);
+    const T_elem s = std::sqrt(std::max(T_elem(0), 1 - c * c));
+    const T_elem sqrt3 = std::sqrt(T_elem(3));
+    beta2 = 2 * c;
+    beta1 = -c + sqrt3 * s;
+    beta0 = -c - sqrt3 * s;
+    return;
+}
+
+// closed form for a with max |a(i, j)| <= 1. the eigenvalues are in
+// ascending order and evecs[i] is the eigenvector of evals[i].
+template<typename T_elem>
+void sym3_closed_form(const T_elem (&a)[6], T_elem (&evals)[3], T_elem (&evecs)[3][3])
+{
+    const T_elem q   = (a[0] + a[3] + a[5]) / 3;
+    const T_elem b00 = a[0] - q;
+    const T_elem b11 = a[3] - q;
+    const T_elem b22 = a[5] - q;
+    const T_elem p2  = (b00 * b00 + b11 * b11 + b22 * b22 +
+                        2 * (a[1] * a[1] + a[2] * a[2] + a[4] * a[4])) / 6;
+    if(p2 == T_elem(0)) // q * I
+    {
+        for(std::size_t i=0; i<3; ++i)
+        {
+            evals[i] = q;
+            for(std::size_t j=0; j<3; ++j) evecs[i][j] = T_elem(i == j ? 1 : 0);
+        }
+        return;
+    }
+    const T_elem p = std::sqrt(p2);
+
+    const T_elem c00 = b11 * b22 - a[4] * a[4];
+    const T_elem c01 = a[1] * b22 - a[4] * a[2];
+    const T_elem c02 = a[1] * a[4] - b11 * a[2];
+    const T_elem det = (b00 * c00 - a[1] * c01 + a[2] * c02) / (p2 * p);
+    const T_elem half_det = std::min(std::max(det / 2, T_elem(-1)), T_elem(1));
+
+    T_elem beta0, beta1, beta2;
+    sym3_roots(half_det, beta0, beta1, beta2);
+    evals[0] = q + p * beta0;
+    evals[1] = q + p * beta1;
+    evals[2] = q + p * beta2;
+
+    // start from the eigenvalue farther from the middle one
+    if(half_det >= T_elem(0))
+    {
+        sym3_eigenvector0(a, evals[2], evecs[2]);
+        sym3_eigenvector1(a, evecs[2], evals[1], evecs[1]);
+        sym3_cross(evecs[1], evecs[2], evecs[0]);
+    }
+    else
+    {
+        sym3_eigenvector0(a, evals[0], evecs[0]);
+        sym3_eigenvector1(a, evecs[0], evals[1], evecs[1]);
+        sym3_cross(evecs[0], evecs[1], evecs[2]);
+    }
+    return;
+}
+
+}// detail
+
+// eigenpairs of the symmetric 3x3 mat in ascending order of the eigenvalue.
+// the closed form result is checked with V^T * A * V: its diagonal gives
+// the eigenvalues, and if its off-diagonal part is larger than rounding
+// (the closed form lost precision) a few Jacobi sweeps starting from V
+// finish the job.
+template<class T_mat, typename std::enable_if<
+    is_matrix_expression<typename T_mat::tag>::value&&
+    is_same_dimension<T_mat::dim_row, 3>::value&&
+    is_same_dimension<T_mat::dim_col, 3>::value>::type*& = enabler>
+std::array<std::pair<typename T_mat::elem_t, Vector<typename T_mat::elem_t, 3>>, 3>
+eigen_symmetric3x3(const T_mat& mat)
+{
+    using elem_t = typename T_mat::elem_t;
+    constexpr elem_t eps = std::numeric_limits<elem_t>::epsilon();
+
+    std::array<std::pair<elem_t, Vector<elem_t, 3>>, 3> retval;
+    elem_t a[6] = {mat(0,0), mat(0,1), mat(0,2), mat(1,1), mat(1,2), mat(2,2)};
+    elem_t scale(0);
+    for(std::size_t i=0; i<6; ++i) scale = std::max(scale, std::abs(a[i]));
+    if(scale == elem_t(0))
+    {
+        for(std::size_t i=0; i<3; ++i)
+        {
+            retval[i].first = elem_t(0);
+            retval[i].second[i] = elem_t(1);
+        }
+        return retval;
+    }
+    const elem_t inv = elem_t(1) / scale;
+    for(std::size_t i=0; i<6; ++i) a[i] *= inv;
+
+    elem_t evals[3], evecs[3][3];
+    detail::sym3_closed_form(a, evals, evecs);
+
+    // D = V^T * A * V with the eigenvectors as the columns of V
+    elem_t av[3][3];
+    for(std::size_t i=0; i<3; ++i) detail::sym3_apply(a, evecs[i], av[i]);
+    Matrix<elem_t, 3, 3> D;
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=i; j<3; ++j)
+            D(i, j) = D(j, i) = detail::sym3_dot(evecs[i], av[j]);
+
+    std::array<std::size_t, 3> order = {{0, 1, 2}};
+    const elem_t off = std::max(std::max(std::abs(D(0,1)), std::abs(D(0,2))),
+                                std::abs(D(1,2)));
+    if(off > 64 * eps)
+    {
+        // rows of W are the eigenvectors, as in detail::jacobi_sweeps
+        Matrix<elem_t, 3, 3> W;
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+                W(i, j) = evecs[i][j];
+        detail::jacobi_sweeps(D.data(), D.stride(), W.data(), W.stride(), 3,
+                              eps, eps, 8);
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+                evecs[i][j] = W(i, j);
+    }
+    // the Rayleigh quotients of a (nearly) double eigenvalue may come out
+    // in either order
+    std::sort(order.begin(), order.end(), [&D](const std::size_t i,
+              const std::size_t j){return D(i,i) < D(j,j);});
+
+    for(std::size_t i=0; i<3; ++i)
+    {
+        retval[i].first = D(order[i], order[i]) * scale;
+        for(std::size_t j=0; j<3; ++j)
+            retval[i].second[j] = evecs[order[i]][j];
+    }
+    return retval;
+}
+
+namespace detail
+{
+
+// eigenvector of a - l * I from the longest cross product of its rows, for
+// packet_traits<T>::size matrices at once. norm2 is the squared length of
+// that cross product; if it is small, l is (nearly) a multiple eigenvalue.
+template<typename T_packet>
+void sym3_eigenvector_packet(const T_packet (&a)[6], const T_packet& l,
+                             T_packet (&v)[3], T_packet& norm2)
+{
+    // a = {a00, a01, a02, a11, a12, a22}
+    const T_packet r0[3] = {packet_sub(a[0], l), a[1], a[2]};
+    const T_packet r1[3] = {a[1], packet_sub(a[3], l), a[4]};
+    const T_packet r2[3] = {a[2], a[4], packet_sub(a[5], l)};
+
+    T_packet c[3][3];
+    const T_packet* const rows[3][2] = {{r0, r1}, {r0, r2}, {r1, r2}};
+    T_packet d[3];
+    for(std::size_t i=0; i<3; ++i)
+    {
+        const T_packet* x = rows[i][0];
+        const T_packet* y = rows[i][1];
+        c[i][0] = packet_sub(packet_mul(x[1], y[2]), packet_mul(x[2], y[1]));
+        c[i][1] = packet_sub(packet_mul(x[2], y[0]), packet_mul(x[0], y[2]));
+        c[i][2] = packet_sub(packet_mul(x[0], y[1]), packet_mul(x[1], y[0]));
+        d[i] = packet_add(packet_add(packet_mul(c[i][0], c[i][0]),
+                          packet_mul(c[i][1], c[i][1])), packet_mul(c[i][2], c[i][2]));
+    }
+
+    norm2 = d[0];
+    for(std::size_t j=0; j<3; ++j) v[j] = c[0][j];
+    for(std::size_t i=1; i<3; ++i)
+    {
+        for(std::size_t j=0; j<3; ++j)
+            v[j] = packet_select_greater(d[i], norm2, c[i][j], v[j]);
+        norm2 = packet_select_greater(d[i], norm2, d[i], norm2);
+    }
+    return;
+}
+
+template<typename T_elem>
+std::size_t sym3_batch(const Matrix3Batch<T_elem>& mats,
+                       std::array<std::vector<T_elem>, 3>& values,
+                       Matrix3Batch<T_elem>& vectors)
+{
+    using traits = packet_traits<T_elem>;
+    using packet = typename traits::type;
+    constexpr std::size_t lanes = traits::size;
+
+    const packet zero  = traits::broadcast(T_elem(0));
+    const packet one   = traits::broadcast(T_elem(1));
+    const packet third = traits::broadcast(T_elem(1) / 3);
+    const packet sixth = traits::broadcast(T_elem(1) / 6);
+    // a cross product shorter than this means a (nearly) double eigenvalue
+    const packet tol   = traits::broadcast(
+            std::sqrt(std::numeric_limits<T_elem>::epsilon()));
+    constexpr int all_lanes = (1 << lanes) - 1;
+
+    if(vectors.size() != mats.size()) vectors = Matrix3Batch<T_elem>(mats.size());
+    for(std::size_t i=0; i<3; ++i) values[i].resize(mats.stride());
+
+    std::vector<std::size_t> fallback;
+    T_elem half_det[lanes], beta[3][lanes];
+    for(std::size_t k=0; k<mats.stride(); k+=lanes)
+    {
+        packet a[6] = {
+            traits::load(mats.component(0, 0) + k),
+            traits::load(mats.component(0, 1) + k),
+            traits::load(mats.component(0, 2) + k),
+            traits::load(mats.component(1, 1) + k),
+            traits::load(mats.component(1, 2) + k),
+            traits::load(mats.component(2, 2) + k)};
+
+        packet scale = zero;
+        for(std::size_t i=0; i<6; ++i)
+        {
+            const packet abs = packet_abs(a[i]);
+            scale = packet_select_greater(abs, scale, abs, scale);
+        }
+        const packet inv = packet_div(one,
+                packet_select_greater(scale, zero, scale, one));
+        for(std::size_t i=0; i<6; ++i) a[i] = packet_mul(a[i], inv);
+
+        const packet q   = packet_mul(packet_add(packet_add(a[0], a[3]), a[5]), third);
+        const packet b00 = packet_sub(a[0], q);
+        const packet b11 = packet_sub(a[3], q);
+        const packet b22 = packet_sub(a[5], q);
+        const packet off = packet_add(packet_add(packet_mul(a[1], a[1]),
+                           packet_mul(a[2], a[2])), packet_mul(a[4], a[4]));
+        const packet p2  = packet_mul(sixth, packet_add(packet_add(packet_add(
+            packet_mul(b00, b00), packet_mul(b11, b11)), packet_mul(b22, b22)),
+            packet_add(off, off)));
+        const packet p   = packet_sqrt(p2);
+        const packet p3  = packet_select_greater(p2, zero, packet_mul(p2, p), one);
+
+        const packet c00 = packet_sub(packet_mul(b11, b22), packet_mul(a[4], a[4]));
+        const packet c01 = packet_sub(packet_mul(a[1], b22), packet_mul(a[4], a[2]));
+        const packet c02 = packet_sub(packet_mul(a[1], a[4]), packet_mul(b11, a[2]));
+        const packet det = packet_add(packet_sub(packet_mul(b00, c00),
+                           packet_mul(a[1], c01)), packet_mul(a[2], c02));
+        traits::store(half_det, packet_div(det, packet_add(p3, p3)));
+
+        for(std::size_t l=0; l<lanes; ++l)
+        {
+            half_det[l] = std::min(std::max(half_det[l], T_elem(-1)), T_elem(1));
+            sym3_roots(half_det[l], beta[0][l], beta[1][l], beta[2][l]);
+        }
+        packet lambda[3];
+        for(std::size_t i=0; i<3; ++i)
+            lambda[i] = packet_add(q, packet_mul(p, traits::load(beta[i])));
+
+        // the eigenvalue farther from the middle one (the largest if h >= 0)
+        // and the one at the other end
+        const packet h    = traits::load(half_det);
+        const packet lsep = packet_select_greater(zero, h, lambda[0], lambda[2]);
+        const packet lend = packet_select_greater(zero, h, lambda[2], lambda[0]);
+
+        packet vs[3], ve[3], ns, ne;
+        sym3_eigenvector_packet(a, lsep, vs, ns);
+        sym3_eigenvector_packet(a, lend, ve, ne);
+
+        // both cross products long enough, otherwise the scalar path
+        const int regular = packet_greater_mask(ns, tol) & packet_greater_mask(ne, tol);
+        if(regular != all_lanes)
+            for(std::size_t l=0; l<lanes && k + l < mats.size(); ++l)
+                if(!((regular >> l) & 1)) fallback.push_back(k + l);
+
+        const packet safe_ns = packet_select_greater(ns, zero, ns, one);
+        const packet rs = packet_div(one, packet_sqrt(safe_ns));
+        for(std::size_t j=0; j<3; ++j) vs[j] = packet_mul(vs[j], rs);
+
+        // orthogonalize against vs before normalizing
+        const packet proj = packet_add(packet_add(packet_mul(ve[0], vs[0]),
+                            packet_mul(ve[1], vs[1])), packet_mul(ve[2], vs[2]));
+        for(std::size_t j=0; j<3; ++j)
+            ve[j] = packet_sub(ve[j], packet_mul(proj, vs[j]));
+        const packet len2 = packet_add(packet_add(packet_mul(ve[0], ve[0]),
+                            packet_mul(ve[1], ve[1])), packet_mul(ve[2], ve[2]));
+        const packet re = packet_div(one,
+                packet_sqrt(packet_select_greater(len2, zero, len2, one)));
+        for(std::size_t j=0; j<3; ++j) ve[j] = packet_mul(ve[j], re);
+
+        const packet vm[3] = {
+            packet_sub(packet_mul(vs[1], ve[2]), packet_mul(vs[2], ve[1])),
+            packet_sub(packet_mul(vs[2], ve[0]), packet_mul(vs[0], ve[2])),
+            packet_sub(packet_mul(vs[0], ve[1]), packet_mul(vs[1], ve[0]))};
+
+        // columns: 0 <- smallest, 1 <- middle, 2 <- largest
+        for(std::size_t j=0; j<3; ++j)
+        {
+            traits::store(vectors.component(j, 0) + k,
+                          packet_select_greater(zero, h, vs[j], ve[j]));
+            traits::store(vectors.component(j, 1) + k, vm[j]);
+            traits::store(vectors.component(j, 2) + k,
+                          packet_select_greater(zero, h, ve[j], vs[j]));
+        }
+        for(std::size_t i=0; i<3; ++i)
+            traits::store(values[i].data() + k, packet_mul(lambda[i], scale));
+    }
+
+    for(std::size_t i=0; i<3; ++i) values[i].resize(mats.size());
+    for(std::size_t idx=0; idx<fallback.size(); ++idx)
+    {
+        const std::size_t k = fallback[idx];
+        const auto eigenpair = eigen_symmetric3x3(mats.matrix(k));
+        for(std::size_t i=0; i<3; ++i)
+        {
+            values[i][k] = eigenpair[i].first;
+            for(std::size_t j=0; j<3; ++j)
+                vectors(k, j, i) = eigenpair[i].second[j];
+        }
+    }
+    return fallback.size();
+}
+
+}// detail
+
+// eigenpairs of every symmetric matrix of the batch at once, SIMD lanes
+// across matrices. values[i][k] is the i-th smallest eigenvalue of the k-th
+// matrix and column i of vectors.matrix(k) its eigenvector. matrices with a
+// (nearly) multiple eigenvalue, where the cross products of the closed form
+// lose precision, are redone with eigen_symmetric3x3. returns their number.
+template<typename T_elem>
+inline std::size_t
+eigen_symmetric3x3(const Matrix3Batch<T_elem>& mats,
+                   std::array<std::vector<T_elem>, 3>& values,
+                   Matrix3Batch<T_elem>& vectors)
+{
+    return detail::sym3_batch(mats, values, vectors);
+}
+
+}// ax
+#endif /* AX_SYMMETRIC_EIGEN_3X3_H */
@@ -0,0 +1,219 @@
+#ifndef AX_THREAD_POOL_H
+#define AX_THREAD_POOL_H
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <vector>
+#include <cstdlib>
+#include <cstddef>
+
+// problems with less work than this (counted in multiply-adds) run on the
+// calling thread only.
+#ifndef AX_PARALLEL_THRESHOLD
+#define AX_PARALLEL_THRESHOLD 2097152
+#endif
+
+namespace ax
+{
+
+// fixed set of worker threads. parallel_for(n, f) calls f(0) ... f(n-1)
+// and returns when all of them have finished. the calling thread takes
+// part in the work. which thread runs which index is unspecified, so a
+// task must write only to the part of the output that its index owns.
+class ThreadPool
+{
+  public:
+
+    explicit ThreadPool(const std::size_t num_threads)
+        : job_(nullptr), num_tasks_(0), next_(0), working_(0),
+          generation_(0), stop_(false)
+    {
+        for(std::size_t i=1; i<num_threads; ++i)
+            workers_.emplace_back(&ThreadPool::work, this);
+    }
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for(auto& worker : workers_) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // number of threads including the caller
+    std::size_t size() const {return workers_.size() + 1;}
+
+    void parallel_for(const std::size_t num_tasks,
+                      const std::function<void(std::size_t)>& task)
+    {
+        // a task that calls parallel_for again runs its children in serial
+        if(workers_.empty() || num_tasks < 2 || in_worker())
+        {
+            for(std::size_t i=0; i<num_tasks; ++i) task(i);
+            return;
+        }
+
+        // calls from different external threads are served one at a time
+        std::lock_guard<std::mutex> call_lock(call_mtx_);
+        std::unique_lock<std::mutex> lock(mtx_);
+        job_       = &task;
+        num_tasks_ = num_tasks;
+        next_      = 0;
+        working_   = workers_.size();
+        error_     = nullptr;
+        ++generation_;
+        lock.unlock();
+        start_.notify_all();
+
+        this->run_tasks();
+
+        lock.lock();
+        finish_.wait(lock, [this]{return working_ == 0;});
+        job_ = nullptr;
+        if(error_) std::rethrow_exception(error_);
+        return;
+    }
+
+  private:
+
+    static bool& in_worker()
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    void run_tasks()
+    {
+        const bool outer = in_worker();
+        in_worker() = true;
+        while(true)
+        {
+            const std::size_t i = next_.fetch_add(1);
+            if(i >= num_tasks_) break;
+            try
+            {
+                (*job_)(i);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if(!error_) error_ = std::current_exception();
+            }
+        }
+        in_worker() = outer;
+        return;
+    }
+
+    void work()
+    {
+        std::size_t seen = 0;
+        while(true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                start_.wait(lock, [&]{return stop_ || generation_ != seen;});
+                if(stop_) return;
+                seen = generation_;
+            }
+            this->run_tasks();
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                --working_;
+            }
+            finish_.notify_one();
+        }
+    }
+
+  private:
+
+    std::vector<std::thread> workers_;
+    std::mutex               call_mtx_;
+    std::mutex               mtx_;
+    std::condition_variable  start_;
+    std::condition_variable  finish_;
+
+    const std::function<void(std::size_t)>* job_;
+    std::size_t              num_tasks_;
+    std::atomic<std::size_t> next_;
+    std::size_t              working_;
+    std::size_t              generation_;
+    bool                     stop_;
+    std::exception_ptr       error_;
+};
+
+namespace detail
+{
+
+struct parallel_config
+{
+    std::size_t num_threads;
+    std::size_t threshold;
+    std::unique_ptr<ThreadPool> pool;
+    std::mutex mtx;
+
+    // AX_NUM_THREADS environment variable overrides the number of cores
+    parallel_config()
+        : num_threads(std::thread::hardware_concurrency()),
+          threshold(AX_PARALLEL_THRESHOLD)
+    {
+        if(const char* env = std::getenv("AX_NUM_THREADS"))
+            num_threads = std::strtoul(env, nullptr, 10);
+        if(num_threads == 0) num_threads = 1;
+    }
+};
+
+inline parallel_config& get_parallel_config()
+{
+    static parallel_config config;
+    return config;
+}
+
+}// detail
+
+// number of threads used by the parallel kernels (GEMM, LU, ...).
+inline std::size_t get_num_threads()
+{
+    return detail::get_parallel_config().num_threads;
+}
+
+// the pool is rebuilt lazily. do not call this while a kernel is running.
+inline void set_num_threads(const std::size_t num)
+{
+    auto& config = detail::get_parallel_config();
+    std::lock_guard<std::mutex> lock(config.mtx);
+    config.num_threads = (num == 0) ? 1 : num;
+    config.pool.reset();
+    return;
+}
+
+// minimum amount of work (number of multiply-adds) to go parallel
+inline std::size_t get_parallel_threshold()
+{
+    return detail::get_parallel_config().threshold;
+}
+
+inline void set_parallel_threshold(const std::size_t threshold)
+{
+    detail::get_parallel_config().threshold = threshold;
+    return;
+}
+
+inline ThreadPool& default_thread_pool()
+{
+    auto& config = detail::get_parallel_config();
+    std::lock_guard<std::mutex> lock(config.mtx);
+    if(!config.pool)
+        config.pool.reset(new ThreadPool(config.num_threads));
+    return *config.pool;
+}
+
+}// ax
+#endif /* AX_THREAD_POOL_H */
@@ -3,7 +3,7 @@
 #include <array>
 #include <vector>
 #include <iostream>
-#include "VectorExpression.hpp"
+#include "VectorAssignment.hpp"
 
 namespace ax
 {
@@ -29,6 +29,7 @@ class Vector
     Vector(const elem_t d){values_.fill(d);} 
     Vector(const container_t& v): values_(v){} 
     Vector(const self_type& v): values_(v.values_){} 
+    Vector& operator=(const Vector& v) = default;
 
     template<typename ... T_args, typename std::enable_if<
         (sizeof...(T_args) == dim) && is_all<elem_t, T_args...>::value
@@ -41,7 +42,7 @@ class Vector
         is_same_dimension<dim, T_expr::dim>::value>::type*& = enabler>
     Vector(const T_expr& expr)
     {
-        for(std::size_t i(0); i<dim; ++i) (*this)[i] = expr[i];
+        detail::assign_vector(*this, expr);
     }
 
     // from dynamic
@@ -52,7 +53,7 @@ class Vector
     {
         if(dimension(expr) != dim)
             throw std::invalid_argument("vector size different");
-        for(std::size_t i(0); i<dim; ++i) (*this)[i] = expr[i];
+        detail::assign_vector(*this, expr);
     }
 
     // from static
@@ -61,7 +62,9 @@ class Vector
         is_same_dimension<dim, T_expr::dim>::value>::type*& = enabler>
     Vector<elem_t, dim>& operator=(const T_expr& expr)
     {
-        for(auto i(0); i<dim; ++i) (*this)[i] = expr[i];
+        if(detail::alias_hazard(expr, this))
+            return detail::assign_aliased(*this, expr);
+        detail::assign_vector(*this, expr);
         return *this;
     }
 
@@ -71,9 +74,11 @@ class Vector
         is_dynamic_dimension<T_expr::dim>::value>::type*& = enabler>
     Vector<elem_t, dim>& operator=(const T_expr& expr)
     {
+        if(detail::alias_hazard(expr, this))
+            return detail::assign_aliased(*this, expr);
         if(dimension(expr) != dim)
             throw std::invalid_argument("vector size different");
-        for(auto i(0); i<dim; ++i) (*this)[i] = expr[i];
+        detail::assign_vector(*this, expr);
         return *this;
     }
 
@@ -82,7 +87,8 @@ class Vector
         is_same_dimension<dim, T_expr::dim>::value>::type*& = enabler>
     Vector<elem_t, dim>& operator+=(const T_expr& expr)
     {
-        return *this = (*this + expr);
+        detail::update_vector<detail::Add_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     template<class T_expr, typename std::enable_if<
@@ -92,7 +98,8 @@ class Vector
     {
         if(dimension(expr) != dim)
             throw std::invalid_argument("vector size different");
-        return *this = (*this + expr);
+        detail::update_vector<detail::Add_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     template<class T_expr, typename std::enable_if<
@@ -100,7 +107,8 @@ class Vector
         is_same_dimension<dim, T_expr::dim>::value>::type*& = enabler>
     Vector<elem_t, dim>& operator-=(const T_expr& expr)
     {
-        return *this = (*this - expr);
+        detail::update_vector<detail::Subtract_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     template<class T_expr, typename std::enable_if<
@@ -110,17 +118,22 @@ class Vector
     {
         if(dimension(expr) != dim)
             throw std::invalid_argument("vector size different");
-        return *this = (*this - expr);
+        detail::update_vector<detail::Subtract_Operator<elem_t, elem_t>>(*this, expr);
+        return *this;
     }
 
     Vector<elem_t, dim>& operator*=(const elem_t& expr)
     {
-        return *this = (*this * expr);
+        detail::update_linear<detail::Multiply_Operator<elem_t, elem_t>>(
+                this->data(), dim, expr);
+        return *this;
     }
 
     Vector<elem_t, dim>& operator/=(const elem_t& expr)
     {
-        return *this = (*this / expr);
+        detail::update_linear<detail::Divide_Operator<elem_t, elem_t>>(
+                this->data(), dim, expr);
+        return *this;
     }
 
     elem_t const& operator[](const std::size_t i) const
@@ -143,6 +156,16 @@ class Vector
     elem_t const& at(const std::size_t i) const {return values_.at(i);}
     elem_t&       at(const std::size_t i)       {return values_.at(i);}
 
+    elem_t const* data() const {return values_.data();}
+    elem_t*       data()       {return values_.data();}
+
+    // elements i, i+1, ... as one SIMD packet
+    constexpr static bool packet_access = true;
+    typename detail::packet_traits<elem_t>::type packet(const std::size_t i) const
+    {
+        return detail::packet_traits<elem_t>::load(values_.data() + i);
+    }
+
   private:
     container_t values_;
 };
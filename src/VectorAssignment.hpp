@@ -0,0 +1,106 @@
+#ifndef AX_VECTOR_ASSIGNMENT_H
+#define AX_VECTOR_ASSIGNMENT_H
+#include "VectorExpression.hpp"
+#include "Aliasing.hpp"
+#include "Packet.hpp"
+
+namespace ax
+{
+
+namespace detail
+{
+
+// whether dst = expr can be evaluated one SIMD packet at a time
+template<class T_dst, class T_expr>
+struct is_packet_assignable
+{
+    constexpr static bool value = has_packet_access<T_expr>::value &&
+        std::is_same<typename T_dst::elem_t, typename T_expr::elem_t>::value;
+};
+
+// dst must already have the size of expr.
+template<class T_dst, class T_expr, typename std::enable_if<
+    !is_packet_assignable<T_dst, T_expr>::value>::type*& = enabler>
+inline void assign_vector(T_dst& dst, const T_expr& expr)
+{
+    const std::size_t size = dimension(dst);
+    for(std::size_t i=0; i<size; ++i) dst[i] = expr[i];
+    return;
+}
+
+template<class T_dst, class T_expr, typename std::enable_if<
+    is_packet_assignable<T_dst, T_expr>::value>::type*& = enabler>
+inline void assign_vector(T_dst& dst, const T_expr& expr)
+{
+    using packet = packet_traits<typename T_dst::elem_t>;
+    const std::size_t size = dimension(dst);
+    typename T_dst::elem_t* const ptr = dst.data();
+
+    std::size_t i=0;
+    for(; i + packet::size <= size; i += packet::size)
+        packet::store(ptr + i, expr.packet(i));
+    for(std::size_t r=size-i; r!=0; --r, ++i)
+        ptr[i] = expr[i];
+    return;
+}
+
+// dst[i] = T_oper::apply(dst[i], expr[i]) in place.
+// dst must already have the size of expr.
+template<class T_oper, class T_dst, class T_expr, typename std::enable_if<
+    !is_packet_assignable<T_dst, T_expr>::value>::type*& = enabler>
+inline void update_vector_elementwise(T_dst& dst, const T_expr& expr)
+{
+    const std::size_t size = dimension(dst);
+    for(std::size_t i=0; i<size; ++i) dst[i] = T_oper::apply(dst[i], expr[i]);
+    return;
+}
+
+template<class T_oper, class T_dst, class T_expr, typename std::enable_if<
+    is_packet_assignable<T_dst, T_expr>::value>::type*& = enabler>
+inline void update_vector_elementwise(T_dst& dst, const T_expr& expr)
+{
+    using packet = packet_traits<typename T_dst::elem_t>;
+    const std::size_t size = dimension(dst);
+    typename T_dst::elem_t* const ptr = dst.data();
+
+    std::size_t i=0;
+    for(; i + packet::size <= size; i += packet::size)
+        packet::store(ptr + i, T_oper::apply(packet::load(ptr + i), expr.packet(i)));
+    for(std::size_t r=size-i; r!=0; --r, ++i)
+        ptr[i] = T_oper::apply(ptr[i], expr[i]);
+    return;
+}
+
+// dst op= expr. if expr reads dst out of place (v += M * v), it is
+// evaluated into the scratch buffer before dst is touched.
+template<class T_oper, class T_dst, class T_expr>
+inline void update_vector(T_dst& dst, const T_expr& expr)
+{
+    if(alias_hazard(expr, std::addressof(dst)))
+    {
+        typename evaluated_type<T_expr>::type& tmp =
+            scratch_buffer<typename evaluated_type<T_expr>::type>();
+        tmp = expr;
+        return update_vector_elementwise<T_oper>(dst, tmp);
+    }
+    return update_vector_elementwise<T_oper>(dst, expr);
+}
+
+// ptr[i] = T_oper::apply(ptr[i], scl) for i in [0, size)
+template<class T_oper, typename T_elem>
+inline void update_linear(T_elem* const ptr, const std::size_t size, const T_elem scl)
+{
+    using packet = packet_traits<T_elem>;
+    const typename packet::type pscl = packet::broadcast(scl);
+
+    std::size_t i=0;
+    for(; i + packet::size <= size; i += packet::size)
+        packet::store(ptr + i, T_oper::apply(packet::load(ptr + i), pscl));
+    for(std::size_t r=size-i; r!=0; --r, ++i)
+        ptr[i] = T_oper::apply(ptr[i], scl);
+    return;
+}
+
+}// detail
+}// ax
+#endif /* AX_VECTOR_ASSIGNMENT_H */
@@ -3,10 +3,16 @@
 #include "TypeTraits.hpp"
 #include "OperatorStructs.hpp"
 #include "Dimension.hpp"
+#include "OperandStorage.hpp"
+#include "Aliasing.hpp"
 #include "util.hpp"
 #include <stdexcept>
 #include <cmath>
 
+#ifndef AX_CONSTEXPR_REDUCTION_LIMIT
+#define AX_CONSTEXPR_REDUCTION_LIMIT 16
+#endif
+
 namespace ax
 {
 
@@ -26,6 +32,12 @@ class VectorExpression
     using elem_t = typename T_lhs::elem_t;
     constexpr static dimension_type dim = I_dim;
 
+    using packet_type = typename packet_traits<elem_t>::type;
+    constexpr static bool packet_access =
+        has_packet_access<stored_operand_type<T_lhs>>::value &&
+        has_packet_access<stored_operand_type<T_rhs>>::value &&
+        std::is_same<typename T_lhs::elem_t, typename T_rhs::elem_t>::value;
+
     VectorExpression(const T_lhs& lhs, const T_rhs& rhs)
         : l_(lhs), r_(rhs)
     {}
@@ -35,8 +47,22 @@ class VectorExpression
         return T_oper::apply(l_[i], r_[i]);
     }
 
-    T_lhs const& l_;
-    T_rhs const& r_;
+    packet_type packet(const std::size_t i) const
+    {
+        return T_oper::apply(l_.packet(i), r_.packet(i));
+    }
+
+    bool references(const void* p) const
+    {
+        return detail::references(l_, p) || detail::references(r_, p);
+    }
+    bool alias_hazard(const void* p) const
+    {
+        return detail::alias_hazard(l_, p) || detail::alias_hazard(r_, p);
+    }
+
+    typename operand_storage<T_lhs>::type l_;
+    typename operand_storage<T_rhs>::type r_;
 };
 
 template <typename T_vec /* = Vector */, typename T_oper,
@@ -55,6 +81,10 @@ class VectorScalarExpression
     using elem_t = typename T_vec::elem_t;
     constexpr static dimension_type dim = T_vec::dim;
 
+    using packet_type = typename packet_traits<elem_t>::type;
+    constexpr static bool packet_access =
+        has_packet_access<stored_operand_type<T_vec>>::value;
+
     VectorScalarExpression(const T_vec& lhs, const T_scl& rhs)
         : l_(lhs), r_(rhs)
     {}
@@ -64,7 +94,21 @@ class VectorScalarExpression
         return T_oper::apply(l_[i], r_);
     }
 
-    T_vec const& l_;
+    packet_type packet(const std::size_t i) const
+    {
+        return T_oper::apply(l_.packet(i), packet_traits<elem_t>::broadcast(r_));
+    }
+
+    bool references(const void* p) const
+    {
+        return detail::references(l_, p);
+    }
+    bool alias_hazard(const void* p) const
+    {
+        return detail::alias_hazard(l_, p);
+    }
+
+    typename operand_storage<T_vec>::type l_;
     T_scl const  r_;
 };
 
@@ -87,8 +131,17 @@ class Vector3DCrossProduct
                l_[circ::retrace(i)] * r_[circ::advance(i)];
     }
 
-    T_lhs const& l_;
-    T_rhs const& r_;
+    bool references(const void* p) const
+    {
+        return detail::references(l_, p) || detail::references(r_, p);
+    }
+    bool alias_hazard(const void* p) const
+    {
+        return this->references(p);
+    }
+
+    typename operand_storage<T_lhs>::type l_;
+    typename operand_storage<T_rhs>::type r_;
 };
 
 template<template<typename T_l, typename T_r> class T_oper,
@@ -211,6 +264,15 @@ operator/(const T_vec& lhs, const T_scl& rhs)
 namespace detail
 {
 
+// static vectors up to this size are reduced by constexpr recursion.
+// everything else goes through the iterative kernels below.
+template<dimension_type I_dim>
+struct is_small_dimension
+{
+    constexpr static bool value =
+        is_static_dimension<I_dim>::value && I_dim <= AX_CONSTEXPR_REDUCTION_LIMIT;
+};
+
 template <class T_vec,
           typename std::enable_if<
               is_vector_expression<typename T_vec::tag>::value
@@ -222,12 +284,138 @@ length_square_impl(const T_vec& val, const std::size_t i_dim, const typename T_v
         length_square_impl<T_vec>(val, i_dim - 1, sum + val[i_dim] * val[i_dim]);
 }
 
+template <class T_lhs, class T_rhs, typename std::enable_if<
+    is_vector_expression<typename T_lhs::tag>::value&&
+    is_vector_expression<typename T_rhs::tag>::value>::type*& = enabler>
+constexpr inline typename T_lhs::elem_t
+dot_prod_impl(const T_lhs& lhs, const T_rhs& rhs, const std::size_t i_dim,
+              const typename T_lhs::elem_t sum)
+{
+    return (i_dim == 0) ? sum + lhs[i_dim] * rhs[i_dim] :
+        dot_prod_impl<T_lhs, T_rhs>(
+                lhs, rhs, i_dim - 1, sum + lhs[i_dim] * rhs[i_dim]);
+}
+
+// sum of lhs[i] * rhs[i] for i in [0, size). four independent accumulators
+// hide the latency of the additions; the packet version keeps four
+// packets of partial sums.
+template <class T_lhs, class T_rhs, typename std::enable_if<
+    !(has_packet_access<T_lhs>::value && has_packet_access<T_rhs>::value)
+    >::type*& = enabler>
+inline typename T_lhs::elem_t
+dot_prod_loop(const T_lhs& lhs, const T_rhs& rhs, const std::size_t size)
+{
+    using elem_t = typename T_lhs::elem_t;
+    elem_t s0(0), s1(0), s2(0), s3(0);
+    std::size_t i=0;
+    for(; i + 4 <= size; i += 4)
+    {
+        s0 += lhs[i  ] * rhs[i  ];
+        s1 += lhs[i+1] * rhs[i+1];
+        s2 += lhs[i+2] * rhs[i+2];
+        s3 += lhs[i+3] * rhs[i+3];
+    }
+    for(; i<size; ++i) s0 += lhs[i] * rhs[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+template <class T_lhs, class T_rhs, typename std::enable_if<
+    has_packet_access<T_lhs>::value && has_packet_access<T_rhs>::value
+    >::type*& = enabler>
+inline typename T_lhs::elem_t
+dot_prod_loop(const T_lhs& lhs, const T_rhs& rhs, const std::size_t size)
+{
+    using elem_t = typename T_lhs::elem_t;
+    using packet = packet_traits<elem_t>;
+    using add    = Add_Operator<elem_t, elem_t>;
+    using mul    = Multiply_Operator<elem_t, elem_t>;
+    constexpr std::size_t N = packet::size;
+
+    typename packet::type s0 = packet::broadcast(0), s1 = s0, s2 = s0, s3 = s0;
+    std::size_t i=0;
+    for(; i + 4 * N <= size; i += 4 * N)
+    {
+        s0 = add::apply(s0, mul::apply(lhs.packet(i      ), rhs.packet(i      )));
+        s1 = add::apply(s1, mul::apply(lhs.packet(i +   N), rhs.packet(i +   N)));
+        s2 = add::apply(s2, mul::apply(lhs.packet(i + 2*N), rhs.packet(i + 2*N)));
+        s3 = add::apply(s3, mul::apply(lhs.packet(i + 3*N), rhs.packet(i + 3*N)));
+    }
+    for(; i + N <= size; i += N)
+        s0 = add::apply(s0, mul::apply(lhs.packet(i), rhs.packet(i)));
+
+    elem_t sum = packet::reduce(add::apply(add::apply(s0, s1), add::apply(s2, s3)));
+    for(; i<size; ++i) sum += lhs[i] * rhs[i];
+    return sum;
+}
+
+// sum of vec[i] * vec[i]. every element of vec is read once.
+template <class T_vec, typename std::enable_if<
+    !has_packet_access<T_vec>::value>::type*& = enabler>
+inline typename T_vec::elem_t
+length_square_loop(const T_vec& vec, const std::size_t size)
+{
+    using elem_t = typename T_vec::elem_t;
+    elem_t s0(0), s1(0), s2(0), s3(0);
+    std::size_t i=0;
+    for(; i + 4 <= size; i += 4)
+    {
+        const elem_t v0 = vec[i], v1 = vec[i+1], v2 = vec[i+2], v3 = vec[i+3];
+        s0 += v0 * v0;
+        s1 += v1 * v1;
+        s2 += v2 * v2;
+        s3 += v3 * v3;
+    }
+    for(; i<size; ++i)
+    {
+        const elem_t v = vec[i];
+        s0 += v * v;
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+template <class T_vec, typename std::enable_if<
+    has_packet_access<T_vec>::value>::type*& = enabler>
+inline typename T_vec::elem_t
+length_square_loop(const T_vec& vec, const std::size_t size)
+{
+    using elem_t = typename T_vec::elem_t;
+    using packet = packet_traits<elem_t>;
+    using add    = Add_Operator<elem_t, elem_t>;
+    using mul    = Multiply_Operator<elem_t, elem_t>;
+    constexpr std::size_t N = packet::size;
+
+    typename packet::type s0 = packet::broadcast(0), s1 = s0, s2 = s0, s3 = s0;
+    std::size_t i=0;
+    for(; i + 4 * N <= size; i += 4 * N)
+    {
+        const typename packet::type v0 = vec.packet(i), v1 = vec.packet(i + N),
+            v2 = vec.packet(i + 2*N), v3 = vec.packet(i + 3*N);
+        s0 = add::apply(s0, mul::apply(v0, v0));
+        s1 = add::apply(s1, mul::apply(v1, v1));
+        s2 = add::apply(s2, mul::apply(v2, v2));
+        s3 = add::apply(s3, mul::apply(v3, v3));
+    }
+    for(; i + N <= size; i += N)
+    {
+        const typename packet::type v = vec.packet(i);
+        s0 = add::apply(s0, mul::apply(v, v));
+    }
+
+    elem_t sum = packet::reduce(add::apply(add::apply(s0, s1), add::apply(s2, s3)));
+    for(; i<size; ++i)
+    {
+        const elem_t v = vec[i];
+        sum += v * v;
+    }
+    return sum;
+}
+
 }//detail
 
 template <class T_vec,
           typename std::enable_if<
               is_vector_expression<typename T_vec::tag>::value&&
-              is_static_dimension<T_vec::dim>::value>::type*& = enabler>
+              detail::is_small_dimension<T_vec::dim>::value>::type*& = enabler>
 constexpr inline typename T_vec::elem_t
 len_square(const T_vec& vec)
 {
@@ -237,11 +425,11 @@ len_square(const T_vec& vec)
 template <class T_vec,
           typename std::enable_if<
               is_vector_expression<typename T_vec::tag>::value&&
-              is_dynamic_dimension<T_vec::dim>::value>::type*& = enabler>
-constexpr inline typename T_vec::elem_t
+              !detail::is_small_dimension<T_vec::dim>::value>::type*& = enabler>
+inline typename T_vec::elem_t
 len_square(const T_vec& vec)
 {
-    return detail::length_square_impl<T_vec>(vec, dimension(vec) - 1, 0.0);
+    return detail::length_square_loop(vec, dimension(vec));
 }
 
 template <class T_vec,
@@ -253,29 +441,12 @@ inline typename T_vec::elem_t length(const T_vec& l)
     return std::sqrt(len_square(l));
 }
 
-namespace detail
-{
-
-template <class T_lhs, class T_rhs, typename std::enable_if<
-    is_vector_expression<typename T_lhs::tag>::value&&
-    is_vector_expression<typename T_rhs::tag>::value>::type*& = enabler>
-constexpr inline typename T_lhs::elem_t
-dot_prod_impl(const T_lhs& lhs, const T_rhs& rhs, const std::size_t i_dim,
-              const typename T_lhs::elem_t sum)
-{
-    return (i_dim == 0) ? sum + lhs[i_dim] * rhs[i_dim] :
-        dot_prod_impl<T_lhs, T_rhs>(
-                lhs, rhs, i_dim - 1, sum + lhs[i_dim] * rhs[i_dim]);
-}
-
-}//detail
-
-// static * static
+// small static * small static
 template <class T_lhs, class T_rhs, typename std::enable_if<
     is_vector_expression<typename T_lhs::tag>::value&&
     is_vector_expression<typename T_rhs::tag>::value&&
     std::is_same<typename T_lhs::elem_t, typename T_rhs::elem_t>::value&&
-    is_static_dimension<T_lhs::dim>::value&&
+    detail::is_small_dimension<T_lhs::dim>::value&&
     is_same_dimension<T_lhs::dim, T_rhs::dim>::value
     >::type*& = enabler>
 constexpr inline typename T_lhs::elem_t
@@ -284,46 +455,35 @@ dot_prod(const T_lhs& lhs, const T_rhs& rhs)
     return detail::dot_prod_impl<T_lhs, T_rhs>(lhs, rhs, dimension(lhs) - 1, 0.0);
 }
 
-// static * dynamic
+// large static * large static
 template <class T_lhs, class T_rhs, typename std::enable_if<
     is_vector_expression<typename T_lhs::tag>::value&&
     is_vector_expression<typename T_rhs::tag>::value&&
     std::is_same<typename T_lhs::elem_t, typename T_rhs::elem_t>::value&&
     is_static_dimension<T_lhs::dim>::value&&
-    is_dynamic_dimension<T_rhs::dim>::value
-    >::type*& = enabler>
-inline typename T_lhs::elem_t
-dot_prod(const T_lhs& lhs, const T_rhs& rhs)
-{
-    return detail::dot_prod_impl<T_lhs, T_rhs>(lhs, rhs, dimension(lhs) - 1, 0.0);
-}
-
-// dynamic * static
-template <class T_lhs, class T_rhs, typename std::enable_if<
-    is_vector_expression<typename T_lhs::tag>::value&&
-    is_vector_expression<typename T_rhs::tag>::value&&
-    std::is_same<typename T_lhs::elem_t, typename T_rhs::elem_t>::value&&
-    is_dynamic_dimension<T_lhs::dim>::value&&
-    is_static_dimension<T_rhs::dim>::value
+    !detail::is_small_dimension<T_lhs::dim>::value&&
+    is_same_dimension<T_lhs::dim, T_rhs::dim>::value
     >::type*& = enabler>
 inline typename T_lhs::elem_t
 dot_prod(const T_lhs& lhs, const T_rhs& rhs)
 {
-    return detail::dot_prod_impl<T_lhs, T_rhs>(lhs, rhs, dimension(lhs) - 1, 0.0);
+    return detail::dot_prod_loop(lhs, rhs, T_lhs::dim);
 }
 
-// dynamic * dynamic
+// at least one of them is dynamic
 template <class T_lhs, class T_rhs, typename std::enable_if<
     is_vector_expression<typename T_lhs::tag>::value&&
     is_vector_expression<typename T_rhs::tag>::value&&
     std::is_same<typename T_lhs::elem_t, typename T_rhs::elem_t>::value&&
-    is_dynamic_dimension<T_lhs::dim>::value&&
-    is_dynamic_dimension<T_rhs::dim>::value
+    (is_dynamic_dimension<T_lhs::dim>::value ||
+     is_dynamic_dimension<T_rhs::dim>::value)
     >::type*& = enabler>
 inline typename T_lhs::elem_t
 dot_prod(const T_lhs& lhs, const T_rhs& rhs)
 {
-    return detail::dot_prod_impl<T_lhs, T_rhs>(lhs, rhs, dimension(lhs) - 1, 0.0);
+    if(dimension(lhs) != dimension(rhs))
+        throw std::invalid_argument("vector size different");
+    return detail::dot_prod_loop(lhs, rhs, dimension(lhs));
 }
 
 template <class T_lhs, class T_rhs, typename std::enable_if<
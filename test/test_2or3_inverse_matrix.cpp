@@ -8,12 +8,14 @@
 #endif
 
 #include "../src/InverseMatrix.hpp"
+#include "../src/Matrix3Batch.hpp"
 
 #include "test_Defs.hpp"
 using ax::test::tolerance;
 using ax::test::seed;
 
 #include <random>
+#include <cmath>
 
 
 BOOST_AUTO_TEST_CASE(matrix_2x2)
@@ -77,3 +79,175 @@ BOOST_AUTO_TEST_CASE(matrix_3x3)
             else
                 BOOST_CHECK_SMALL(E(i,j), tolerance);
 }
+
+BOOST_AUTO_TEST_CASE(matrix_4x4)
+{
+    constexpr std::size_t msize = 4;
+
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(0e0, 1e0);
+
+    ax::Matrix<double, msize,msize> mat;
+    for(std::size_t i=0; i<msize; ++i)
+        for(std::size_t j=0; j<msize; ++j)
+            mat(i,j) = randreal(mt);
+
+    // closed form and LU agree
+    const double det = ax::determinant(mat);
+    const auto   plu = ax::PLUdecompose(mat);
+    BOOST_CHECK_CLOSE(det, plu.determinant(), 1e-10);
+    BOOST_CHECK_CLOSE(std::log(std::abs(det)), ax::log_abs_determinant(mat), 1e-10);
+
+    const ax::Matrix<double, msize,msize> inv = inverse(mat);
+    const ax::Matrix<double, msize,msize> E   = inv * mat;
+    const ax::Matrix<double, msize,msize> inv_lu = plu.inverse();
+
+    for(std::size_t i=0; i<msize; ++i)
+        for(std::size_t j=0; j<msize; ++j)
+        {
+            if(i==j)
+                BOOST_CHECK_CLOSE(E(i,j), 1e0, 1e-10);
+            else
+                BOOST_CHECK_SMALL(E(i,j), 1e-12);
+            BOOST_CHECK_CLOSE(inv(i,j), inv_lu(i,j), 1e-10);
+        }
+
+    // homogeneous transform: rotation about z and translation
+    ax::Matrix<double, msize,msize> trans(1e0);
+    trans(0,0) = 0e0; trans(0,1) = -1e0;
+    trans(1,0) = 1e0; trans(1,1) =  0e0;
+    trans(0,3) = 1e0; trans(1,3) =  2e0; trans(2,3) = 3e0;
+    BOOST_CHECK_CLOSE(ax::determinant(trans), 1e0, tolerance);
+    const ax::Matrix<double, msize,msize> trans_inv = inverse(trans);
+    BOOST_CHECK_CLOSE(trans_inv(0,3), -2e0, tolerance);
+    BOOST_CHECK_CLOSE(trans_inv(1,3),  1e0, tolerance);
+    BOOST_CHECK_CLOSE(trans_inv(2,3), -3e0, tolerance);
+
+    // singular: throws as the LU path does
+    ax::Matrix<double, msize,msize> sing(1e0);
+    sing(3,3) = 0e0;
+    BOOST_CHECK_EQUAL(ax::determinant(sing), 0e0);
+    BOOST_CHECK_THROW(inverse(sing), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_NxN)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    // static, no closed form
+    ax::Matrix<double, 7, 7> mat;
+    for(std::size_t i=0; i<7; ++i)
+        for(std::size_t j=0; j<7; ++j)
+            mat(i,j) = randreal(mt);
+
+    const ax::Matrix<double, 7, 7> inv = ax::inverse(mat);
+    const ax::Matrix<double, 7, 7> E   = mat * inv;
+    for(std::size_t i=0; i<7; ++i)
+        for(std::size_t j=0; j<7; ++j)
+            if(i==j)
+                BOOST_CHECK_CLOSE(E(i,j), 1e0, 1e-10);
+            else
+                BOOST_CHECK_SMALL(E(i,j), 1e-12);
+
+    // det(A * B) = det(A) * det(B)
+    BOOST_CHECK_CLOSE(ax::determinant(mat * mat),
+                      ax::determinant(mat) * ax::determinant(mat), 1e-10);
+    BOOST_CHECK_CLOSE(ax::determinant(inv) * ax::determinant(mat), 1e0, 1e-10);
+
+    // dynamic
+    const std::size_t N = 150;
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> dyn(N, N);
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=0; j<N; ++j)
+            dyn(i,j) = randreal(mt);
+
+    const ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> dyn_inv = ax::inverse(dyn);
+    const ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> dyn_E   = dyn_inv * dyn;
+    double maxdiff = 0e0;
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=0; j<N; ++j)
+            maxdiff = std::max(maxdiff, std::abs(dyn_E(i,j) - (i==j ? 1e0 : 0e0)));
+    BOOST_CHECK_SMALL(maxdiff, 1e-10);
+
+    // a scaled identity: det = 10^N overflows, its log does not
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> big(400, 400);
+    for(std::size_t i=0; i<400; ++i) big(i,i) = 1e1;
+    BOOST_CHECK(std::isinf(ax::determinant(big)));
+    BOOST_CHECK_CLOSE(ax::log_abs_determinant(big), 400 * std::log(1e1), tolerance);
+
+    // singular
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> sing(
+            std::vector<std::vector<double>>{{1e0, 2e0}, {2e0, 4e0}});
+    BOOST_CHECK_EQUAL(ax::determinant(sing), 0e0);
+    BOOST_CHECK(std::isinf(ax::log_abs_determinant(sing)));
+    BOOST_CHECK_THROW(ax::inverse(sing), std::runtime_error);
+
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> rect(3, 4);
+    BOOST_CHECK_THROW(ax::determinant(rect), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_3x3_batch)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    // not a multiple of the packet size
+    const std::size_t N = 103;
+    ax::Matrix3Batch<double> mats(N);
+    BOOST_CHECK_EQUAL(mats.size(), N);
+    BOOST_CHECK_EQUAL(mats.stride() % ax::Matrix3Batch<double>::lanes, 0u);
+
+    for(std::size_t k=0; k<N; ++k)
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+                mats(k, i, j) = randreal(mt);
+
+    // singular entries: a zero matrix, two equal rows, and a nearly singular
+    // one whose determinant is at the level of the rounding error
+    mats.set(7, ax::Matrix<double, 3, 3>());
+    for(std::size_t j=0; j<3; ++j) mats(50, 2, j) = mats(50, 0, j);
+    for(std::size_t j=0; j<3; ++j)
+        mats(81, 2, j) = mats(81, 0, j) + 1e-15 * randreal(mt);
+
+    std::vector<double> det;
+    ax::determinant(mats, det);
+    BOOST_CHECK_EQUAL(det.size(), N);
+
+    ax::Matrix3Batch<double> inv;
+    std::vector<bool> singular;
+    BOOST_CHECK_EQUAL(ax::inverse(mats, inv, singular), 3u);
+    BOOST_CHECK_EQUAL(inv.size(), N);
+    BOOST_CHECK_EQUAL(singular.size(), N);
+
+    for(std::size_t k=0; k<N; ++k)
+    {
+        const ax::Matrix<double, 3, 3> mat = mats.matrix(k);
+        if(k == 7 || k == 50 || k == 81)
+        {
+            BOOST_CHECK(singular[k]);
+            BOOST_CHECK_SMALL(det[k], tolerance);
+            for(std::size_t i=0; i<3; ++i)
+                for(std::size_t j=0; j<3; ++j)
+                    BOOST_CHECK_EQUAL(inv(k, i, j), 0e0);
+            continue;
+        }
+        BOOST_CHECK(!singular[k]);
+        // the determinant is expanded in another order than the scalar one,
+        // and some of the random matrices are ill-conditioned
+        BOOST_CHECK_CLOSE(det[k], ax::determinant(mat), 1e-8);
+
+        const ax::Matrix<double, 3, 3> ref = ax::inverse(mat);
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+                BOOST_CHECK_CLOSE(inv(k, i, j), ref(i, j), 1e-8);
+    }
+
+    // an explicit absolute threshold overrides the relative one. whether the
+    // two equal rows cancel exactly depends on FMA contraction, so only the
+    // zero matrix is certainly flagged with threshold 0.
+    BOOST_CHECK(ax::inverse(mats, inv, singular, 0e0) >= 1u);
+    BOOST_CHECK(singular[7]);
+    BOOST_CHECK(!singular[81]);
+    BOOST_CHECK_EQUAL(ax::inverse(mats, inv, singular, 1e10), N);
+}
@@ -1,6 +1,7 @@
 #ifndef AX_TEST_DEFINITIONS
 #define AX_TEST_DEFINITIONS
 #include <cstddef>
+#include <random>
 
 namespace ax
 {
@@ -10,6 +11,44 @@ namespace ax
         constexpr static unsigned    seed      = 10;
         constexpr static std::size_t Dim_N     = 10;
         constexpr static std::size_t Dim_M     = 12;
+
+        // n x n symmetric matrix, elements uniform in [-1, 1)
+        template<typename T_mat>
+        T_mat random_symmetric(const std::size_t n)
+        {
+            std::mt19937 mt(seed);
+            std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+            T_mat mat(n, n);
+            for(std::size_t i=0; i<n; ++i)
+                for(std::size_t j=i; j<n; ++j)
+                    mat(i,j) = mat(j,i) = randreal(mt);
+            return mat;
+        }
+
+        // |A * v - l * v| < tol for every eigenpair, |v|^2 - 1 and the
+        // products of different vectors below ortho_tol. in ascending order
+        // of l if ascending is set.
+        template<typename T_mat, typename T_pairs>
+        void check_eigenpairs(const T_mat& mat, const T_pairs& eigenpair,
+                              const double tol, const double ortho_tol,
+                              const bool ascending)
+        {
+            typedef typename T_pairs::value_type::second_type vector_type;
+            for(std::size_t i=0; i<eigenpair.size(); ++i)
+            {
+                const vector_type& evec = eigenpair.at(i).second;
+                const vector_type Av = mat * evec;
+                for(std::size_t j=0; j<dimension(evec); ++j)
+                    BOOST_CHECK_SMALL(Av[j] - eigenpair.at(i).first * evec[j], tol);
+                BOOST_CHECK_SMALL(dot_prod(evec, evec) - 1e0, ortho_tol);
+                for(std::size_t j=0; j<i; ++j)
+                {
+                    BOOST_CHECK_SMALL(dot_prod(evec, eigenpair.at(j).second), ortho_tol);
+                    if(ascending)
+                        BOOST_CHECK(eigenpair.at(j).first <= eigenpair.at(i).first);
+                }
+            }
+        }
     }
 }
 
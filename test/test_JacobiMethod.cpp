@@ -15,6 +15,8 @@
 using ax::test::seed;
 
 #include <random>
+#include <algorithm>
+#include <limits>
 
 BOOST_AUTO_TEST_CASE(matrix_2x2)
 {
@@ -139,3 +141,305 @@ BOOST_AUTO_TEST_CASE(matrix_4x4)
             BOOST_CHECK_SMALL(zeros[j], 1e-7);
     }
 }
+
+BOOST_AUTO_TEST_CASE(matrix_64x64)
+{
+    constexpr std::size_t msize = 64;
+
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, msize,msize> mat;
+    for(std::size_t i=0; i<msize; ++i)
+        for(std::size_t j=i; j<msize; ++j)
+            mat(i,j) = mat(j,i) = randreal(mt);
+
+    const auto eigenpair = ax::Jacobimethod(mat);
+
+    double trace = 0e0, sum = 0e0;
+    for(std::size_t i=0; i<msize; ++i)
+    {
+        trace += mat(i,i);
+        sum   += eigenpair.at(i).first;
+
+        const ax::Vector<double, msize>& evec = eigenpair.at(i).second;
+        const ax::Vector<double, msize> zeros =
+            mat * evec - eigenpair.at(i).first * evec;
+        for(std::size_t j=0; j<msize; ++j)
+            BOOST_CHECK_SMALL(zeros[j], 1e-9);
+
+        // orthonormal
+        for(std::size_t j=i; j<msize; ++j)
+        {
+            const double dot = ax::dot_prod(evec, eigenpair.at(j).second);
+            if(i == j) BOOST_CHECK_CLOSE(dot, 1e0, 1e-10);
+            else       BOOST_CHECK_SMALL(dot, 1e-12);
+        }
+    }
+    BOOST_CHECK_CLOSE(trace, sum, 1e-10);
+
+    ax::Matrix<double, msize,msize> asym(mat);
+    asym(0, 1) += 1e0;
+    BOOST_CHECK_THROW(ax::Jacobimethod(asym), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(matrix_dynamic)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    // odd, so that one index sits out every round
+    const std::size_t msize = 101;
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> mat(msize, msize);
+    for(std::size_t i=0; i<msize; ++i)
+        for(std::size_t j=i; j<msize; ++j)
+            mat(i,j) = mat(j,i) = randreal(mt);
+
+    const auto eigenpair = ax::Jacobimethod(mat);
+    BOOST_CHECK_EQUAL(eigenpair.size(), msize);
+
+    double trace = 0e0, sum = 0e0;
+    for(std::size_t i=0; i<msize; ++i)
+    {
+        trace += mat(i,i);
+        sum   += eigenpair.at(i).first;
+
+        const ax::Vector<double, ax::DYNAMIC>& evec = eigenpair.at(i).second;
+        const ax::Vector<double, ax::DYNAMIC> Av = mat * evec;
+        for(std::size_t j=0; j<msize; ++j)
+            BOOST_CHECK_SMALL(Av[j] - eigenpair.at(i).first * evec[j], 1e-9);
+        BOOST_CHECK_CLOSE(ax::dot_prod(evec, evec), 1e0, 1e-10);
+        if(i != 0)
+            BOOST_CHECK_SMALL(ax::dot_prod(evec, eigenpair.at(i-1).second), 1e-12);
+    }
+    BOOST_CHECK_CLOSE(trace, sum, 1e-10);
+
+    // the same result when the rotations of a round run on several threads
+    const std::size_t nthreads  = ax::get_num_threads();
+    const std::size_t threshold = ax::get_parallel_threshold();
+    ax::set_num_threads(3);
+    ax::set_parallel_threshold(1);
+    const auto eigenpair_mt = ax::Jacobimethod(mat);
+    ax::set_num_threads(nthreads);
+    ax::set_parallel_threshold(threshold);
+
+    for(std::size_t i=0; i<msize; ++i)
+    {
+        BOOST_CHECK_EQUAL(eigenpair_mt.at(i).first, eigenpair.at(i).first);
+        for(std::size_t j=0; j<msize; ++j)
+            BOOST_CHECK_EQUAL(eigenpair_mt.at(i).second[j], eigenpair.at(i).second[j]);
+    }
+
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> rect(3, 4);
+    BOOST_CHECK_THROW(ax::Jacobimethod(rect), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(warm_start)
+{
+    constexpr std::size_t msize = 6;
+
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, msize,msize> mat, next;
+    for(std::size_t i=0; i<msize; ++i)
+        for(std::size_t j=i; j<msize; ++j)
+        {
+            mat(i,j)  = mat(j,i)  = randreal(mt);
+            next(i,j) = next(j,i) = mat(i,j) + 1e-4 * randreal(mt);
+        }
+
+    ax::JacobiMethod<ax::Matrix<double, msize,msize>> cold(next);
+    cold.solve();
+    const auto previous = ax::Jacobimethod(mat);
+    ax::JacobiMethod<ax::Matrix<double, msize,msize>> warm(next);
+    const auto eigenpair = warm.solve(previous);
+    BOOST_CHECK(warm.num_sweep() <= 3);
+    BOOST_CHECK(warm.num_sweep() < cold.num_sweep());
+
+    for(std::size_t i=0; i<msize; ++i)
+    {
+        const ax::Vector<double, msize>& evec = eigenpair.at(i).second;
+        const ax::Vector<double, msize> zeros =
+            next * evec - eigenpair.at(i).first * evec;
+        for(std::size_t j=0; j<msize; ++j)
+            BOOST_CHECK_SMALL(zeros[j], 1e-9);
+        // the pairs keep the order of the guess
+        BOOST_CHECK_CLOSE(std::abs(ax::dot_prod(evec, previous.at(i).second)), 1e0, 1e-4);
+        BOOST_CHECK_SMALL(eigenpair.at(i).first - previous.at(i).first, 1e-3);
+    }
+
+    auto singular = previous;
+    singular.at(1).second = singular.at(0).second;
+    BOOST_CHECK_THROW(warm.solve(singular), std::invalid_argument);
+
+    // dynamic
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> dmat(40, 40), dnext(40, 40);
+    for(std::size_t i=0; i<40; ++i)
+        for(std::size_t j=i; j<40; ++j)
+        {
+            dmat(i,j)  = dmat(j,i)  = randreal(mt);
+            dnext(i,j) = dnext(j,i) = dmat(i,j) + 1e-5 * randreal(mt);
+        }
+    ax::JacobiMethod<ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC>> dcold(dnext);
+    dcold.solve();
+    ax::JacobiMethod<ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC>> dwarm(dnext);
+    const auto dpairs = dwarm.solve(ax::Jacobimethod(dmat));
+    BOOST_CHECK(dwarm.num_sweep() <= 3);
+    BOOST_CHECK(dwarm.num_sweep() < dcold.num_sweep());
+    for(std::size_t i=0; i<40; ++i)
+    {
+        const ax::Vector<double, ax::DYNAMIC>& evec = dpairs.at(i).second;
+        const ax::Vector<double, ax::DYNAMIC> zeros =
+            dnext * evec - dpairs.at(i).first * evec;
+        for(std::size_t j=0; j<40; ++j)
+            BOOST_CHECK_SMALL(zeros[j], 1e-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(trajectory)
+{
+    // a gyration tensor R(t) * diag(1, 2, 4) * R(t)^T rotating slowly
+    const std::size_t nframe = 50;
+    std::vector<ax::Matrix<double, 3, 3>> frames;
+    for(std::size_t f=0; f<nframe; ++f)
+    {
+        const double t = 0.01 * f;
+        const double c = std::cos(t), s = std::sin(t);
+        const double cz = std::cos(2 * t), sz = std::sin(2 * t);
+        ax::Matrix<double, 3, 3> Rx(1e0), Rz(1e0), D(0e0);
+        Rx(1,1) = c;  Rx(1,2) = -s;  Rx(2,1) = s;  Rx(2,2) = c;
+        Rz(0,0) = cz; Rz(0,1) = -sz; Rz(1,0) = sz; Rz(1,1) = cz;
+        D(0,0) = 1e0 + 0.1 * t; D(1,1) = 2e0; D(2,2) = 4e0 - 0.1 * t;
+        const ax::Matrix<double, 3, 3> R = Rz * Rx;
+        frames.push_back(R * D * ax::transpose(R));
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<i; ++j)
+                frames.back()(i,j) = frames.back()(j,i);
+    }
+
+    const auto result = ax::Jacobimethod_trajectory(frames);
+    BOOST_CHECK_EQUAL(result.size(), nframe);
+
+    ax::JacobiTrajectory<ax::Matrix<double, 3, 3>> trajectory;
+    for(std::size_t f=0; f<nframe; ++f)
+    {
+        const auto& eigenpair = trajectory.solve(frames.at(f));
+        if(f != 0) BOOST_CHECK(trajectory.num_sweep() <= 3);
+        for(std::size_t i=0; i<3; ++i)
+        {
+            BOOST_CHECK_EQUAL(eigenpair.at(i).first, result.at(f).at(i).first);
+            const ax::Vector<double, 3>& evec = eigenpair.at(i).second;
+            const ax::Vector<double, 3> zeros =
+                frames.at(f) * evec - eigenpair.at(i).first * evec;
+            for(std::size_t j=0; j<3; ++j)
+                BOOST_CHECK_SMALL(zeros[j], 1e-9);
+            // a mode keeps its index from frame to frame
+            if(f != 0)
+                BOOST_CHECK_SMALL(eigenpair.at(i).first -
+                                  result.at(f-1).at(i).first, 2e-3);
+        }
+    }
+
+    // a dynamic frame of another size starts from scratch
+    typedef ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> dmatrix;
+    ax::JacobiTrajectory<dmatrix> dtrajectory;
+    for(std::size_t n=4; n<7; ++n)
+    {
+        dmatrix dmat(n, n);
+        for(std::size_t i=0; i<n; ++i)
+            for(std::size_t j=i; j<n; ++j)
+                dmat(i,j) = dmat(j,i) = 1e0 / (1 + i + j);
+        const auto& eigenpair = dtrajectory.solve(dmat);
+        BOOST_CHECK_EQUAL(eigenpair.size(), n);
+        for(std::size_t i=0; i<n; ++i)
+        {
+            const ax::Vector<double, ax::DYNAMIC>& evec = eigenpair.at(i).second;
+            for(std::size_t r=0; r<n; ++r)
+            {
+                double av = 0e0;
+                for(std::size_t c=0; c<n; ++c) av += dmat(r,c) * evec[c];
+                BOOST_CHECK_SMALL(av - eigenpair.at(i).first * evec[r], 1e-9);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    // 4x4, a count that leaves the last packet partly empty
+    std::vector<ax::Matrix<double, 4, 4>> mats4(37);
+    for(auto& m : mats4)
+        for(std::size_t i=0; i<4; ++i)
+            for(std::size_t j=i; j<4; ++j)
+                m(i,j) = m(j,i) = randreal(mt);
+    mats4.at(5) = ax::Matrix<double, 4, 4>(1e0); // already diagonal
+
+    std::vector<std::array<std::pair<double, ax::Vector<double, 4>>, 4>> pairs4;
+    std::vector<bool> converged;
+    BOOST_CHECK_EQUAL(ax::Jacobimethod_batch(mats4, pairs4, converged), 0u);
+    BOOST_CHECK_EQUAL(pairs4.size(), mats4.size());
+    BOOST_CHECK_EQUAL(converged.size(), mats4.size());
+    for(std::size_t k=0; k<mats4.size(); ++k)
+    {
+        BOOST_CHECK(converged.at(k));
+        const auto single = ax::Jacobimethod(mats4.at(k));
+        std::array<double, 4> expected, actual;
+        for(std::size_t i=0; i<4; ++i)
+        {
+            expected[i] = single.at(i).first;
+            actual[i]   = pairs4.at(k).at(i).first;
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        for(std::size_t i=0; i<4; ++i)
+        {
+            BOOST_CHECK_SMALL(actual[i] - expected[i], 1e-10);
+            const ax::Vector<double, 4>& evec = pairs4.at(k).at(i).second;
+            BOOST_CHECK_CLOSE(ax::dot_prod(evec, evec), 1e0, 1e-10);
+            const ax::Vector<double, 4> zeros =
+                mats4.at(k) * evec - pairs4.at(k).at(i).first * evec;
+            for(std::size_t j=0; j<4; ++j)
+                BOOST_CHECK_SMALL(zeros[j], 1e-9);
+        }
+    }
+
+    // 6x6 over several chunks, on the thread pool and in serial
+    std::vector<ax::Matrix<double, 6, 6>> mats6(150);
+    for(auto& m : mats6)
+        for(std::size_t i=0; i<6; ++i)
+            for(std::size_t j=i; j<6; ++j)
+                m(i,j) = m(j,i) = randreal(mt);
+    mats6.at(100)(2,3) = mats6.at(100)(3,2) = std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<std::array<std::pair<double, ax::Vector<double, 6>>, 6>> serial, parallel;
+    std::vector<bool> serial_flag, parallel_flag;
+    const std::size_t num_threads = ax::get_num_threads();
+    const std::size_t threshold   = ax::get_parallel_threshold();
+    ax::set_num_threads(1);
+    BOOST_CHECK_EQUAL(ax::Jacobimethod_batch(mats6, serial, serial_flag), 1u);
+    ax::set_num_threads(3);
+    ax::set_parallel_threshold(0);
+    BOOST_CHECK_EQUAL(ax::Jacobimethod_batch(mats6, parallel, parallel_flag), 1u);
+    ax::set_num_threads(num_threads);
+    ax::set_parallel_threshold(threshold);
+
+    for(std::size_t k=0; k<mats6.size(); ++k)
+    {
+        BOOST_CHECK_EQUAL(serial_flag.at(k), k != 100);
+        BOOST_CHECK_EQUAL(parallel_flag.at(k), k != 100);
+        if(k == 100) continue;
+        for(std::size_t i=0; i<6; ++i)
+        {
+            BOOST_CHECK_EQUAL(serial.at(k).at(i).first, parallel.at(k).at(i).first);
+            const ax::Vector<double, 6>& evec = serial.at(k).at(i).second;
+            const ax::Vector<double, 6> zeros =
+                mats6.at(k) * evec - serial.at(k).at(i).first * evec;
+            for(std::size_t j=0; j<6; ++j)
+                BOOST_CHECK_SMALL(zeros[j], 1e-9);
+        }
+    }
+}
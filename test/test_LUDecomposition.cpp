@@ -54,3 +54,328 @@ BOOST_AUTO_TEST_CASE(LUDecomposition)
         for(std::size_t j=0; j<4; ++j)
             BOOST_CHECK_CLOSE(A(i,j), mat(i,j), tolerance);
 }
+
+namespace
+{
+// max |(P * A)(i, j) - (L * U)(i, j)|
+template<class T_mat, class T_plu>
+double plu_residual(const T_mat& A, const T_plu& plu)
+{
+    const T_mat LU = plu.L() * plu.U();
+    double maxdiff = 0e0;
+    for(std::size_t i=0; i<plu.size(); ++i)
+        for(std::size_t j=0; j<plu.size(); ++j)
+            maxdiff = std::max(maxdiff,
+                    std::abs(A(plu.permutation()[i], j) - LU(i, j)));
+    return maxdiff;
+}
+}
+
+BOOST_AUTO_TEST_CASE(PLUDecomposition_static)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, 8, 8> mat;
+    for(std::size_t i=0; i<8; ++i)
+        for(std::size_t j=0; j<8; ++j)
+            mat(i, j) = randreal(mt);
+    mat(0, 0) = 0e0; // Doolittle would divide by zero here
+
+    const auto plu = ax::PLUdecompose(mat);
+    BOOST_CHECK(!plu.is_singular());
+    BOOST_CHECK_SMALL(plu_residual(mat, plu), tolerance);
+
+    // |L(i, j)| <= 1 with partial pivoting
+    for(std::size_t i=0; i<8; ++i)
+        for(std::size_t j=0; j<i; ++j)
+            BOOST_CHECK(std::abs(plu.LU()(i, j)) <= 1e0);
+
+    // in-place variant gives the same packed factors
+    ax::Matrix<double, 8, 8> lu = mat;
+    std::array<std::size_t, 8> perm;
+    BOOST_CHECK_EQUAL(ax::PLUdecompose_inplace(lu, perm), plu.sign());
+    for(std::size_t i=0; i<8; ++i)
+    {
+        BOOST_CHECK_EQUAL(perm[i], plu.permutation()[i]);
+        for(std::size_t j=0; j<8; ++j)
+            BOOST_CHECK_EQUAL(lu(i, j), plu.LU()(i, j));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PLUDecomposition_dynamic)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> mat(37, 37);
+    for(std::size_t i=0; i<37; ++i)
+        for(std::size_t j=0; j<37; ++j)
+            mat(i, j) = randreal(mt);
+
+    const auto plu = ax::PLUdecompose(mat);
+    BOOST_CHECK(!plu.is_singular());
+    BOOST_CHECK_EQUAL(plu.permutation().size(), 37u);
+    BOOST_CHECK_SMALL(plu_residual(mat, plu), 1e-12);
+
+    // permutation matrix: one row exchange
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> swap(
+            std::vector<std::vector<double>>{{0e0, 1e0}, {1e0, 0e0}});
+    std::vector<std::size_t> perm;
+    BOOST_CHECK_EQUAL(ax::PLUdecompose_inplace(swap, perm), -1);
+    BOOST_CHECK_EQUAL(perm.at(0), 1u);
+    BOOST_CHECK_EQUAL(perm.at(1), 0u);
+
+    // singular
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> sing(
+            std::vector<std::vector<double>>{{1e0, 2e0}, {2e0, 4e0}});
+    BOOST_CHECK(ax::PLUdecompose(sing).is_singular());
+
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> rect(3, 4);
+    BOOST_CHECK_THROW(ax::PLUdecompose_inplace(rect, perm), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(PLUDecomposition_blocked)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    // several panels, the last one narrower than AX_LU_BLOCK_SIZE
+    const std::size_t N = 3 * AX_LU_BLOCK_SIZE + 17;
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> mat(N, N);
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=0; j<N; ++j)
+            mat(i, j) = randreal(mt);
+
+    const auto plu = ax::PLUdecompose(mat);
+    BOOST_CHECK(!plu.is_singular());
+    BOOST_CHECK_SMALL(plu_residual(mat, plu), 1e-11);
+
+    // the same factors, the trailing updates split over the thread pool
+    const std::size_t nthreads  = ax::get_num_threads();
+    const std::size_t threshold = ax::get_parallel_threshold();
+    ax::set_num_threads(3);
+    ax::set_parallel_threshold(1);
+    const auto plu_mt = ax::PLUdecompose(mat);
+    ax::set_num_threads(nthreads);
+    ax::set_parallel_threshold(threshold);
+
+    for(std::size_t i=0; i<N; ++i)
+    {
+        BOOST_CHECK_EQUAL(plu_mt.permutation()[i], plu.permutation()[i]);
+        for(std::size_t j=0; j<N; ++j)
+            BOOST_CHECK_EQUAL(plu_mt.LU()(i, j), plu.LU()(i, j));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LUDecomposition_blocked)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+    using matrix_type = ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC>;
+
+    // Doolittle does not pivot: diagonally dominant, several panels
+    const std::size_t N = 2 * AX_LU_BLOCK_SIZE + 9;
+    matrix_type mat(N, N);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        for(std::size_t j=0; j<N; ++j)
+            mat(i, j) = randreal(mt);
+        mat(i, i) += static_cast<double>(N);
+    }
+
+    const auto LUpair = ax::LUdecompose<ax::Doolittle>(mat);
+    const matrix_type& L = LUpair.first;
+    const matrix_type& U = LUpair.second;
+    const matrix_type A = L * U;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        BOOST_CHECK_EQUAL(L(i, i), 1e0);
+        for(std::size_t j=0; j<N; ++j)
+        {
+            if(j > i) BOOST_CHECK_EQUAL(L(i, j), 0e0);
+            if(j < i) BOOST_CHECK_EQUAL(U(i, j), 0e0);
+            BOOST_CHECK_SMALL(A(i, j) - mat(i, j), 1e-11);
+        }
+    }
+
+    // the same factors, the trailing updates split over the thread pool
+    const std::size_t nthreads  = ax::get_num_threads();
+    const std::size_t threshold = ax::get_parallel_threshold();
+    ax::set_num_threads(3);
+    ax::set_parallel_threshold(1);
+    const auto LUpair_mt = ax::LUdecompose<ax::Doolittle>(mat);
+    ax::set_num_threads(nthreads);
+    ax::set_parallel_threshold(threshold);
+
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=0; j<N; ++j)
+        {
+            BOOST_CHECK_EQUAL(LUpair_mt.first(i, j),  L(i, j));
+            BOOST_CHECK_EQUAL(LUpair_mt.second(i, j), U(i, j));
+        }
+}
+
+BOOST_AUTO_TEST_CASE(PLUDecomposition_solve)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+    using matrix_type = ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC>;
+    using vector_type = ax::Vector<double, ax::DYNAMIC>;
+
+    const std::size_t N = 2 * AX_LU_BLOCK_SIZE + 5;
+    const std::size_t M = 23;
+    matrix_type A(N, N), B(N, M);
+    vector_type b(N);
+    for(std::size_t i=0; i<N; ++i)
+    {
+        b[i] = randreal(mt);
+        A(i, i) = 4e0; // keep the system well conditioned
+        for(std::size_t j=0; j<N; ++j) A(i, j) += randreal(mt);
+        for(std::size_t j=0; j<M; ++j) B(i, j) = randreal(mt);
+    }
+
+    const auto plu = ax::PLUdecompose(A);
+
+    const vector_type x  = plu.solve(b);
+    const vector_type Ax = A * x;
+    for(std::size_t i=0; i<N; ++i)
+        BOOST_CHECK_SMALL(Ax[i] - b[i], 1e-12);
+
+    const matrix_type X  = plu.solve(B);
+    const matrix_type AX = A * X;
+    BOOST_CHECK_EQUAL(X.size_row(), N);
+    BOOST_CHECK_EQUAL(X.size_col(), M);
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=0; j<M; ++j)
+            BOOST_CHECK_SMALL(AX(i, j) - B(i, j), 1e-12);
+
+    BOOST_CHECK_THROW(plu.solve(vector_type(N - 1)), std::invalid_argument);
+
+    // static
+    ax::Matrix<double, 3, 3> S;
+    S(0, 0) = 0e0; S(0, 1) = 2e0; S(0, 2) = 1e0;
+    S(1, 0) = 1e0; S(1, 1) = 1e0; S(1, 2) = 0e0;
+    S(2, 0) = 3e0; S(2, 1) = 0e0; S(2, 2) = 1e0;
+    const ax::Vector<double, 3> s(1e0, 2e0, 3e0);
+    const ax::Vector<double, 3> y  = ax::PLUdecompose(S).solve(s);
+    const ax::Vector<double, 3> Sy = S * y;
+    for(std::size_t i=0; i<3; ++i)
+        BOOST_CHECK_CLOSE_FRACTION(Sy[i], s[i], tolerance);
+
+    matrix_type sing(std::vector<std::vector<double>>{{1e0, 2e0}, {2e0, 4e0}});
+    BOOST_CHECK_THROW(ax::PLUdecompose(sing).solve(vector_type(2)), std::runtime_error);
+}
+
+namespace
+{
+// symmetric positive definite: M^T * M + n * I
+ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> spd_matrix(const std::size_t n)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> M(n, n);
+    for(std::size_t i=0; i<n; ++i)
+        for(std::size_t j=0; j<n; ++j)
+            M(i, j) = randreal(mt);
+
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> A = ax::transpose(M) * M;
+    for(std::size_t i=0; i<n; ++i) A(i, i) += static_cast<double>(n);
+    return A;
+}
+}
+
+BOOST_AUTO_TEST_CASE(CholeskyDecomposition)
+{
+    const auto dyn = spd_matrix(6);
+    ax::Matrix<double, 6, 6> mat;
+    for(std::size_t i=0; i<6; ++i)
+        for(std::size_t j=0; j<6; ++j)
+            mat(i, j) = dyn(i, j);
+
+    const auto LLt = ax::LUdecompose<ax::Cholesky>(mat);
+    const ax::Matrix<double, 6, 6> A = LLt.first * LLt.second;
+    for(std::size_t i=0; i<6; ++i)
+        for(std::size_t j=0; j<6; ++j)
+        {
+            BOOST_CHECK_CLOSE(A(i, j), mat(i, j), tolerance);
+            BOOST_CHECK_EQUAL(LLt.first(i, j), LLt.second(j, i));
+            if(i < j) BOOST_CHECK_EQUAL(LLt.first(i, j), 0e0);
+        }
+
+    const auto LDLt = ax::LUdecompose<ax::LDLT>(mat);
+    const ax::Matrix<double, 6, 6> B = LDLt.first * LDLt.second;
+    for(std::size_t i=0; i<6; ++i)
+    {
+        BOOST_CHECK_EQUAL(LDLt.first(i, i), 1e0);
+        for(std::size_t j=0; j<6; ++j)
+            BOOST_CHECK_CLOSE(B(i, j), mat(i, j), tolerance);
+    }
+
+    // not positive definite
+    ax::Matrix<double, 2, 2> indef;
+    indef(0, 0) = 1e0; indef(0, 1) = 2e0;
+    indef(1, 0) = 2e0; indef(1, 1) = 1e0;
+    BOOST_CHECK(!ax::Choleskydecompose_inplace(indef));
+    indef(0, 0) = 1e0; indef(1, 0) = 2e0; indef(1, 1) = 1e0;
+    BOOST_CHECK_THROW(ax::LUdecompose<ax::Cholesky>(indef), std::invalid_argument);
+    BOOST_CHECK(ax::LDLTdecompose_inplace(indef)); // LDLT needs no definiteness
+}
+
+BOOST_AUTO_TEST_CASE(CholeskyDecomposition_blocked)
+{
+    // several blocks, the last one narrower than AX_LU_BLOCK_SIZE
+    const std::size_t N = 2 * AX_LU_BLOCK_SIZE + 11;
+    const auto mat = spd_matrix(N);
+
+    // only the lower triangle is read and written
+    auto L = mat;
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=i+1; j<N; ++j)
+            L(i, j) = -1e0;
+    BOOST_CHECK(ax::Choleskydecompose_inplace(L));
+
+    auto D = mat;
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=i+1; j<N; ++j)
+            D(i, j) = -1e0;
+    BOOST_CHECK(ax::LDLTdecompose_inplace(D));
+
+    double maxdiff_llt = 0e0, maxdiff_ldlt = 0e0;
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=0; j<=i; ++j)
+        {
+            double llt = 0e0, ldlt = 0e0;
+            for(std::size_t p=0; p<=j; ++p)
+            {
+                llt  += L(i, p) * L(j, p);
+                ldlt += (p == i ? 1e0 : D(i, p)) * D(p, p) * (p == j ? 1e0 : D(j, p));
+            }
+            maxdiff_llt  = std::max(maxdiff_llt,  std::abs(llt  - mat(i, j)));
+            maxdiff_ldlt = std::max(maxdiff_ldlt, std::abs(ldlt - mat(i, j)));
+            if(j != i)
+            {
+                BOOST_CHECK_EQUAL(L(j, i), -1e0);
+                BOOST_CHECK_EQUAL(D(j, i), -1e0);
+            }
+        }
+    BOOST_CHECK_SMALL(maxdiff_llt,  1e-10);
+    BOOST_CHECK_SMALL(maxdiff_ldlt, 1e-10);
+
+    // the same factor, the trailing updates split over the thread pool
+    const std::size_t nthreads  = ax::get_num_threads();
+    const std::size_t threshold = ax::get_parallel_threshold();
+    ax::set_num_threads(3);
+    ax::set_parallel_threshold(1);
+    auto L_mt = mat;
+    BOOST_CHECK(ax::Choleskydecompose_inplace(L_mt));
+    ax::set_num_threads(nthreads);
+    ax::set_parallel_threshold(threshold);
+
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=0; j<=i; ++j)
+            BOOST_CHECK_EQUAL(L_mt(i, j), L(i, j));
+
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> rect(3, 4);
+    BOOST_CHECK_THROW(ax::Choleskydecompose_inplace(rect), std::invalid_argument);
+}
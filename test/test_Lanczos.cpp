@@ -0,0 +1,127 @@
+#define BOOST_TEST_MODULE "test_Lanczos"
+
+#ifdef UNITTEST_FRAMEWORK_LIBRARY_EXIST
+#include <boost/test/unit_test.hpp>
+#else
+#define BOOST_TEST_NO_LIB
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include "../src/Lanczos.hpp"
+
+#include "test_Defs.hpp"
+using ax::test::seed;
+using ax::test::check_eigenpairs;
+
+#include <random>
+
+typedef ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> dmatrix;
+typedef ax::Vector<double, ax::DYNAMIC> dvector;
+
+BOOST_AUTO_TEST_CASE(dense_matrix)
+{
+    const std::size_t msize = 300;
+    const std::size_t k = 6;
+    const dmatrix mat = ax::test::random_symmetric<dmatrix>(msize);
+    const std::vector<double> values = ax::HouseholderQL<dmatrix>(mat).eigenvalues();
+
+    const auto top = ax::eigen_largest(mat, k);
+    BOOST_CHECK_EQUAL(top.size(), k);
+    for(std::size_t i=0; i<k; ++i)
+        BOOST_CHECK_CLOSE(top.at(i).first, values.at(msize - 1 - i), 1e-8);
+    check_eigenpairs(mat, top, 1e-8, 1e-12, false);
+
+    const auto bottom = ax::eigen_smallest(mat, k);
+    BOOST_CHECK_EQUAL(bottom.size(), k);
+    for(std::size_t i=0; i<k; ++i)
+        BOOST_CHECK_CLOSE(bottom.at(i).first, values.at(i), 1e-8);
+    check_eigenpairs(mat, bottom, 1e-8, 1e-12, false);
+
+    // a Krylov space as large as the matrix gives the exact answer at once
+    const dmatrix small = ax::test::random_symmetric<dmatrix>(10);
+    const std::vector<double> small_values =
+        ax::HouseholderQL<dmatrix>(small).eigenvalues();
+    ax::Lanczos<dmatrix> lanczos(small, 3);
+    const auto small_top = lanczos.largest();
+    BOOST_CHECK_EQUAL(lanczos.num_restart(), 0u);
+    for(std::size_t i=0; i<3; ++i)
+        BOOST_CHECK_SMALL(small_top.at(i).first - small_values.at(9 - i), 1e-12);
+
+    BOOST_CHECK_THROW(ax::eigen_largest(small, 11), std::invalid_argument);
+    dmatrix rect(3, 4);
+    BOOST_CHECK_THROW(ax::eigen_largest(rect, 1), std::invalid_argument);
+    dmatrix asym(3, 3);
+    asym(0,1) = 1e0;
+    BOOST_CHECK_THROW(ax::eigen_largest(asym, 1), std::invalid_argument);
+    BOOST_CHECK_THROW(ax::eigen_smallest(asym, 1), std::invalid_argument);
+    BOOST_CHECK(ax::eigen_largest(small, 0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(matrix_free)
+{
+    // the covariance X^T * X of 200 samples of 1000 variables, applied as
+    // X^T * (X * x). its nonzero eigenvalues are those of X * X^T.
+    const std::size_t nsample = 200, nvar = 1000, k = 5;
+    std::mt19937 mt(seed);
+    std::normal_distribution<double> gauss(0e0, 1e0);
+    dmatrix X(nsample, nvar);
+    for(std::size_t i=0; i<nsample; ++i)
+        for(std::size_t j=0; j<nvar; ++j)
+            X(i,j) = gauss(mt) * (1e0 + 3e0 / (1 + j % 7));
+
+    ax::Lanczos<dmatrix> lanczos(
+        [&X, nsample, nvar](const dvector& x, dvector& y)
+        {
+            dvector Xx(nsample);
+            for(std::size_t i=0; i<nsample; ++i)
+            {
+                double sum = 0e0;
+                for(std::size_t j=0; j<nvar; ++j) sum += X(i,j) * x[j];
+                Xx[i] = sum;
+            }
+            for(std::size_t j=0; j<nvar; ++j) y[j] = 0e0;
+            for(std::size_t i=0; i<nsample; ++i)
+                for(std::size_t j=0; j<nvar; ++j) y[j] += X(i,j) * Xx[i];
+        }, nvar, k);
+    const auto top = lanczos.largest();
+    BOOST_CHECK(lanczos.num_product() < nsample);
+
+    dmatrix gram(nsample, nsample);
+    for(std::size_t i=0; i<nsample; ++i)
+        for(std::size_t l=0; l<nsample; ++l)
+        {
+            double sum = 0e0;
+            for(std::size_t j=0; j<nvar; ++j) sum += X(i,j) * X(l,j);
+            gram(i,l) = sum;
+        }
+    const std::vector<double> values = ax::HouseholderQL<dmatrix>(gram).eigenvalues();
+    for(std::size_t i=0; i<k; ++i)
+        BOOST_CHECK_CLOSE(top.at(i).first, values.at(nsample - 1 - i), 1e-8);
+
+    // the residual of each pair through the operator form
+    for(std::size_t i=0; i<k; ++i)
+    {
+        const dvector& v = top.at(i).second;
+        dvector Xv(nsample);
+        for(std::size_t s=0; s<nsample; ++s)
+            for(std::size_t c=0; c<nvar; ++c) Xv[s] += X(s,c) * v[c];
+        for(std::size_t j=0; j<nvar; ++j)
+        {
+            double XtXv = 0e0;
+            for(std::size_t s=0; s<nsample; ++s) XtXv += X(s,j) * Xv[s];
+            BOOST_CHECK_SMALL(XtXv - top.at(i).first * v[j], 1e-8 * top.at(i).first);
+        }
+    }
+
+    // a given starting vector
+    ax::Lanczos<dmatrix> diag(
+        [](const dvector& x, dvector& y)
+        {
+            for(std::size_t i=0; i<x.size(); ++i) y[i] = (i + 1) * x[i];
+        }, 500, 3);
+    diag.set_start(dvector(500, 1e0));
+    diag.set_tolerance(1e-12);
+    const auto low = diag.smallest();
+    for(std::size_t i=0; i<3; ++i)
+        BOOST_CHECK_CLOSE(low.at(i).first, static_cast<double>(i + 1), 1e-9);
+}
@@ -0,0 +1,226 @@
+#define BOOST_TEST_MODULE "test_QRDecomposition"
+
+#ifdef UNITTEST_FRAMEWORK_LIBRARY_EXIST
+#include <boost/test/unit_test.hpp>
+#else
+#define BOOST_TEST_NO_LIB
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include "../src/QRDecomposition.hpp"
+
+#include "test_Defs.hpp"
+using ax::test::seed;
+
+#include <random>
+
+// A * P = Q * R, Q^T * Q = I, R upper trapezoidal
+template<typename T_mat, typename T_qr>
+void check_qr(const T_mat& mat, const T_qr& qr, const double tol)
+{
+    const std::size_t m = ax::dimension_row(mat);
+    const std::size_t n = ax::dimension_col(mat);
+    const std::size_t k = std::min(m, n);
+    const auto Q = qr.Q();
+    const auto R = qr.R();
+    BOOST_CHECK_EQUAL(ax::dimension_row(Q), m);
+    BOOST_CHECK_EQUAL(ax::dimension_col(Q), k);
+    BOOST_CHECK_EQUAL(ax::dimension_row(R), k);
+    BOOST_CHECK_EQUAL(ax::dimension_col(R), n);
+
+    for(std::size_t i=0; i<k; ++i)
+        for(std::size_t j=0; j<i; ++j)
+            BOOST_CHECK_EQUAL(R(i,j), 0e0);
+    for(std::size_t i=0; i<m; ++i)
+    {
+        for(std::size_t j=0; j<n; ++j)
+        {
+            double qr_ij = 0e0;
+            for(std::size_t l=0; l<k; ++l) qr_ij += Q(i,l) * R(l,j);
+            BOOST_CHECK_SMALL(qr_ij - mat(i, qr.permutation().at(j)), tol);
+        }
+    }
+    for(std::size_t i=0; i<k; ++i)
+    {
+        for(std::size_t j=0; j<k; ++j)
+        {
+            double qtq = 0e0;
+            for(std::size_t l=0; l<m; ++l) qtq += Q(l,i) * Q(l,j);
+            BOOST_CHECK_SMALL(qtq - (i == j ? 1e0 : 0e0), tol);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(static_matrix)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, 5, 3> mat;
+    for(std::size_t i=0; i<5; ++i)
+        for(std::size_t j=0; j<3; ++j)
+            mat(i,j) = randreal(mt);
+    const auto qr = ax::QRdecompose(mat);
+    check_qr(mat, qr, 1e-12);
+    const ax::Matrix<double, 5, 3> Q = qr.Q();
+    const ax::Matrix<double, 3, 3> R = qr.R();
+    (void)Q; (void)R;
+
+    // Q^T * b without Q: its first 3 elements are those of Q_thin^T * b
+    ax::Vector<double, 5> b;
+    for(std::size_t i=0; i<5; ++i) b[i] = randreal(mt);
+    const ax::Vector<double, 5> qtb = qr.apply_Qt(b);
+    for(std::size_t j=0; j<3; ++j)
+    {
+        double expect = 0e0;
+        for(std::size_t i=0; i<5; ++i) expect += qr.Q()(i,j) * b[i];
+        BOOST_CHECK_SMALL(qtb[j] - expect, 1e-12);
+    }
+    const ax::Vector<double, 5> back = qr.apply_Q(qtb);
+    for(std::size_t i=0; i<5; ++i) BOOST_CHECK_SMALL(back[i] - b[i], 1e-12);
+
+    // the residual of the least squares solution is orthogonal to A
+    const ax::Vector<double, 3> x = qr.solve_least_squares(b);
+    for(std::size_t j=0; j<3; ++j)
+    {
+        double grad = 0e0;
+        for(std::size_t i=0; i<5; ++i)
+            grad += mat(i,j) * (mat(i,0) * x[0] + mat(i,1) * x[1] + mat(i,2) * x[2] - b[i]);
+        BOOST_CHECK_SMALL(grad, 1e-12);
+    }
+
+    // square: the exact solution
+    ax::Matrix<double, 3, 3> sq;
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j)
+            sq(i,j) = randreal(mt) + (i == j ? 3e0 : 0e0);
+    const ax::Vector<double, 3> rhs(1e0, 2e0, 3e0);
+    const auto xs = ax::QRdecompose(sq).solve_least_squares(rhs);
+    for(std::size_t i=0; i<3; ++i)
+        BOOST_CHECK_SMALL(sq(i,0) * xs[0] + sq(i,1) * xs[1] + sq(i,2) * xs[2] - rhs[i], 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(blocked)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    // several blocks of reflectors, and a last one that is partly filled
+    const std::size_t m = 120, n = 75;
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> mat(m, n), B(m, 3);
+    for(std::size_t i=0; i<m; ++i)
+    {
+        for(std::size_t j=0; j<n; ++j) mat(i,j) = randreal(mt);
+        for(std::size_t j=0; j<3; ++j) B(i,j) = randreal(mt);
+    }
+    const auto qr = ax::QRdecompose(mat);
+    check_qr(mat, qr, 1e-12);
+    BOOST_CHECK_EQUAL(qr.rank(), n);
+
+    // all the columns at once, and one by one
+    const auto X = qr.solve_least_squares(B);
+    BOOST_CHECK_EQUAL(ax::dimension_row(X), n);
+    BOOST_CHECK_EQUAL(ax::dimension_col(X), 3u);
+    for(std::size_t c=0; c<3; ++c)
+    {
+        ax::Vector<double, ax::DYNAMIC> b(m);
+        for(std::size_t i=0; i<m; ++i) b[i] = B(i,c);
+        const auto x = qr.solve_least_squares(b);
+        for(std::size_t j=0; j<n; ++j) BOOST_CHECK_SMALL(x[j] - X(j,c), 1e-12);
+
+        std::vector<double> res(m);
+        for(std::size_t i=0; i<m; ++i)
+        {
+            res[i] = -b[i];
+            for(std::size_t j=0; j<n; ++j) res[i] += mat(i,j) * x[j];
+        }
+        for(std::size_t j=0; j<n; ++j)
+        {
+            double grad = 0e0;
+            for(std::size_t i=0; i<m; ++i) grad += mat(i,j) * res[i];
+            BOOST_CHECK_SMALL(grad, 1e-11);
+        }
+    }
+
+    const auto QtB = qr.apply_Qt(B);
+    const auto QQtB = qr.apply_Q(QtB);
+    for(std::size_t i=0; i<m; ++i)
+        for(std::size_t j=0; j<3; ++j)
+            BOOST_CHECK_SMALL(QQtB(i,j) - B(i,j), 1e-12);
+    BOOST_CHECK_THROW(qr.apply_Qt(ax::Vector<double, ax::DYNAMIC>(m + 1)),
+                      std::invalid_argument);
+
+    // a tall data matrix with a static number of columns
+    ax::Matrix<double, ax::DYNAMIC, 4> data(50);
+    for(std::size_t i=0; i<50; ++i)
+        for(std::size_t j=0; j<4; ++j)
+            data(i,j) = randreal(mt);
+    check_qr(data, ax::QRdecompose(data), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(column_pivoting)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    // rank 6: the last 4 columns are combinations of the first 6
+    const std::size_t m = 40, n = 10;
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> mat(m, n);
+    for(std::size_t i=0; i<m; ++i)
+    {
+        for(std::size_t j=0; j<6; ++j) mat(i,j) = randreal(mt);
+        for(std::size_t j=6; j<n; ++j)
+            mat(i,j) = mat(i,j-6) - 0.5 * mat(i,j-5) + mat(i,j-4);
+    }
+    const auto qr = ax::QRdecompose_pivoted(mat);
+    BOOST_CHECK(qr.pivoting());
+    check_qr(mat, qr, 1e-12);
+    BOOST_CHECK_EQUAL(qr.rank(), 6u);
+    for(std::size_t i=1; i<n; ++i)
+        BOOST_CHECK(std::abs(qr.QR()(i,i)) <= std::abs(qr.QR()(i-1,i-1)) * (1e0 + 1e-12));
+
+    // the basic solution: zero in the columns beyond the rank
+    ax::Vector<double, ax::DYNAMIC> b(m);
+    for(std::size_t i=0; i<m; ++i) b[i] = randreal(mt);
+    const auto x = qr.solve_least_squares(b);
+    std::vector<double> res(m);
+    for(std::size_t i=0; i<m; ++i)
+    {
+        res[i] = -b[i];
+        for(std::size_t j=0; j<n; ++j) res[i] += mat(i,j) * x[j];
+    }
+    for(std::size_t j=0; j<n; ++j)
+    {
+        double grad = 0e0;
+        for(std::size_t i=0; i<m; ++i) grad += mat(i,j) * res[i];
+        BOOST_CHECK_SMALL(grad, 1e-11);
+    }
+    std::size_t nonzero = 0;
+    for(std::size_t j=0; j<n; ++j) if(x[j] != 0e0) ++nonzero;
+    BOOST_CHECK_EQUAL(nonzero, 6u);
+
+    // without pivoting a zero R(i, i) stops the solve
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> zero_col(m, n);
+    for(std::size_t i=0; i<m; ++i)
+        for(std::size_t j=0; j<n-1; ++j) zero_col(i,j) = randreal(mt);
+    BOOST_CHECK_THROW(ax::QRdecompose(zero_col).solve_least_squares(b),
+                      std::runtime_error);
+
+    // a wide consistent system is solved exactly
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> wide(4, 7);
+    ax::Vector<double, ax::DYNAMIC> rhs(4);
+    for(std::size_t i=0; i<4; ++i)
+    {
+        for(std::size_t j=0; j<7; ++j) wide(i,j) = randreal(mt);
+        rhs[i] = randreal(mt);
+    }
+    const auto wqr = ax::QRdecompose_pivoted(wide);
+    check_qr(wide, wqr, 1e-12);
+    const auto xw = wqr.solve_least_squares(rhs);
+    for(std::size_t i=0; i<4; ++i)
+    {
+        double ax_i = 0e0;
+        for(std::size_t j=0; j<7; ++j) ax_i += wide(i,j) * xw[j];
+        BOOST_CHECK_SMALL(ax_i - rhs[i], 1e-12);
+    }
+}
@@ -0,0 +1,219 @@
+#define BOOST_TEST_MODULE "test_SingularValueDecomposition"
+
+#ifdef UNITTEST_FRAMEWORK_LIBRARY_EXIST
+#include <boost/test/unit_test.hpp>
+#else
+#define BOOST_TEST_NO_LIB
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include "../src/SingularValueDecomposition.hpp"
+
+#include "test_Defs.hpp"
+using ax::test::seed;
+
+#include <random>
+
+// A = U * diag(s) * V^T, orthonormal columns, descending non-negative s
+template<typename T_mat, typename T_svd>
+void check_svd(const T_mat& mat, const T_svd& svd, const double tol)
+{
+    const std::size_t m = ax::dimension_row(mat);
+    const std::size_t n = ax::dimension_col(mat);
+    const std::size_t r = std::min(m, n);
+    const auto& U = svd.U();
+    const auto& V = svd.V();
+    const auto& s = svd.singular_values();
+    BOOST_CHECK_EQUAL(ax::dimension(s), r);
+    BOOST_CHECK_EQUAL(ax::dimension_row(U), m);
+    BOOST_CHECK_EQUAL(ax::dimension_col(U), r);
+    BOOST_CHECK_EQUAL(ax::dimension_row(V), n);
+    BOOST_CHECK_EQUAL(ax::dimension_col(V), r);
+
+    for(std::size_t i=0; i<r; ++i)
+    {
+        BOOST_CHECK(s[i] >= 0e0);
+        if(i != 0) BOOST_CHECK(s[i] <= s[i-1]);
+    }
+    for(std::size_t i=0; i<m; ++i)
+    {
+        for(std::size_t j=0; j<n; ++j)
+        {
+            double usv = 0e0;
+            for(std::size_t k=0; k<r; ++k) usv += U(i,k) * s[k] * V(j,k);
+            BOOST_CHECK_SMALL(usv - mat(i,j), tol);
+        }
+    }
+    for(std::size_t i=0; i<r; ++i)
+    {
+        for(std::size_t j=0; j<r; ++j)
+        {
+            double utu = 0e0, vtv = 0e0;
+            for(std::size_t k=0; k<m; ++k) utu += U(k,i) * U(k,j);
+            for(std::size_t k=0; k<n; ++k) vtv += V(k,i) * V(k,j);
+            BOOST_CHECK_SMALL(utu - (i == j ? 1e0 : 0e0), tol);
+            BOOST_CHECK_SMALL(vtv - (i == j ? 1e0 : 0e0), tol);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(tall_matrix)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, ax::DYNAMIC, 4> data(60);
+    for(std::size_t i=0; i<60; ++i)
+        for(std::size_t j=0; j<4; ++j)
+            data(i,j) = randreal(mt) * (j + 1);
+
+    const auto svd = ax::SVdecompose(data);
+    check_svd(data, svd, 1e-12);
+    BOOST_CHECK_EQUAL(svd.rank(), 4u);
+    BOOST_CHECK(svd.num_sweep() >= 1);
+
+    // the squared singular values are the eigenvalues of A^T * A
+    ax::Matrix<double, 4, 4> gram(0e0);
+    for(std::size_t i=0; i<4; ++i)
+        for(std::size_t j=0; j<4; ++j)
+            for(std::size_t k=0; k<60; ++k)
+                gram(i,j) += data(k,i) * data(k,j);
+    const auto eigenpair = ax::Jacobimethod(gram);
+    std::vector<double> eigenvalues;
+    for(const auto& p : eigenpair) eigenvalues.push_back(p.first);
+    std::sort(eigenvalues.begin(), eigenvalues.end());
+    for(std::size_t i=0; i<4; ++i)
+        BOOST_CHECK_CLOSE(svd.singular_values()[i] * svd.singular_values()[i],
+                          eigenvalues.at(3 - i), 1e-8);
+
+    // least squares: A^T * (A * x - b) = 0
+    ax::Vector<double, ax::DYNAMIC> b(60);
+    for(std::size_t i=0; i<60; ++i) b[i] = randreal(mt);
+    const ax::Vector<double, 4> x = svd.solve(b);
+    for(std::size_t j=0; j<4; ++j)
+    {
+        double grad = 0e0;
+        for(std::size_t i=0; i<60; ++i)
+        {
+            double res = -b[i];
+            for(std::size_t k=0; k<4; ++k) res += data(i,k) * x[k];
+            grad += data(i,j) * res;
+        }
+        BOOST_CHECK_SMALL(grad, 1e-10);
+    }
+    BOOST_CHECK_THROW(svd.solve(ax::Vector<double, ax::DYNAMIC>(59)),
+                      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(rank_deficient)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    // the third column is the sum of the first two, the fifth is zero
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> mat(30, 5);
+    for(std::size_t i=0; i<30; ++i)
+    {
+        mat(i,0) = randreal(mt);
+        mat(i,1) = randreal(mt);
+        mat(i,2) = mat(i,0) + mat(i,1);
+        mat(i,3) = randreal(mt);
+        mat(i,4) = 0e0;
+    }
+    const auto svd = ax::SVdecompose(mat);
+    check_svd(mat, svd, 1e-12);
+    BOOST_CHECK_EQUAL(svd.rank(), 3u);
+    BOOST_CHECK(svd.condition_number() > 1e12);
+
+    // A * A^+ * A = A, and the minimum norm solution has no null part
+    const auto pinv = svd.pseudo_inverse();
+    BOOST_CHECK_EQUAL(ax::dimension_row(pinv), 5u);
+    BOOST_CHECK_EQUAL(ax::dimension_col(pinv), 30u);
+    for(std::size_t i=0; i<30; ++i)
+    {
+        for(std::size_t j=0; j<5; ++j)
+        {
+            double apa = 0e0;
+            for(std::size_t k=0; k<5; ++k)
+                for(std::size_t l=0; l<30; ++l)
+                    apa += mat(i,k) * pinv(k,l) * mat(l,j);
+            BOOST_CHECK_SMALL(apa - mat(i,j), 1e-12);
+        }
+    }
+    ax::Vector<double, ax::DYNAMIC> b(30);
+    for(std::size_t i=0; i<30; ++i) b[i] = randreal(mt);
+    const auto x = svd.solve(b);
+    BOOST_CHECK_SMALL(x[0] + x[1] - x[2], 1e-12);
+    BOOST_CHECK_SMALL(x[4], 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(wide_and_static)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> wide(5, 9);
+    for(std::size_t i=0; i<5; ++i)
+        for(std::size_t j=0; j<9; ++j)
+            wide(i,j) = randreal(mt);
+    check_svd(wide, ax::SVdecompose(wide), 1e-12);
+
+    ax::Matrix<double, 4, 6> fixed;
+    for(std::size_t i=0; i<4; ++i)
+        for(std::size_t j=0; j<6; ++j)
+            fixed(i,j) = randreal(mt);
+    const auto svd = ax::SVdecompose(fixed);
+    const ax::Matrix<double, 4, 4>& U = svd.U();
+    const ax::Matrix<double, 6, 4>& V = svd.V();
+    const ax::Vector<double, 4>&    s = svd.singular_values();
+    check_svd(fixed, svd, 1e-12);
+
+    // the same singular values through the transpose
+    const auto svdt = ax::SVdecompose(ax::transpose(fixed));
+    for(std::size_t i=0; i<4; ++i)
+        BOOST_CHECK_CLOSE(svdt.singular_values()[i], s[i], 1e-10);
+    (void)U; (void)V;
+}
+
+BOOST_AUTO_TEST_CASE(closed_form_3x3)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    for(std::size_t trial=0; trial<100; ++trial)
+    {
+        ax::Matrix<double, 3, 3> mat;
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+                mat(i,j) = randreal(mt);
+        const auto svd = ax::SVdecompose(mat);
+        BOOST_CHECK_EQUAL(svd.num_sweep(), 0u);
+        check_svd(mat, svd, 1e-12);
+
+        // the general path on the same matrix
+        const ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> dmat(mat);
+        const auto jacobi = ax::SVdecompose(dmat);
+        for(std::size_t i=0; i<3; ++i)
+            BOOST_CHECK_SMALL(svd.singular_values()[i] -
+                              jacobi.singular_values()[i], 1e-12);
+    }
+
+    // rank 2, rank 1 and zero
+    ax::Matrix<double, 3, 3> rank2, rank1, zero(0e0);
+    for(std::size_t i=0; i<3; ++i)
+    {
+        rank2(i,0) = randreal(mt);
+        rank2(i,1) = randreal(mt);
+        rank2(i,2) = 2e0 * rank2(i,0) - rank2(i,1);
+        for(std::size_t j=0; j<3; ++j) rank1(i,j) = (i + 1e0) * (j - 1.5);
+    }
+    const auto svd2 = ax::SVdecompose(rank2);
+    check_svd(rank2, svd2, 1e-12);
+    BOOST_CHECK_EQUAL(svd2.rank(), 2u);
+    const auto svd1 = ax::SVdecompose(rank1);
+    check_svd(rank1, svd1, 1e-12);
+    BOOST_CHECK_EQUAL(svd1.rank(), 1u);
+    const auto svd0 = ax::SVdecompose(zero);
+    check_svd(zero, svd0, 1e-12);
+    BOOST_CHECK_EQUAL(svd0.rank(), 0u);
+}
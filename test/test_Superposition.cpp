@@ -0,0 +1,216 @@
+#define BOOST_TEST_MODULE "test_Superposition"
+
+#ifdef UNITTEST_FRAMEWORK_LIBRARY_EXIST
+#include <boost/test/unit_test.hpp>
+#else
+#define BOOST_TEST_NO_LIB
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include "../src/Superposition.hpp"
+#include "../src/SingularValueDecomposition.hpp"
+#include "../src/InverseMatrix.hpp"
+
+#include "test_Defs.hpp"
+using ax::test::seed;
+
+#include <random>
+
+typedef ax::Vector<double, 3> coord_type;
+
+std::vector<coord_type> random_coords(const std::size_t n, std::mt19937& mt)
+{
+    std::uniform_real_distribution<double> randreal(-1e1, 1e1);
+    std::vector<coord_type> retval(n);
+    for(std::size_t i=0; i<n; ++i)
+        for(std::size_t a=0; a<3; ++a) retval[i][a] = randreal(mt);
+    return retval;
+}
+
+ax::Matrix<double, 3, 3> random_rotation(std::mt19937& mt)
+{
+    std::normal_distribution<double> gauss(0e0, 1e0);
+    double q[4], norm = 0e0;
+    for(std::size_t i=0; i<4; ++i){q[i] = gauss(mt); norm += q[i] * q[i];}
+    for(std::size_t i=0; i<4; ++i) q[i] /= std::sqrt(norm);
+    return ax::detail::quaternion_rotation(q);
+}
+
+// RMSD between x and R * (y - cy) + cx
+double explicit_rmsd(const std::vector<coord_type>& x,
+                     const std::vector<coord_type>& y,
+                     const ax::Superposition<double>& sp)
+{
+    double sum = 0e0;
+    for(std::size_t i=0; i<x.size(); ++i)
+        for(std::size_t a=0; a<3; ++a)
+        {
+            double ry = sp.reference_center[a];
+            for(std::size_t b=0; b<3; ++b)
+                ry += sp.rotation(a, b) * (y[i][b] - sp.mobile_center[b]);
+            sum += (ry - x[i][a]) * (ry - x[i][a]);
+        }
+    return std::sqrt(sum / x.size());
+}
+
+void check_rotation(const ax::Matrix<double, 3, 3>& r)
+{
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j)
+        {
+            double rtr = 0e0;
+            for(std::size_t k=0; k<3; ++k) rtr += r(k, i) * r(k, j);
+            BOOST_CHECK_SMALL(rtr - (i == j ? 1e0 : 0e0), 1e-12);
+        }
+    BOOST_CHECK_CLOSE_FRACTION(ax::determinant(r), 1e0, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(rigid_motion)
+{
+    std::mt19937 mt(seed);
+    for(std::size_t test_times=0; test_times<20; ++test_times)
+    {
+        const std::vector<coord_type> x = random_coords(30, mt);
+        const ax::Matrix<double, 3, 3> rot = random_rotation(mt);
+        const coord_type shift(1e0, -2e0, 3e0);
+
+        // x = rot^T * (y - shift), so rot is the answer
+        std::vector<coord_type> y(x.size());
+        for(std::size_t i=0; i<x.size(); ++i)
+            for(std::size_t a=0; a<3; ++a)
+            {
+                y[i][a] = shift[a];
+                for(std::size_t b=0; b<3; ++b) y[i][a] += rot(a, b) * x[i][b];
+            }
+
+        const ax::Superposition<double> sp = ax::superpose(x, y);
+        check_rotation(sp.rotation);
+        BOOST_CHECK_SMALL(sp.rmsd, 1e-6);
+        BOOST_CHECK_SMALL(explicit_rmsd(x, y, sp), 1e-10);
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+                BOOST_CHECK_SMALL(sp.rotation(i, j) - rot(j, i), 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(kabsch)
+{
+    std::mt19937 mt(seed);
+    std::normal_distribution<double> noise(0e0, 1e0);
+    for(std::size_t test_times=0; test_times<20; ++test_times)
+    {
+        const std::vector<coord_type> x = random_coords(25, mt);
+        const ax::Matrix<double, 3, 3> rot = random_rotation(mt);
+        std::vector<coord_type> y(x.size());
+        for(std::size_t i=0; i<x.size(); ++i)
+            for(std::size_t a=0; a<3; ++a)
+            {
+                y[i][a] = noise(mt);
+                for(std::size_t b=0; b<3; ++b) y[i][a] += rot(a, b) * x[i][b];
+            }
+
+        const ax::Superposition<double> sp = ax::superpose(x, y);
+        check_rotation(sp.rotation);
+        BOOST_CHECK_CLOSE_FRACTION(sp.rmsd, explicit_rmsd(x, y, sp), 1e-8);
+        BOOST_CHECK_CLOSE_FRACTION(ax::superposed_rmsd(x, y), sp.rmsd, 1e-12);
+
+        // Kabsch: S = U * s * V^T, R = V * diag(1, 1, d) * U^T
+        ax::Matrix<double, 3, 3> s;
+        for(std::size_t i=0; i<x.size(); ++i)
+            for(std::size_t a=0; a<3; ++a)
+                for(std::size_t b=0; b<3; ++b)
+                    s(a, b) += (y[i][a] - sp.mobile_center[a]) *
+                               (x[i][b] - sp.reference_center[b]);
+        const auto svd = ax::SVdecompose(s);
+        ax::Superposition<double> kabsch = sp;
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+            {
+                kabsch.rotation(i, j) = 0e0;
+                for(std::size_t k=0; k<3; ++k)
+                    kabsch.rotation(i, j) += svd.V()(i, k) * svd.U()(j, k);
+            }
+        if(ax::determinant(kabsch.rotation) < 0e0)
+            for(std::size_t i=0; i<3; ++i)
+                for(std::size_t j=0; j<3; ++j)
+                    kabsch.rotation(i, j) -=
+                        2e0 * svd.V()(i, 2) * svd.U()(j, 2);
+
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=0; j<3; ++j)
+                BOOST_CHECK_SMALL(sp.rotation(i, j) - kabsch.rotation(i, j), 1e-8);
+        BOOST_CHECK_CLOSE_FRACTION(explicit_rmsd(x, y, kabsch), sp.rmsd, 1e-8);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(degenerate)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e1, 1e1);
+
+    // collinear points: any rotation about the line is optimal
+    std::vector<coord_type> x, y;
+    for(std::size_t i=0; i<10; ++i)
+    {
+        const double t = randreal(mt);
+        x.push_back(coord_type(t, 2e0 * t, -t));
+        y.push_back(coord_type(2e0 * t + 1e0, -t, t));
+    }
+    const ax::Superposition<double> sp = ax::superpose(x, y);
+    check_rotation(sp.rotation);
+    BOOST_CHECK_SMALL(sp.rmsd, 1e-6);
+    BOOST_CHECK_SMALL(explicit_rmsd(x, y, sp), 1e-10);
+
+    // identical structures
+    const std::vector<coord_type> z = random_coords(12, mt);
+    const ax::Superposition<double> same = ax::superpose(z, z);
+    check_rotation(same.rotation);
+    BOOST_CHECK_SMALL(explicit_rmsd(z, z, same), 1e-10);
+
+    // a single point
+    const ax::Superposition<double> one = ax::superpose(x.data(), y.data(), 1);
+    check_rotation(one.rotation);
+    BOOST_CHECK_EQUAL(one.rmsd, 0e0);
+
+    BOOST_CHECK_THROW(ax::superpose(x, z), std::invalid_argument);
+    BOOST_CHECK_THROW(ax::superpose(x.data(), y.data(), 0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(rmsd_matrix)
+{
+    std::mt19937 mt(seed);
+    std::normal_distribution<double> noise(0e0, 5e-1);
+    const std::vector<coord_type> base = random_coords(21, mt);
+    std::vector<std::vector<coord_type>> frames(9);
+    for(std::size_t f=0; f<frames.size(); ++f)
+    {
+        const ax::Matrix<double, 3, 3> rot = random_rotation(mt);
+        frames[f].resize(base.size());
+        for(std::size_t i=0; i<base.size(); ++i)
+            for(std::size_t a=0; a<3; ++a)
+            {
+                frames[f][i][a] = noise(mt);
+                for(std::size_t b=0; b<3; ++b)
+                    frames[f][i][a] += rot(a, b) * base[i][b];
+            }
+    }
+
+    const ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> rmsd =
+        ax::superposed_rmsd_matrix(frames);
+    BOOST_CHECK_EQUAL(ax::dimension_row(rmsd), frames.size());
+    BOOST_CHECK_EQUAL(ax::dimension_col(rmsd), frames.size());
+    for(std::size_t i=0; i<frames.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(rmsd(i, i), 0e0);
+        for(std::size_t j=0; j<frames.size(); ++j)
+        {
+            if(i == j) continue;
+            BOOST_CHECK_EQUAL(rmsd(i, j), rmsd(j, i));
+            BOOST_CHECK_CLOSE_FRACTION(
+                rmsd(i, j), ax::superposed_rmsd(frames[i], frames[j]), 1e-10);
+        }
+    }
+
+    frames.back().pop_back();
+    BOOST_CHECK_THROW(ax::superposed_rmsd_matrix(frames), std::invalid_argument);
+}
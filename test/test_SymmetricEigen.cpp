@@ -0,0 +1,141 @@
+#define BOOST_TEST_MODULE "test_SymmetricEigen"
+
+#ifdef UNITTEST_FRAMEWORK_LIBRARY_EXIST
+#include <boost/test/unit_test.hpp>
+#else
+#define BOOST_TEST_NO_LIB
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include "../src/SymmetricEigen.hpp"
+#include "../src/JacobiMethod.hpp"
+
+#include "test_Defs.hpp"
+using ax::test::seed;
+
+#include <random>
+
+typedef ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC> dmatrix;
+
+// every eigenpair of mat in ascending order, and the trace
+template<typename T_pairs>
+void check_spectrum(const dmatrix& mat, const T_pairs& eigenpair,
+                    const double tol)
+{
+    const std::size_t n = ax::dimension_row(mat);
+    BOOST_CHECK_EQUAL(eigenpair.size(), n);
+    ax::test::check_eigenpairs(mat, eigenpair, tol, tol, true);
+
+    double trace = 0e0, sum = 0e0;
+    for(std::size_t i=0; i<eigenpair.size(); ++i)
+    {
+        trace += mat(i,i);
+        sum   += eigenpair.at(i).first;
+    }
+    BOOST_CHECK_SMALL(trace - sum, tol * n);
+}
+
+BOOST_AUTO_TEST_CASE(small_matrices)
+{
+    dmatrix one(1, 1);
+    one(0,0) = 3e0;
+    const auto p1 = ax::eigen_symmetric(one);
+    BOOST_CHECK_EQUAL(p1.size(), 1u);
+    BOOST_CHECK_EQUAL(p1.at(0).first, 3e0);
+    BOOST_CHECK_EQUAL(std::abs(p1.at(0).second[0]), 1e0);
+
+    for(std::size_t n=2; n<6; ++n)
+    {
+        const dmatrix mat = ax::test::random_symmetric<dmatrix>(n);
+        check_spectrum(mat, ax::eigen_symmetric(mat), 1e-12);
+    }
+
+    dmatrix rect(3, 4);
+    BOOST_CHECK_THROW(ax::eigen_symmetric(rect), std::invalid_argument);
+    dmatrix asym(3, 3);
+    asym(0,1) = 1e0;
+    BOOST_CHECK_THROW(ax::eigen_symmetric(asym), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(compare_with_jacobi)
+{
+    const std::size_t msize = 60;
+    const dmatrix mat = ax::test::random_symmetric<dmatrix>(msize);
+
+    const auto eigenpair = ax::eigen_symmetric(mat);
+    check_spectrum(mat, eigenpair, 1e-11);
+
+    auto jacobi = ax::Jacobimethod(mat);
+    std::sort(jacobi.begin(), jacobi.end(),
+        [](const std::pair<double, ax::Vector<double, ax::DYNAMIC>>& l,
+           const std::pair<double, ax::Vector<double, ax::DYNAMIC>>& r)
+        {return l.first < r.first;});
+    const std::vector<double> values =
+        ax::HouseholderQL<dmatrix>(mat).eigenvalues();
+    for(std::size_t i=0; i<msize; ++i)
+    {
+        BOOST_CHECK_SMALL(eigenpair.at(i).first - jacobi.at(i).first, 1e-12);
+        BOOST_CHECK_SMALL(values.at(i) - jacobi.at(i).first, 1e-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(degenerate_spectrum)
+{
+    // Q * diag(1, 1, 1, 2, 2, 3, ...) * Q^T, Q from the Jacobi eigenvectors
+    // of a random matrix
+    const std::size_t msize = 40;
+    const auto basis = ax::Jacobimethod(ax::test::random_symmetric<dmatrix>(msize));
+    dmatrix mat(msize, msize);
+    for(std::size_t k=0; k<msize; ++k)
+    {
+        const double lambda = static_cast<double>(k / 3);
+        const ax::Vector<double, ax::DYNAMIC>& q = basis.at(k).second;
+        for(std::size_t i=0; i<msize; ++i)
+            for(std::size_t j=0; j<msize; ++j)
+                mat(i,j) += lambda * q[i] * q[j];
+    }
+    for(std::size_t i=0; i<msize; ++i)
+        for(std::size_t j=0; j<i; ++j)
+            mat(i,j) = mat(j,i);
+
+    const auto eigenpair = ax::eigen_symmetric(mat);
+    check_spectrum(mat, eigenpair, 1e-12);
+    for(std::size_t k=0; k<msize; ++k)
+        BOOST_CHECK_SMALL(eigenpair.at(k).first - static_cast<double>(k / 3), 1e-12);
+
+    // already tridiagonal and diagonal inputs
+    dmatrix diag(msize, msize);
+    for(std::size_t i=0; i<msize; ++i) diag(i,i) = static_cast<double>(msize - i);
+    const auto pairs = ax::eigen_symmetric(diag);
+    for(std::size_t i=0; i<msize; ++i)
+    {
+        BOOST_CHECK_EQUAL(pairs.at(i).first, static_cast<double>(i + 1));
+        BOOST_CHECK_EQUAL(std::abs(pairs.at(i).second[msize - 1 - i]), 1e0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blocked_matrix)
+{
+    // several panels of the reduction and blocks of the back transformation,
+    // the product with the trailing matrix split in row ranges
+    const std::size_t msize = 300;
+    const dmatrix mat = ax::test::random_symmetric<dmatrix>(msize);
+    const auto eigenpair = ax::eigen_symmetric(mat);
+    check_spectrum(mat, eigenpair, 1e-10);
+
+    // the same result on several threads
+    const std::size_t nthreads  = ax::get_num_threads();
+    const std::size_t threshold = ax::get_parallel_threshold();
+    ax::set_num_threads(3);
+    ax::set_parallel_threshold(1);
+    const auto eigenpair_mt = ax::eigen_symmetric(mat);
+    ax::set_num_threads(nthreads);
+    ax::set_parallel_threshold(threshold);
+
+    for(std::size_t i=0; i<msize; ++i)
+    {
+        BOOST_CHECK_EQUAL(eigenpair_mt.at(i).first, eigenpair.at(i).first);
+        for(std::size_t j=0; j<msize; ++j)
+            BOOST_CHECK_EQUAL(eigenpair_mt.at(i).second[j], eigenpair.at(i).second[j]);
+    }
+}
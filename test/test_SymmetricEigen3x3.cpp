@@ -0,0 +1,132 @@
+#define BOOST_TEST_MODULE "test_SymmetricEigen3x3"
+
+#ifdef UNITTEST_FRAMEWORK_LIBRARY_EXIST
+#include <boost/test/unit_test.hpp>
+#else
+#define BOOST_TEST_NO_LIB
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include "../src/SymmetricEigen3x3.hpp"
+
+#include "test_Defs.hpp"
+using ax::test::seed;
+
+#include <random>
+
+namespace
+{
+// R * diag(l0, l1, l2) * R^T for a random rotation R
+ax::Matrix<double, 3, 3>
+rotated_diagonal(std::mt19937& mt, const double l0, const double l1, const double l2)
+{
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+    ax::Matrix<double, 3, 3> M;
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j)
+            M(i, j) = randreal(mt);
+    // Gram-Schmidt on the columns of M
+    ax::Vector<double, 3> e0(M(0,0), M(1,0), M(2,0));
+    ax::Vector<double, 3> e1(M(0,1), M(1,1), M(2,1));
+    e0 = ax::normalize(e0);
+    e1 = ax::normalize(e1 - ax::dot_prod(e0, e1) * e0);
+    const ax::Vector<double, 3> e2 = ax::cross_prod(e0, e1);
+
+    ax::Matrix<double, 3, 3> A;
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<3; ++j)
+            A(i, j) = l0 * e0[i] * e0[j] + l1 * e1[i] * e1[j] + l2 * e2[i] * e2[j];
+    return A;
+}
+}
+
+BOOST_AUTO_TEST_CASE(symmetric3x3)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    for(std::size_t n=0; n<100; ++n)
+    {
+        ax::Matrix<double, 3, 3> mat;
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=i; j<3; ++j)
+                mat(i,j) = mat(j,i) = randreal(mt);
+
+        const auto eigenpair = ax::eigen_symmetric3x3(mat);
+        ax::test::check_eigenpairs(mat, eigenpair, 1e-12, 1e-12, true);
+        BOOST_CHECK_CLOSE(eigenpair[0].first + eigenpair[1].first + eigenpair[2].first,
+                          mat(0,0) + mat(1,1) + mat(2,2), 1e-8);
+    }
+
+    // double, nearly double and triple eigenvalues, a wide spread
+    const double cases[][3] = {
+        {1e0, 1e0, 2e0}, {-3e0, 5e0, 5e0}, {1e0, 1e0 + 1e-9, 2e0},
+        {2e0, 2e0, 2e0}, {1e-8, 1e0, 1e8}, {0e0, 0e0, 1e0}};
+    for(const auto& l : cases)
+    {
+        const ax::Matrix<double, 3, 3> mat = rotated_diagonal(mt, l[0], l[1], l[2]);
+        const auto eigenpair = ax::eigen_symmetric3x3(mat);
+        const double scale = std::max(std::abs(l[0]), std::abs(l[2]));
+        ax::test::check_eigenpairs(mat, eigenpair, 1e-12 * scale, 1e-12, true);
+        for(std::size_t i=0; i<3; ++i)
+            BOOST_CHECK_SMALL(eigenpair[i].first - l[i], 1e-12 * scale);
+    }
+
+    const auto zero = ax::eigen_symmetric3x3(ax::Matrix<double, 3, 3>());
+    ax::test::check_eigenpairs(ax::Matrix<double, 3, 3>(), zero, 1e-15, 1e-12, true);
+
+    // only the upper triangle is read
+    ax::Matrix<double, 3, 3> upper;
+    upper(0,0) = 2e0; upper(0,1) = 1e0; upper(1,1) = 2e0; upper(2,2) = 3e0;
+    const auto eigenpair = ax::eigen_symmetric3x3(upper);
+    BOOST_CHECK_CLOSE(eigenpair[0].first, 1e0, 1e-12);
+    BOOST_CHECK_CLOSE(eigenpair[1].first, 3e0, 1e-12);
+    BOOST_CHECK_CLOSE(eigenpair[2].first, 3e0, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(symmetric3x3_batch)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    const std::size_t N = 203;
+    ax::Matrix3Batch<double> mats(N);
+    for(std::size_t k=0; k<N; ++k)
+    {
+        ax::Matrix<double, 3, 3> mat;
+        for(std::size_t i=0; i<3; ++i)
+            for(std::size_t j=i; j<3; ++j)
+                mat(i,j) = mat(j,i) = randreal(mt);
+        mats.set(k, mat);
+    }
+    // a few degenerate ones go through the scalar path
+    mats.set(3,  rotated_diagonal(mt, 1e0, 1e0, 2e0));
+    mats.set(10, rotated_diagonal(mt, -1e0, 4e0, 4e0));
+    mats.set(11, ax::Matrix<double, 3, 3>(5e0));
+    mats.set(12, ax::Matrix<double, 3, 3>());
+
+    std::array<std::vector<double>, 3> values;
+    ax::Matrix3Batch<double> vectors;
+    const std::size_t num_fallback = ax::eigen_symmetric3x3(mats, values, vectors);
+    BOOST_CHECK(num_fallback >= 4);
+    BOOST_CHECK(num_fallback <  10);
+    BOOST_CHECK_EQUAL(values[0].size(), N);
+    BOOST_CHECK_EQUAL(vectors.size(), N);
+
+    for(std::size_t k=0; k<N; ++k)
+    {
+        const ax::Matrix<double, 3, 3> mat = mats.matrix(k);
+        std::array<std::pair<double, ax::Vector<double, 3>>, 3> eigenpair;
+        for(std::size_t i=0; i<3; ++i)
+        {
+            eigenpair[i].first = values[i][k];
+            for(std::size_t j=0; j<3; ++j)
+                eigenpair[i].second[j] = vectors(k, j, i);
+        }
+        ax::test::check_eigenpairs(mat, eigenpair, 1e-10, 1e-12, true);
+
+        const auto ref = ax::eigen_symmetric3x3(mat);
+        for(std::size_t i=0; i<3; ++i)
+            BOOST_CHECK_SMALL(values[i][k] - ref[i].first, 1e-12);
+    }
+}
@@ -262,3 +262,115 @@ BOOST_AUTO_TEST_CASE(MatrixNd_transpose)
         for(std::size_t j=i+1; j<Dim_N; ++j)
             BOOST_CHECK_EQUAL(mat3.at(j, i), mat3.at(i, j));
 }
+
+BOOST_AUTO_TEST_CASE(MatrixNd_layout)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(0e0, 1e0);
+
+    std::vector<std::vector<double>> rand1(Dim_N, std::vector<double>(Dim_M));
+    for(std::size_t i=0; i<Dim_N; ++i)
+        for(std::size_t j=0; j<Dim_M; ++j)
+            rand1[i][j] = randreal(mt);
+
+    MatrixNMd mat1(rand1);
+    BOOST_CHECK_EQUAL(mat1.size_row(), Dim_N);
+    BOOST_CHECK_EQUAL(mat1.size_col(), Dim_M);
+    BOOST_CHECK_EQUAL(mat1.stride(),   Dim_M);
+
+    const double* ptr = mat1.data();
+    for(std::size_t i=0; i<Dim_N; ++i)
+        for(std::size_t j=0; j<Dim_M; ++j)
+            BOOST_CHECK_EQUAL(ptr[i * mat1.stride() + j], rand1[i][j]);
+
+    const MatrixNMd mat2(Dim_N, Dim_M,
+            std::vector<double>(mat1.data(), mat1.data() + Dim_N * Dim_M));
+    for(std::size_t i=0; i<Dim_N; ++i)
+        for(std::size_t j=0; j<Dim_M; ++j)
+            BOOST_CHECK_EQUAL(mat2(i, j), rand1[i][j]);
+
+    MatrixNMd mat3;
+    mat3 = transpose(mat1);
+    BOOST_CHECK_EQUAL(mat3.size_row(), Dim_M);
+    BOOST_CHECK_EQUAL(mat3.size_col(), Dim_N);
+    for(std::size_t i=0; i<Dim_N; ++i)
+        for(std::size_t j=0; j<Dim_M; ++j)
+            BOOST_CHECK_EQUAL(mat3(j, i), rand1[i][j]);
+
+    BOOST_CHECK_THROW(mat1.at(Dim_N, 0), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(Matrix3xN_layout)
+{
+    using Matrix3Nd = ax::Matrix<double, 3, ax::DYNAMIC>;
+    using MatrixN3d = ax::Matrix<double, ax::DYNAMIC, 3>;
+
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(0e0, 1e0);
+
+    std::vector<double> rand1(3 * Dim_N);
+    for(auto& r : rand1) r = randreal(mt);
+
+    const Matrix3Nd mat1(Dim_N, rand1);
+    BOOST_CHECK_EQUAL(mat1.size_row(), 3u);
+    BOOST_CHECK_EQUAL(mat1.size_col(), Dim_N);
+    BOOST_CHECK_EQUAL(mat1.stride(),   Dim_N);
+    BOOST_CHECK_EQUAL(
+        reinterpret_cast<std::uintptr_t>(mat1.data()) % ax::AX_ALIGNMENT, 0u);
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<Dim_N; ++j)
+            BOOST_CHECK_EQUAL(mat1(i, j), rand1[i * Dim_N + j]);
+
+    const Matrix3Nd mat2 = mat1 + mat1;
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<Dim_N; ++j)
+            BOOST_CHECK_EQUAL(mat2(i, j), 2e0 * rand1[i * Dim_N + j]);
+
+    const MatrixN3d mat3 = transpose(mat1);
+    BOOST_CHECK_EQUAL(mat3.size_row(), Dim_N);
+    BOOST_CHECK_EQUAL(mat3.size_col(), 3u);
+    BOOST_CHECK_EQUAL(mat3.stride(),   3u);
+    BOOST_CHECK_EQUAL(
+        reinterpret_cast<std::uintptr_t>(mat3.data()) % ax::AX_ALIGNMENT, 0u);
+    for(std::size_t i=0; i<3; ++i)
+        for(std::size_t j=0; j<Dim_N; ++j)
+            BOOST_CHECK_EQUAL(mat3.data()[j * mat3.stride() + i],
+                              rand1[i * Dim_N + j]);
+
+    MatrixN3d mat4;
+    mat4 = mat3 * 2e0;
+    BOOST_CHECK_EQUAL(mat4.size_row(), Dim_N);
+    for(std::size_t i=0; i<Dim_N; ++i)
+        for(std::size_t j=0; j<3; ++j)
+            BOOST_CHECK_EQUAL(mat4(i, j), 2e0 * mat3(i, j));
+}
+
+BOOST_AUTO_TEST_CASE(MatrixNd_packet)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(0e0, 1e0);
+
+    std::vector<std::vector<double>> rand1(Dim_N, std::vector<double>(Dim_M + 1));
+    std::vector<std::vector<double>> rand2(Dim_N, std::vector<double>(Dim_M + 1));
+    for(std::size_t i=0; i<Dim_N; ++i)
+        for(std::size_t j=0; j<Dim_M + 1; ++j)
+        {
+            rand1[i][j] = randreal(mt);
+            rand2[i][j] = randreal(mt);
+        }
+
+    const MatrixNMd mat1(rand1);
+    const MatrixNMd mat2(rand2);
+    const double a = randreal(mt);
+
+    const auto expr = mat1 * a + mat2;
+    static_assert(ax::detail::has_packet_access<decltype(expr)>::value,
+                  "element-wise expression must be packet-accessible");
+    static_assert(!ax::detail::has_packet_access<decltype(transpose(mat1))>::value,
+                  "transpose must not be packet-accessible");
+
+    const MatrixNMd mat3 = expr;
+    for(std::size_t i=0; i<Dim_N; ++i)
+        for(std::size_t j=0; j<Dim_M + 1; ++j)
+            BOOST_CHECK_EQUAL(mat3(i, j), rand1[i][j] * a + rand2[i][j]);
+}
@@ -185,3 +185,96 @@ BOOST_AUTO_TEST_CASE(VectorNd_length)
         BOOST_CHECK_CLOSE_FRACTION(len_square(vec1), dot_prod(vec1, vec1), tolerance);
     }
 }
+
+BOOST_AUTO_TEST_CASE(VectorNd_packet)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(0e0, 1e0);
+
+    // not a multiple of any packet size
+    constexpr std::size_t size = 1003;
+    std::vector<double> x(size), b(size);
+    for(std::size_t i=0; i<size; ++i)
+    {
+        x[i] = randreal(mt);
+        b[i] = randreal(mt);
+    }
+    const VectorDd vx(x);
+    const VectorDd vb(b);
+    const double a = randreal(mt);
+
+    const auto expr = a * vx + vb;
+    static_assert(ax::detail::has_packet_access<decltype(expr)>::value,
+                  "element-wise expression must be packet-accessible");
+
+    VectorDd y;
+    y = expr;
+    BOOST_CHECK_EQUAL(y.size(), size);
+    for(std::size_t i=0; i<size; ++i)
+        BOOST_CHECK_EQUAL(y[i], a * x[i] + b[i]);
+
+    const VectorDd z = (vx - vb) / a;
+    for(std::size_t i=0; i<size; ++i)
+        BOOST_CHECK_EQUAL(z[i], (x[i] - b[i]) / a);
+}
+
+BOOST_AUTO_TEST_CASE(VectorNd_compound_assignment)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(0e0, 1e0);
+
+    constexpr std::size_t size = 1003;
+    std::vector<double> x(size), b(size);
+    for(std::size_t i=0; i<size; ++i)
+    {
+        x[i] = randreal(mt);
+        b[i] = randreal(mt);
+    }
+    const VectorDd vb(b);
+    const double a = randreal(mt) + 1e0;
+
+    VectorDd y(x);
+    const double* const ptr = y.data();
+    y += a * vb;
+    y -= vb;
+    y *= a;
+    y /= 2e0;
+    BOOST_CHECK_EQUAL(y.data(), ptr);
+    for(std::size_t i=0; i<size; ++i)
+        BOOST_CHECK_EQUAL(y[i], ((x[i] + a * b[i]) - b[i]) * a / 2e0);
+
+    VectorDd z(size - 1);
+    BOOST_CHECK_THROW(z += vb, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(VectorNd_large_reduction)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(0e0, 1e0);
+
+    // deep enough to overflow the stack with a recursive reduction
+    constexpr std::size_t size = 1000003;
+    std::vector<double> v1(size), v2(size);
+    long double dot_product = 0e0, lensq = 0e0;
+    for(std::size_t i=0; i<size; ++i)
+    {
+        v1[i] = randreal(mt);
+        v2[i] = randreal(mt);
+        dot_product += static_cast<long double>(v1[i]) * v2[i];
+        lensq       += static_cast<long double>(v1[i]) * v1[i];
+    }
+    const VectorDd vec1(v1);
+    const VectorDd vec2(v2);
+
+    BOOST_CHECK_CLOSE_FRACTION(dot_prod(vec1, vec2), dot_product, 1e-10);
+    BOOST_CHECK_CLOSE_FRACTION(len_square(vec1), lensq, 1e-10);
+    BOOST_CHECK_CLOSE_FRACTION(len_square(vec1 - vec2),
+            dot_prod(vec1 - vec2, vec1 - vec2), 1e-12);
+
+    const ax::Vector<double, 3> small(1e0, 2e0, 3e0);
+    const VectorDd mixed(std::vector<double>{4e0, 5e0, 6e0});
+    BOOST_CHECK_EQUAL(dot_prod(small, mixed), 32e0);
+    BOOST_CHECK_EQUAL(dot_prod(mixed, small), 32e0);
+    BOOST_CHECK_THROW(dot_prod(vec1, mixed), std::invalid_argument);
+    BOOST_CHECK_EQUAL(len_square(VectorDd()), 0e0);
+}
@@ -0,0 +1,395 @@
+#define BOOST_TEST_MODULE "test_matrix_product"
+
+#ifdef UNITTEST_FRAMEWORK_LIBRARY_EXIST
+#include <boost/test/unit_test.hpp>
+#else
+#define BOOST_TEST_NO_LIB
+#include <boost/test/included/unit_test.hpp>
+#endif
+
+#include "../src/DynamicMatrix.hpp"
+#include "../src/ThreadPool.hpp"
+#include "../src/DynamicVector.hpp"
+using MatrixNMd = ax::Matrix<double, ax::DYNAMIC, ax::DYNAMIC>;
+
+#include "test_Defs.hpp"
+using ax::test::tolerance;
+using ax::test::seed;
+
+#include <random>
+
+namespace
+{
+MatrixNMd random_matrix(const std::size_t row, const std::size_t col,
+                        std::mt19937& mt)
+{
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+    MatrixNMd mat(row, col);
+    for(std::size_t i=0; i<row; ++i)
+        for(std::size_t j=0; j<col; ++j)
+            mat(i, j) = randreal(mt);
+    return mat;
+}
+
+// reference product evaluated one element at a time
+template<class T_lhs, class T_rhs>
+MatrixNMd naive_product(const T_lhs& lhs, const T_rhs& rhs)
+{
+    MatrixNMd retval(ax::dimension_row(lhs), ax::dimension_col(rhs));
+    for(std::size_t i=0; i<ax::dimension_row(lhs); ++i)
+        for(std::size_t j=0; j<ax::dimension_col(rhs); ++j)
+        {
+            double sum = 0e0;
+            for(std::size_t k=0; k<ax::dimension_col(lhs); ++k)
+                sum += lhs(i, k) * rhs(k, j);
+            retval(i, j) = sum;
+        }
+    return retval;
+}
+}
+
+BOOST_AUTO_TEST_CASE(MatrixProduct_GEMM)
+{
+    std::mt19937 mt(seed);
+    // sizes are chosen not to be multiples of any blocking parameter
+    const MatrixNMd lhs = random_matrix(131, 263, mt);
+    const MatrixNMd rhs = random_matrix(263, 77, mt);
+
+    const MatrixNMd prod = lhs * rhs;
+    const MatrixNMd ref  = naive_product(lhs, rhs);
+
+    BOOST_CHECK_EQUAL(prod.size_row(), 131u);
+    BOOST_CHECK_EQUAL(prod.size_col(),  77u);
+    for(std::size_t i=0; i<131; ++i)
+        for(std::size_t j=0; j<77; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(prod(i, j), ref(i, j), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(MatrixProduct_GEMM_transpose)
+{
+    std::mt19937 mt(seed);
+    const MatrixNMd lhs = random_matrix(90, 70, mt);
+    const MatrixNMd rhs = random_matrix(50, 90, mt);
+
+    MatrixNMd prod;
+    prod = transpose(lhs) * transpose(rhs);
+    const MatrixNMd ref = naive_product(transpose(lhs), transpose(rhs));
+
+    BOOST_CHECK_EQUAL(prod.size_row(), 70u);
+    BOOST_CHECK_EQUAL(prod.size_col(), 50u);
+    for(std::size_t i=0; i<70; ++i)
+        for(std::size_t j=0; j<50; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(prod(i, j), ref(i, j), 1e-10);
+
+    const MatrixNMd gram = transpose(lhs) * lhs;
+    for(std::size_t i=0; i<70; ++i)
+        for(std::size_t j=0; j<70; ++j)
+            BOOST_CHECK_EQUAL(gram(i, j), gram(j, i));
+}
+
+BOOST_AUTO_TEST_CASE(MatrixProduct_GEMM_static)
+{
+    constexpr std::size_t N = 40;
+    std::mt19937 mt(seed);
+    const MatrixNMd lhs = random_matrix(N, N, mt);
+    const MatrixNMd rhs = random_matrix(N, N, mt);
+
+    const ax::Matrix<double, N, N> slhs(lhs);
+    const ax::Matrix<double, N, N> srhs(rhs);
+    const ax::Matrix<double, N, N> prod = slhs * srhs;
+    const MatrixNMd ref = naive_product(lhs, rhs);
+
+    for(std::size_t i=0; i<N; ++i)
+        for(std::size_t j=0; j<N; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(prod(i, j), ref(i, j), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(GEMM_alpha_beta)
+{
+    std::mt19937 mt(seed);
+    const MatrixNMd lhs = random_matrix(45, 33, mt);
+    const MatrixNMd rhs = random_matrix(33, 29, mt);
+    const MatrixNMd c0  = random_matrix(45, 29, mt);
+
+    MatrixNMd c = c0;
+    ax::detail::gemm<double>(45, 29, 33, -2e0, lhs.data(), lhs.stride(), 1,
+                             rhs.data(), rhs.stride(), 1, 0.5, c.data(), c.stride());
+
+    const MatrixNMd ref = naive_product(lhs, rhs);
+    for(std::size_t i=0; i<45; ++i)
+        for(std::size_t j=0; j<29; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(c(i, j), 0.5 * c0(i, j) - 2e0 * ref(i, j), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(MatrixProduct_GEMM_parallel)
+{
+    std::mt19937 mt(seed);
+    const MatrixNMd lhs = random_matrix(301, 157, mt);
+    const MatrixNMd rhs = random_matrix(157, 419, mt);
+
+    const std::size_t num_threads = ax::get_num_threads();
+    const std::size_t threshold   = ax::get_parallel_threshold();
+
+    ax::set_num_threads(1);
+    const MatrixNMd serial = lhs * rhs;
+
+    ax::set_parallel_threshold(0);
+    for(std::size_t n=2; n<=5; ++n)
+    {
+        ax::set_num_threads(n);
+        const MatrixNMd parallel = lhs * rhs;
+        for(std::size_t i=0; i<301; ++i)
+            for(std::size_t j=0; j<419; ++j)
+                BOOST_CHECK_EQUAL(parallel(i, j), serial(i, j));
+    }
+
+    ax::set_num_threads(num_threads);
+    ax::set_parallel_threshold(threshold);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadPool_parallel_for)
+{
+    ax::ThreadPool pool(4);
+    BOOST_CHECK_EQUAL(pool.size(), 4u);
+
+    std::vector<std::size_t> out(1000, 0);
+    pool.parallel_for(out.size(), [&](const std::size_t i){out[i] = i * i;});
+    for(std::size_t i=0; i<out.size(); ++i)
+        BOOST_CHECK_EQUAL(out[i], i * i);
+
+    BOOST_CHECK_THROW(pool.parallel_for(10, [](const std::size_t i){
+            if(i == 7) throw std::runtime_error("error");}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(MatrixProduct_chained)
+{
+    std::mt19937 mt(seed);
+    const MatrixNMd A = random_matrix(41, 53, mt);
+    const MatrixNMd B = random_matrix(53, 37, mt);
+    const MatrixNMd C = random_matrix(37, 47, mt);
+
+    const MatrixNMd AB  = A * B;
+    const MatrixNMd ref = AB * C;
+
+    // the inner product is held by value, so the node outlives A * B
+    const auto expr = A * B * C;
+    const MatrixNMd ABC = expr;
+    for(std::size_t i=0; i<41; ++i)
+        for(std::size_t j=0; j<47; ++j)
+            BOOST_CHECK_EQUAL(ABC(i, j), ref(i, j));
+
+    const MatrixNMd ref2 = naive_product(A, naive_product(B, C));
+    const MatrixNMd ABC2 = A * (B * C);
+    for(std::size_t i=0; i<41; ++i)
+        for(std::size_t j=0; j<47; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(ABC2(i, j), ref2(i, j), 1e-10);
+
+    const MatrixNMd ref3 = naive_product(A * 2e0, B);
+    const MatrixNMd sAB  = (A * 2e0) * B;
+    for(std::size_t i=0; i<41; ++i)
+        for(std::size_t j=0; j<37; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(sAB(i, j), ref3(i, j), 1e-10);
+
+    const MatrixNMd ref4 = transpose(AB);
+    const MatrixNMd tAB  = transpose(A * B);
+    for(std::size_t i=0; i<37; ++i)
+        for(std::size_t j=0; j<41; ++j)
+            BOOST_CHECK_EQUAL(tAB(i, j), ref4(i, j));
+}
+
+BOOST_AUTO_TEST_CASE(MatrixProduct_chained_static)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, 4, 4> A, B, C;
+    ax::Vector<double, 4> v;
+    for(std::size_t i=0; i<4; ++i)
+    {
+        v[i] = randreal(mt);
+        for(std::size_t j=0; j<4; ++j)
+        {
+            A(i, j) = randreal(mt);
+            B(i, j) = randreal(mt);
+            C(i, j) = randreal(mt);
+        }
+    }
+
+    const ax::Matrix<double, 4, 4> AB  = A * B;
+    const ax::Matrix<double, 4, 4> ref = AB * C;
+    const ax::Matrix<double, 4, 4> ABC = A * B * C;
+    for(std::size_t i=0; i<4; ++i)
+        for(std::size_t j=0; j<4; ++j)
+            BOOST_CHECK_EQUAL(ABC(i, j), ref(i, j));
+
+    const ax::Vector<double, 4> Bv   = B * v;
+    const ax::Vector<double, 4> refv = A * Bv;
+    const ax::Vector<double, 4> ABv  = A * (B * v);
+    const ax::Vector<double, 4> ABv2 = A * B * v;
+    for(std::size_t i=0; i<4; ++i)
+    {
+        BOOST_CHECK_EQUAL(ABv[i], refv[i]);
+        BOOST_CHECK_CLOSE_FRACTION(ABv2[i], refv[i], 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MatrixProduct_accumulate)
+{
+    std::mt19937 mt(seed);
+    const MatrixNMd lhs = random_matrix(70, 90, mt);
+    const MatrixNMd rhs = random_matrix(90, 60, mt);
+    const MatrixNMd c0  = random_matrix(70, 60, mt);
+    const MatrixNMd ref = naive_product(lhs, rhs);
+
+    MatrixNMd c = c0;
+    const double* const ptr = c.data();
+    c += lhs * rhs;
+    BOOST_CHECK_EQUAL(c.data(), ptr);
+    for(std::size_t i=0; i<70; ++i)
+        for(std::size_t j=0; j<60; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(c(i, j), c0(i, j) + ref(i, j), 1e-10);
+
+    c = c0;
+    c -= lhs * rhs;
+    for(std::size_t i=0; i<70; ++i)
+        for(std::size_t j=0; j<60; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(c(i, j), c0(i, j) - ref(i, j), 1e-10);
+
+    // destination is also an operand of the product
+    const MatrixNMd sq0 = random_matrix(50, 50, mt);
+    const MatrixNMd sq_ref = naive_product(sq0, sq0);
+    MatrixNMd sq = sq0;
+    sq += sq * sq;
+    for(std::size_t i=0; i<50; ++i)
+        for(std::size_t j=0; j<50; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(sq(i, j), sq0(i, j) + sq_ref(i, j), 1e-10);
+
+    MatrixNMd wrong(69, 60);
+    BOOST_CHECK_THROW(wrong += lhs * rhs, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(MatrixProduct_accumulate_static)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, 4, 4> A, A0;
+    ax::Vector<double, 4> v, v0;
+    for(std::size_t i=0; i<4; ++i)
+    {
+        v0[i] = randreal(mt);
+        for(std::size_t j=0; j<4; ++j)
+            A0(i, j) = randreal(mt);
+    }
+
+    const ax::Matrix<double, 4, 4> AA = A0 * A0;
+    const ax::Vector<double, 4>    Av = A0 * v0;
+
+    A = A0;
+    A *= A;
+    v = v0;
+    v += A0 * v;
+    for(std::size_t i=0; i<4; ++i)
+    {
+        BOOST_CHECK_EQUAL(v[i], v0[i] + Av[i]);
+        for(std::size_t j=0; j<4; ++j)
+            BOOST_CHECK_EQUAL(A(i, j), AA(i, j));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Assignment_aliasing)
+{
+    std::mt19937 mt(seed);
+    const MatrixNMd A0 = random_matrix(60, 50, mt);
+    const MatrixNMd B  = random_matrix(50, 40, mt);
+    const MatrixNMd S0 = random_matrix(7, 7, mt);
+
+    BOOST_CHECK(!ax::detail::alias_hazard(A0 + A0 * 2e0, &A0));
+    BOOST_CHECK( ax::detail::alias_hazard(A0 * B, &A0));
+    BOOST_CHECK( ax::detail::alias_hazard(A0 + transpose(A0), &A0));
+    BOOST_CHECK(!ax::detail::alias_hazard(A0 * B, &S0));
+
+    // product that also changes the shape of its destination
+    const MatrixNMd AB = naive_product(A0, B);
+    MatrixNMd A = A0;
+    A = A * B;
+    BOOST_CHECK_EQUAL(A.size_row(), 60u);
+    BOOST_CHECK_EQUAL(A.size_col(), 40u);
+    for(std::size_t i=0; i<60; ++i)
+        for(std::size_t j=0; j<40; ++j)
+            BOOST_CHECK_CLOSE_FRACTION(A(i, j), AB(i, j), 1e-10);
+
+    MatrixNMd S = S0;
+    S = S + transpose(S);
+    for(std::size_t i=0; i<7; ++i)
+        for(std::size_t j=0; j<7; ++j)
+            BOOST_CHECK_EQUAL(S(i, j), S0(i, j) + S0(j, i));
+
+    S = S0;
+    S = transpose(S);
+    for(std::size_t i=0; i<7; ++i)
+        for(std::size_t j=0; j<7; ++j)
+            BOOST_CHECK_EQUAL(S(i, j), S0(j, i));
+
+    S = S0;
+    S -= transpose(S);
+    for(std::size_t i=0; i<7; ++i)
+        for(std::size_t j=0; j<7; ++j)
+            BOOST_CHECK_EQUAL(S(i, j), S0(i, j) - S0(j, i));
+
+    // the destination is not an operand: evaluated directly
+    MatrixNMd C(60, 40);
+    const double* const ptr = C.data();
+    ax::noalias(C) = A0 * B;
+    BOOST_CHECK_EQUAL(C.data(), ptr);
+    ax::noalias(C) -= A0 * B;
+    for(std::size_t i=0; i<60; ++i)
+        for(std::size_t j=0; j<40; ++j)
+            BOOST_CHECK_SMALL(C(i, j), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(Assignment_aliasing_vector)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(-1e0, 1e0);
+
+    ax::Matrix<double, 3, 3> M;
+    ax::Vector<double, 3> v0;
+    for(std::size_t i=0; i<3; ++i)
+    {
+        v0[i] = randreal(mt);
+        for(std::size_t j=0; j<3; ++j)
+            M(i, j) = randreal(mt);
+    }
+
+    const ax::Vector<double, 3> Mv = M * v0;
+    ax::Vector<double, 3> v = v0;
+    v = M * v;
+    for(std::size_t i=0; i<3; ++i)
+        BOOST_CHECK_EQUAL(v[i], Mv[i]);
+
+    const ax::Vector<double, 3> w(randreal(mt), randreal(mt), randreal(mt));
+    const ax::Vector<double, 3> vw = cross_prod(Mv, w);
+    v = cross_prod(v, w);
+    for(std::size_t i=0; i<3; ++i)
+        BOOST_CHECK_EQUAL(v[i], vw[i]);
+
+    v = v0;
+    ax::Vector<double, 3> u;
+    ax::noalias(u) = M * v;
+    ax::noalias(u) += M * v;
+    for(std::size_t i=0; i<3; ++i)
+        BOOST_CHECK_EQUAL(u[i], Mv[i] + Mv[i]);
+
+    const MatrixNMd D0 = random_matrix(40, 40, mt);
+    ax::Vector<double, ax::DYNAMIC> x(40), x0;
+    for(std::size_t i=0; i<40; ++i) x[i] = randreal(mt);
+    x0 = x;
+    x = D0 * x;
+    for(std::size_t i=0; i<40; ++i)
+    {
+        double ref = 0e0;
+        for(std::size_t j=0; j<40; ++j) ref += D0(i, j) * x0[j];
+        BOOST_CHECK_CLOSE_FRACTION(x[i], ref, 1e-10);
+    }
+}
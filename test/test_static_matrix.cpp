@@ -36,6 +36,15 @@ BOOST_AUTO_TEST_CASE(MatrixNd_Ctor)
             else
                 BOOST_CHECK_EQUAL(mat1(i,j), 0e0);
 
+    const MatrixNMd<6, 3> tall(1e0);
+
+    for(std::size_t i=0; i<6; ++i)
+        for(std::size_t j=0; j<3; ++j)
+            if(i == j)
+                BOOST_CHECK_EQUAL(tall(i,j), 1e0);
+            else
+                BOOST_CHECK_EQUAL(tall(i,j), 0e0);
+
 
     const MatrixNMd<Dim_N, Dim_M> mat2(mat1);
 
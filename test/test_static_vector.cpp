@@ -190,3 +190,27 @@ BOOST_AUTO_TEST_CASE(VectorNd_length)
         BOOST_CHECK_CLOSE_FRACTION(len_square(vec1), dot_prod(vec1, vec1), tolerance);
     }
 }
+
+BOOST_AUTO_TEST_CASE(VectorNd_large_static_reduction)
+{
+    std::mt19937 mt(seed);
+    std::uniform_real_distribution<double> randreal(0e0, 1e0);
+
+    // larger than AX_CONSTEXPR_REDUCTION_LIMIT: iterative kernel
+    constexpr std::size_t N = 103;
+    std::array<double, N> v1, v2;
+    double dot_product = 0e0, lensq = 0e0;
+    for(std::size_t i=0; i<N; ++i)
+    {
+        v1[i] = randreal(mt);
+        v2[i] = randreal(mt);
+        dot_product += v1[i] * v2[i];
+        lensq       += v1[i] * v1[i];
+    }
+    const VectorNd<N> vec1(v1);
+    const VectorNd<N> vec2(v2);
+
+    BOOST_CHECK_CLOSE_FRACTION(dot_prod(vec1, vec2), dot_product, tolerance);
+    BOOST_CHECK_CLOSE_FRACTION(len_square(vec1), lensq, tolerance);
+    BOOST_CHECK_CLOSE_FRACTION(dot_prod(vec1 * 2e0, vec2), 2e0 * dot_product, tolerance);
+}